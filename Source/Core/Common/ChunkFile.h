@@ -61,9 +61,12 @@ public:
 
 	u8 **ptr;
 	Mode mode;
+	// Optional end of the buffer in MODE_WRITE. Writing past it switches to
+	// MODE_MEASURE, so that *ptr ends up at where the end would have to be.
+	u8 *end;
 
 public:
-	PointerWrap(u8 **ptr_, Mode mode_) : ptr(ptr_), mode(mode_) {}
+	PointerWrap(u8 **ptr_, Mode mode_, u8 *end_ = nullptr) : ptr(ptr_), mode(mode_), end(end_) {}
 
 	void SetMode(Mode mode_) { mode = mode_; }
 	Mode GetMode() const { return mode; }
@@ -306,6 +309,9 @@ private:
 
 	void DoVoid(void *data, u32 size)
 	{
+		if (mode == MODE_WRITE && end && size > (size_t)(end - *ptr))
+			mode = MODE_MEASURE;
+
 		for(u32 i = 0; i != size; ++i)
 			DoByte(reinterpret_cast<u8*>(data)[i]);
 	}
@@ -0,0 +1,88 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include "Common/Common.h"
+#include "Common/CPUDetect.h"
+#include "Common/Crypto/AES.h"
+
+#if (defined(_M_X64) || defined(_M_IX86)) && !defined(_M_GENERIC)
+#define HAVE_AESNI 1
+#include <wmmintrin.h>
+#endif
+
+namespace AES
+{
+
+#ifdef HAVE_AESNI
+// The key schedule polarssl builds for decryption is already laid out the way
+// AESDEC wants it (equivalent inverse cipher, last round key first), so it can
+// be used as is.
+static void DecryptCBC_AESNI(aes_context* ctx, u8* iv, const u8* src, u8* dst, size_t size)
+{
+	const int nr = ctx->nr;
+	__m128i rk[15];
+	for (int i = 0; i <= nr; i++)
+		rk[i] = _mm_loadu_si128((const __m128i*)(ctx->rk + i * 4));
+
+	__m128i prev = _mm_loadu_si128((const __m128i*)iv);
+	size_t i = 0;
+
+	// CBC decryption has no dependency between blocks, keep four in flight to
+	// hide the latency of AESDEC.
+	for (; i + 64 <= size; i += 64)
+	{
+		__m128i c0 = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i c1 = _mm_loadu_si128((const __m128i*)(src + i + 16));
+		__m128i c2 = _mm_loadu_si128((const __m128i*)(src + i + 32));
+		__m128i c3 = _mm_loadu_si128((const __m128i*)(src + i + 48));
+		__m128i b0 = _mm_xor_si128(c0, rk[0]);
+		__m128i b1 = _mm_xor_si128(c1, rk[0]);
+		__m128i b2 = _mm_xor_si128(c2, rk[0]);
+		__m128i b3 = _mm_xor_si128(c3, rk[0]);
+		for (int r = 1; r < nr; r++)
+		{
+			b0 = _mm_aesdec_si128(b0, rk[r]);
+			b1 = _mm_aesdec_si128(b1, rk[r]);
+			b2 = _mm_aesdec_si128(b2, rk[r]);
+			b3 = _mm_aesdec_si128(b3, rk[r]);
+		}
+		b0 = _mm_xor_si128(_mm_aesdeclast_si128(b0, rk[nr]), prev);
+		b1 = _mm_xor_si128(_mm_aesdeclast_si128(b1, rk[nr]), c0);
+		b2 = _mm_xor_si128(_mm_aesdeclast_si128(b2, rk[nr]), c1);
+		b3 = _mm_xor_si128(_mm_aesdeclast_si128(b3, rk[nr]), c2);
+		_mm_storeu_si128((__m128i*)(dst + i), b0);
+		_mm_storeu_si128((__m128i*)(dst + i + 16), b1);
+		_mm_storeu_si128((__m128i*)(dst + i + 32), b2);
+		_mm_storeu_si128((__m128i*)(dst + i + 48), b3);
+		prev = c3;
+	}
+
+	for (; i < size; i += 16)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i b = _mm_xor_si128(c, rk[0]);
+		for (int r = 1; r < nr; r++)
+			b = _mm_aesdec_si128(b, rk[r]);
+		b = _mm_xor_si128(_mm_aesdeclast_si128(b, rk[nr]), prev);
+		_mm_storeu_si128((__m128i*)(dst + i), b);
+		prev = c;
+	}
+
+	_mm_storeu_si128((__m128i*)iv, prev);
+}
+#endif
+
+void DecryptCBC(aes_context* ctx, u8* iv, const u8* src, u8* dst, size_t size)
+{
+#ifdef HAVE_AESNI
+	if (cpu_info.bAES)
+	{
+		DecryptCBC_AESNI(ctx, iv, src, dst, size);
+		return;
+	}
+#endif
+	aes_crypt_cbc(ctx, AES_DECRYPT, size, iv, src, dst);
+}
+
+}
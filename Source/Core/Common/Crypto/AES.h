@@ -0,0 +1,20 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <polarssl/aes.h>
+
+#include "Common/CommonTypes.h"
+
+namespace AES
+{
+
+// Decrypts size bytes (a multiple of 16) in CBC mode, like aes_crypt_cbc with
+// AES_DECRYPT, and updates iv the same way. ctx must have been set up with
+// aes_setkey_dec. Uses AES-NI when the host supports it.
+void DecryptCBC(aes_context* ctx, u8* iv, const u8* src, u8* dst, size_t size);
+
+}
@@ -411,6 +411,21 @@ u64 GetSize(const std::string &filename)
 	return 0;
 }
 
+u64 GetModificationTime(const std::string &filename)
+{
+	struct stat64 buf;
+#ifdef _WIN32
+	if (_tstat64(UTF8ToTStr(filename).c_str(), &buf) == 0)
+#else
+	if (stat64(filename.c_str(), &buf) == 0)
+#endif
+		return (u64)buf.st_mtime;
+
+	ERROR_LOG(COMMON, "GetModificationTime: Stat failed %s: %s",
+			filename.c_str(), GetLastErrorMsg());
+	return 0;
+}
+
 // Overloaded GetSize, accepts file descriptor
 u64 GetSize(const int fd)
 {
@@ -1064,6 +1079,20 @@ bool IOFile::Flush()
 	return m_good;
 }
 
+bool IOFile::Sync()
+{
+	if (!Flush() || 0 !=
+#ifdef _WIN32
+		_commit(_fileno(m_file))
+#else
+		fsync(fileno(m_file))
+#endif
+	)
+		m_good = false;
+
+	return m_good;
+}
+
 bool IOFile::Resize(u64 size)
 {
 	if (!IsOpen() || 0 !=
@@ -81,6 +81,9 @@ u64 GetSize(const int fd);
 // Overloaded GetSize, accepts FILE*
 u64 GetSize(FILE *f);
 
+// Returns the last modification time of filename in seconds since the epoch, or 0 on failure
+u64 GetModificationTime(const std::string &filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string &filename);
 
@@ -215,6 +218,8 @@ public:
 	u64 GetSize();
 	bool Resize(u64 size);
 	bool Flush();
+	// Flush, then wait until the OS has the data on the disk.
+	bool Sync();
 
 	// clear error state
 	void Clear() { m_good = true; std::clearerr(m_file); }
@@ -0,0 +1,496 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/FileUtil.h"
+#include "Common/MappedFile.h"
+
+// On disk format:
+//header{
+// u32 'DCIX';
+// u16 sizeof(key_type);
+// u16 sizeof(value_type);
+// char ver[40]; // git revision
+//}
+//
+//record{          // any number of times
+// u32 value_size;
+// key_type key;
+// value_type[value_size] value;
+//}
+//
+//index_entry{     // num_entries times, sorted by the key's bytes
+// key_type key;
+// u64 value_offset;
+// u32 value_size;
+//}
+//
+//footer{
+// u64 index_offset;
+// u32 num_entries;
+// u32 'DCIE';
+//}
+
+// Key-value store with random access, as a replacement for LinearDiskCache
+// where the values are only needed on demand.
+//
+// Opening maps the file, checks the header and footer and that every index
+// entry points inside the records. Lookups binary search the index in place,
+// so the memory footprint doesn't grow with the number of entries. Index
+// entries pointing elsewhere, as in truncated files, are dropped.
+//
+// New entries are kept in memory until Sync, which writes them over the old
+// index and then writes a new index behind them. Records which are no
+// longer indexed (replaced or erased keys) are dropped by rewriting the file
+// once they make up more than half of it.
+//
+// Until then, new entries also go to a journal next to the file, in the
+// record format above. Open replays journals left behind by sessions which
+// didn't get to Sync. Erasing isn't journaled, it only drops entries whose
+// values the caller checks anyway.
+//
+// K and V are some POD type
+// K : the key type
+// V : value array type
+template <typename K, typename V>
+class IndexedDiskCache : NonCopyable
+{
+public:
+	IndexedDiskCache() : m_index(nullptr), m_num_entries(0), m_index_offset(0) {}
+	~IndexedDiskCache() { Close(); }
+
+	// Returns the number of entries. Missing or invalid files are replaced
+	// by an empty cache.
+	u32 Open(const std::string& filename)
+	{
+		Close();
+		m_filename = filename;
+
+		if (!MapFile())
+		{
+			File::IOFile file(m_filename, "wb");
+			Header header;
+			Footer footer;
+			footer.index_offset = sizeof(Header);
+			footer.num_entries = 0;
+			if (!file.WriteArray(&header, 1) || !file.WriteArray(&footer, 1))
+			{
+				ERROR_LOG(COMMON, "Failed to create disk cache %s", m_filename.c_str());
+				m_filename.clear();
+				return 0;
+			}
+			file.Close();
+
+			if (!MapFile())
+			{
+				m_filename.clear();
+				return 0;
+			}
+		}
+
+		if (ReplayJournal())
+			Sync();
+		else
+			DropJournal();
+
+		return m_num_entries;
+	}
+
+	bool IsOpen() const { return !m_filename.empty(); }
+
+	u32 GetNumEntries() const { return m_num_entries + (u32)m_new_entries.size(); }
+
+	// On success, value points to value_size elements which stay valid until
+	// the next call to Append, Sync or Close.
+	bool Lookup(const K& key, const V*& value, u32& value_size) const
+	{
+		const std::string key_bytes = KeyBytes(key);
+		if (m_erased.count(key_bytes))
+			return false;
+
+		auto it = m_new_entries.find(key_bytes);
+		if (it != m_new_entries.end())
+		{
+			value = it->second.data();
+			value_size = (u32)it->second.size();
+			return true;
+		}
+
+		const u8* entry = FindIndexEntry(key_bytes);
+		if (!entry)
+			return false;
+
+		u64 offset;
+		memcpy(&offset, entry + sizeof(K), sizeof(offset));
+		memcpy(&value_size, entry + sizeof(K) + sizeof(offset), sizeof(value_size));
+		value = (const V*)(m_file.GetData() + offset);
+		return true;
+	}
+
+	// Adds an entry, replacing any previous value stored for key.
+	void Append(const K& key, const V* value, u32 value_size)
+	{
+		const std::string key_bytes = KeyBytes(key);
+		m_erased.erase(key_bytes);
+		m_new_entries[key_bytes].assign(value, value + value_size);
+
+		if (!IsOpen())
+			return;
+		if (!m_journal.IsOpen())
+			m_journal.Open(JournalFilename(), "ab");
+		Location location;
+		if (!m_journal || !WriteRecord(m_journal, key_bytes, value, value_size, &location) || !m_journal.Flush())
+			ERROR_LOG(COMMON, "Failed to write the journal of disk cache %s", m_filename.c_str());
+	}
+
+	// Drops an entry, e.g. because its value turned out to be unusable.
+	void Erase(const K& key)
+	{
+		const std::string key_bytes = KeyBytes(key);
+		m_new_entries.erase(key_bytes);
+		if (FindIndexEntry(key_bytes))
+			m_erased.insert(key_bytes);
+	}
+
+	// Writes new entries and the updated index to disk.
+	void Sync()
+	{
+		if (!IsOpen() || (m_new_entries.empty() && m_erased.empty()))
+			return;
+
+		// Collect the entries which stay in the index, in key order.
+		std::vector<Location> kept;
+		u64 live_bytes = 0;
+		for (u32 i = 0; i < m_num_entries; ++i)
+		{
+			const u8* entry = m_index + i * INDEX_ENTRY_SIZE;
+			std::string key_bytes((const char*)entry, sizeof(K));
+			if (m_erased.count(key_bytes) || m_new_entries.count(key_bytes))
+				continue;
+
+			Location location;
+			location.key_bytes = key_bytes;
+			memcpy(&location.offset, entry + sizeof(K), sizeof(location.offset));
+			memcpy(&location.value_size, entry + sizeof(K) + sizeof(location.offset), sizeof(location.value_size));
+			live_bytes += RecordSize(location.value_size);
+			kept.push_back(location);
+		}
+
+		// Entries of a corrupt file may overlap.
+		u64 records_bytes = m_index_offset - sizeof(Header);
+		u64 dead_bytes = records_bytes > live_bytes ? records_bytes - live_bytes : 0;
+		bool compact = dead_bytes > live_bytes && dead_bytes > MIN_COMPACT_BYTES;
+
+		if (compact ? !Rewrite(kept) : !AppendAndReindex(kept))
+		{
+			ERROR_LOG(COMMON, "Failed to write disk cache %s", m_filename.c_str());
+		}
+		else
+		{
+			DropJournal();
+		}
+
+		m_new_entries.clear();
+		m_erased.clear();
+
+		if (!MapFile())
+		{
+			ERROR_LOG(COMMON, "Disk cache %s is unreadable after writing it", m_filename.c_str());
+			m_filename.clear();
+		}
+	}
+
+	void Close()
+	{
+		Sync();
+		UnmapFile();
+		m_journal.Close();
+		m_filename.clear();
+	}
+
+private:
+	enum
+	{
+		INDEX_ENTRY_SIZE = sizeof(K) + sizeof(u64) + sizeof(u32),
+		MIN_COMPACT_BYTES = 1024 * 1024,
+	};
+
+	struct Header
+	{
+		Header()
+			: id(*(u32*)"DCIX")
+			, key_t_size(sizeof(K))
+			, value_t_size(sizeof(V))
+		{
+			memcpy(ver, scm_rev_git_str, 40);
+		}
+
+		u32 id;
+		u16 key_t_size, value_t_size;
+		char ver[40];
+	};
+
+	struct Footer
+	{
+		Footer() : id(*(u32*)"DCIE") {}
+
+		u64 index_offset;
+		u32 num_entries;
+		u32 id;
+	};
+
+	struct Location
+	{
+		std::string key_bytes;
+		u64 offset; // of the value
+		u32 value_size;
+
+		bool operator<(const Location& other) const { return key_bytes < other.key_bytes; }
+	};
+
+	static std::string KeyBytes(const K& key)
+	{
+		return std::string((const char*)&key, sizeof(K));
+	}
+
+	static u64 RecordSize(u32 value_size)
+	{
+		return sizeof(u32) + sizeof(K) + (u64)value_size * sizeof(V);
+	}
+
+	std::string JournalFilename() const
+	{
+		return m_filename + ".journal";
+	}
+
+	// Reads the complete records of a journal into the new entries. Returns
+	// whether there were any.
+	bool ReplayJournal()
+	{
+		File::IOFile journal(JournalFilename(), "rb");
+		if (!journal)
+			return false;
+
+		const u64 size = journal.GetSize();
+		u32 value_size;
+		K key;
+		std::vector<V> value;
+		while (journal.ReadArray(&value_size, 1) && journal.ReadArray(&key, 1) &&
+			(u64)value_size * sizeof(V) <= size - journal.Tell())
+		{
+			value.resize(value_size);
+			if (value_size && !journal.ReadArray(value.data(), value_size))
+				break;
+			m_new_entries[KeyBytes(key)].swap(value);
+		}
+
+		if (!m_new_entries.empty())
+			WARN_LOG(COMMON, "Recovered %u entries of disk cache %s from its journal", (u32)m_new_entries.size(), m_filename.c_str());
+		return !m_new_entries.empty();
+	}
+
+	void DropJournal()
+	{
+		m_journal.Close();
+		if (File::Exists(JournalFilename()))
+			File::Delete(JournalFilename());
+	}
+
+	bool MapFile()
+	{
+		UnmapFile();
+
+		if (!m_file.Open(m_filename) || m_file.GetSize() < sizeof(Header) + sizeof(Footer))
+			return false;
+
+		const u8* data = m_file.GetData();
+		const u64 size = m_file.GetSize();
+
+		Header header;
+		Footer footer, expected_footer;
+		memcpy(&footer, data + size - sizeof(Footer), sizeof(Footer));
+		if (memcmp(&header, data, sizeof(Header)) ||
+			footer.id != expected_footer.id ||
+			footer.index_offset < sizeof(Header) ||
+			footer.index_offset > size - sizeof(Footer) ||
+			footer.index_offset + (u64)footer.num_entries * INDEX_ENTRY_SIZE != size - sizeof(Footer))
+		{
+			UnmapFile();
+			return false;
+		}
+
+		m_index = data + footer.index_offset;
+		m_num_entries = footer.num_entries;
+		m_index_offset = footer.index_offset;
+
+		// Keep only the entries whose value lies between the header and the
+		// index, in a copy of the index if any have to go.
+		for (u32 i = 0; i < m_num_entries; ++i)
+		{
+			if (IsValidEntry(m_index + i * INDEX_ENTRY_SIZE))
+				continue;
+
+			ERROR_LOG(COMMON, "Disk cache %s has invalid entries, dropping them", m_filename.c_str());
+			m_valid_index.assign(m_index, m_index + i * INDEX_ENTRY_SIZE);
+			for (++i; i < m_num_entries; ++i)
+			{
+				const u8* entry = m_index + i * INDEX_ENTRY_SIZE;
+				if (IsValidEntry(entry))
+					m_valid_index.insert(m_valid_index.end(), entry, entry + INDEX_ENTRY_SIZE);
+			}
+			m_index = m_valid_index.data();
+			m_num_entries = (u32)(m_valid_index.size() / INDEX_ENTRY_SIZE);
+			break;
+		}
+		return true;
+	}
+
+	bool IsValidEntry(const u8* entry) const
+	{
+		u64 offset;
+		u32 value_size;
+		memcpy(&offset, entry + sizeof(K), sizeof(offset));
+		memcpy(&value_size, entry + sizeof(K) + sizeof(offset), sizeof(value_size));
+		return offset >= sizeof(Header) + sizeof(u32) + sizeof(K) &&
+			offset <= m_index_offset &&
+			(u64)value_size * sizeof(V) <= m_index_offset - offset;
+	}
+
+	void UnmapFile()
+	{
+		m_file.Close();
+		m_valid_index.clear();
+		m_index = nullptr;
+		m_num_entries = 0;
+		m_index_offset = 0;
+	}
+
+	const u8* FindIndexEntry(const std::string& key_bytes) const
+	{
+		u32 lo = 0, hi = m_num_entries;
+		while (lo < hi)
+		{
+			u32 mid = lo + (hi - lo) / 2;
+			const u8* entry = m_index + mid * INDEX_ENTRY_SIZE;
+			int cmp = memcmp(entry, key_bytes.data(), sizeof(K));
+			if (cmp == 0)
+				return entry;
+			if (cmp < 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return nullptr;
+	}
+
+	bool WriteRecord(File::IOFile& file, const std::string& key_bytes, const V* value, u32 value_size, Location* location)
+	{
+		location->key_bytes = key_bytes;
+		location->offset = file.Tell() + sizeof(u32) + sizeof(K);
+		location->value_size = value_size;
+		return file.WriteArray(&value_size, 1) &&
+			file.WriteBytes(key_bytes.data(), sizeof(K)) &&
+			(!value_size || file.WriteArray(value, value_size));
+	}
+
+	bool WriteIndex(File::IOFile& file, std::vector<Location>& locations)
+	{
+		std::sort(locations.begin(), locations.end());
+
+		Footer footer;
+		footer.index_offset = file.Tell();
+		footer.num_entries = (u32)locations.size();
+
+		std::vector<u8> index(locations.size() * INDEX_ENTRY_SIZE);
+		u8* entry = index.data();
+		for (const Location& location : locations)
+		{
+			memcpy(entry, location.key_bytes.data(), sizeof(K));
+			memcpy(entry + sizeof(K), &location.offset, sizeof(location.offset));
+			memcpy(entry + sizeof(K) + sizeof(location.offset), &location.value_size, sizeof(location.value_size));
+			entry += INDEX_ENTRY_SIZE;
+		}
+
+		return (index.empty() || file.WriteBytes(index.data(), index.size())) &&
+			file.WriteArray(&footer, 1) &&
+			file.Resize(file.Tell());
+	}
+
+	// Writes the new records over the old index, followed by the new index.
+	// The mapping has to go first, as the file shrinks or grows under it.
+	bool AppendAndReindex(std::vector<Location>& kept)
+	{
+		u64 index_offset = m_index_offset;
+		UnmapFile();
+
+		File::IOFile file(m_filename, "r+b");
+		if (!file.Seek(index_offset, SEEK_SET))
+			return false;
+
+		for (auto& entry : m_new_entries)
+		{
+			Location location;
+			if (!WriteRecord(file, entry.first, entry.second.data(), (u32)entry.second.size(), &location))
+				return false;
+			kept.push_back(location);
+		}
+
+		return WriteIndex(file, kept);
+	}
+
+	// Writes only the live records to a new file and replaces the old one with it.
+	bool Rewrite(std::vector<Location>& kept)
+	{
+		std::string temp_filename = m_filename + ".tmp";
+		{
+			File::IOFile file(temp_filename, "wb");
+			Header header;
+			if (!file.WriteArray(&header, 1))
+				return false;
+
+			std::vector<Location> locations;
+			for (const Location& old_location : kept)
+			{
+				Location location;
+				const V* value = (const V*)(m_file.GetData() + old_location.offset);
+				if (!WriteRecord(file, old_location.key_bytes, value, old_location.value_size, &location))
+					return false;
+				locations.push_back(location);
+			}
+			for (auto& entry : m_new_entries)
+			{
+				Location location;
+				if (!WriteRecord(file, entry.first, entry.second.data(), (u32)entry.second.size(), &location))
+					return false;
+				locations.push_back(location);
+			}
+
+			if (!WriteIndex(file, locations))
+				return false;
+		}
+
+		UnmapFile();
+		return File::Rename(temp_filename, m_filename);
+	}
+
+	std::string m_filename;
+	MappedFile m_file;
+	File::IOFile m_journal; // new entries since the last Sync
+	std::vector<u8> m_valid_index; // only used if the file had invalid entries
+	const u8* m_index;
+	u32 m_num_entries;
+	u64 m_index_offset;
+
+	std::map<std::string, std::vector<V>> m_new_entries; // raw key bytes -> value
+	std::set<std::string> m_erased;
+};
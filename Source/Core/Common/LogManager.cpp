@@ -82,6 +82,15 @@ LogManager::LogManager()
 	m_Log[LogTypes::MEMCARD_MANAGER]    = new LogContainer("MemCard Manager", "MemCard Manager");
 	m_Log[LogTypes::NETPLAY]            = new LogContainer("NETPLAY",         "Netplay");
 
+	m_queue = new QueuedMessage[QUEUE_SIZE];
+	for (u32 i = 0; i < QUEUE_SIZE; ++i)
+		m_queue[i].sequence = i;
+	m_queue_write = 0;
+	m_queue_read = 0;
+	m_dropped = 0;
+	m_log_thread_idle = false;
+	m_log_thread_running = true;
+
 	m_fileLog = new FileLogListener(File::GetUserPath(F_MAINLOG_IDX).c_str());
 	m_consoleLog = new ConsoleListener();
 	m_debuggerLog = new DebuggerLogListener();
@@ -96,10 +105,17 @@ LogManager::LogManager()
 			container->AddListener(m_debuggerLog);
 #endif
 	}
+
+	m_log_thread = std::thread(&LogManager::LogThread, this);
 }
 
 LogManager::~LogManager()
 {
+	// Writes out whatever is still queued
+	m_log_thread_running = false;
+	m_queue_event.Set();
+	m_log_thread.join();
+
 	for (int i = 0; i < LogTypes::NUMBER_OF_LOGS; ++i)
 	{
 		m_logManager->RemoveListener((LogTypes::LOG_TYPE)i, m_fileLog);
@@ -113,28 +129,115 @@ LogManager::~LogManager()
 	delete m_fileLog;
 	delete m_consoleLog;
 	delete m_debuggerLog;
+	delete[] m_queue;
 }
 
 void LogManager::Log(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type,
 	const char *file, int line, const char *format, va_list args)
 {
-	char temp[MAX_MSGLEN];
 	LogContainer *log = m_Log[type];
 
 	if (!log->IsEnabled() || level > log->GetLevel() || ! log->HasListeners())
 		return;
 
-	CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
+	// Claim the slot at the write position, unless the log thread hasn't freed it yet
+	QueuedMessage *entry;
+	u32 pos = m_queue_write.load(std::memory_order_relaxed);
+	while (true)
+	{
+		entry = &m_queue[pos & (QUEUE_SIZE - 1)];
+		s32 diff = (s32)(entry->sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0)
+		{
+			if (m_queue_write.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			m_dropped++;
+			return;
+		}
+		else
+		{
+			pos = m_queue_write.load(std::memory_order_relaxed);
+		}
+	}
+
+	entry->timestamp = Common::Timer::GetTimeMsSinceJan1970();
+	entry->level = level;
+	entry->type = type;
+	entry->file = file;
+	entry->line = line;
+	CharArrayFromFormatV(entry->msg, MAX_MSGLEN, format, args);
+	entry->sequence.store(pos + 1);
+
+	// Only take the event's lock when the log thread went to sleep
+	if (m_log_thread_idle)
+		m_queue_event.Set();
+}
+
+void LogManager::ReportDropped(LogTypes::LOG_TYPE type)
+{
+	u32 dropped = m_dropped.exchange(0);
+	if (!dropped)
+		return;
 
-	std::string msg = StringFromFormat("%s %s:%u %c[%s]: %s\n",
+	std::string msg = StringFromFormat("%s %c[%s]: %u messages were dropped, the log queue was full\n",
 	                                   Common::Timer::GetTimeFormatted().c_str(),
-	                                   file, line, 
-	                                   LogTypes::LOG_LEVEL_TO_CHAR[(int)level],
-	                                   log->GetShortName(), temp);
+	                                   LogTypes::LOG_LEVEL_TO_CHAR[(int)LogTypes::LWARNING],
+	                                   m_Log[type]->GetShortName(), dropped);
+	m_Log[type]->Trigger(LogTypes::LWARNING, msg.c_str());
+}
+
+// Returns false if the queue was empty
+bool LogManager::ProcessQueue()
+{
+	bool processed = false;
+	while (true)
+	{
+		QueuedMessage &entry = m_queue[m_queue_read & (QUEUE_SIZE - 1)];
+		if (entry.sequence.load() != m_queue_read + 1)
+			return processed;
+
+		// Report the gap where it happened, on the log which most likely caused it
+		ReportDropped(entry.type);
+
+		LogContainer *log = m_Log[entry.type];
+		std::string msg = StringFromFormat("%s %s:%u %c[%s]: %s\n",
+		                                   Common::Timer::GetTimeFormatted(entry.timestamp).c_str(),
+		                                   entry.file, entry.line,
+		                                   LogTypes::LOG_LEVEL_TO_CHAR[(int)entry.level],
+		                                   log->GetShortName(), entry.msg);
 #ifdef ANDROID
-	Host_SysMessage(msg.c_str());
+		Host_SysMessage(msg.c_str());
 #endif
-	log->Trigger(level, msg.c_str());
+		log->Trigger(entry.level, msg.c_str());
+
+		entry.sequence.store(m_queue_read + QUEUE_SIZE, std::memory_order_release);
+		m_queue_read++;
+		processed = true;
+	}
+}
+
+void LogManager::LogThread()
+{
+	Common::SetCurrentThreadName("Log thread");
+
+	while (m_log_thread_running)
+	{
+		if (ProcessQueue())
+			continue;
+
+		// Announce the sleep before checking once more, so that a message which
+		// is written in between either gets seen here or sets the event.
+		m_log_thread_idle = true;
+		if (!ProcessQueue() && m_log_thread_running)
+			m_queue_event.Wait();
+		m_log_thread_idle = false;
+	}
+
+	ProcessQueue();
+	ReportDropped(LogTypes::MASTER_LOG);
 }
 
 void LogManager::Init()
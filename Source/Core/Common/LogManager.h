@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdarg>
 #include <fstream>
 #include <mutex>
 #include <set>
+#include <thread>
 
 #include "Common/Common.h"
+#include "Common/Thread.h"
 
 #define MAX_MESSAGES 8000
 #define MAX_MSGLEN  1024
@@ -85,14 +88,45 @@ class ConsoleListener;
 class LogManager : NonCopyable
 {
 private:
+	// Log only formats the message into a free slot of a lock-free ring buffer.
+	// The timestamp, the rest of the line and the listeners are all done on the
+	// log thread, so a verbose log doesn't slow down the thread writing it. When
+	// the ring is full, messages are counted and dropped instead of waiting.
+	struct QueuedMessage
+	{
+		// Equals the write position the slot is free for, or that plus one once written
+		std::atomic<u32> sequence;
+		u64 timestamp;
+		LogTypes::LOG_LEVELS level;
+		LogTypes::LOG_TYPE type;
+		const char *file;
+		int line;
+		char msg[MAX_MSGLEN];
+	};
+
+	enum { QUEUE_SIZE = 4096 }; // must be a power of two
+
 	LogContainer* m_Log[LogTypes::NUMBER_OF_LOGS];
 	FileLogListener *m_fileLog;
 	ConsoleListener *m_consoleLog;
 	DebuggerLogListener *m_debuggerLog;
 	static LogManager *m_logManager;  // Singleton. Ugh.
 
+	QueuedMessage *m_queue;
+	std::atomic<u32> m_queue_write;
+	u32 m_queue_read; // only used by the log thread
+	std::atomic<u32> m_dropped;
+	std::atomic<bool> m_log_thread_idle;
+	std::atomic<bool> m_log_thread_running;
+	Common::Event m_queue_event;
+	std::thread m_log_thread;
+
 	LogManager();
 	~LogManager();
+
+	void LogThread();
+	bool ProcessQueue();
+	void ReportDropped(LogTypes::LOG_TYPE type);
 public:
 
 	static u32 GetMaxLevel() { return MAX_LOGLEVEL; }
@@ -0,0 +1,35 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/Common.h"
+
+// Read-only view of a whole file through the OS page cache. Pages are only
+// brought in when touched, so large files cost neither load time nor memory
+// up front.
+class MappedFile : NonCopyable
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	// Maps the whole file. Fails for missing and empty files.
+	bool Open(const std::string& filename);
+	void Close();
+
+	bool IsOpen() const { return m_data != nullptr; }
+	const u8* GetData() const { return m_data; }
+	u64 GetSize() const { return m_size; }
+
+private:
+	const u8* m_data;
+	u64 m_size;
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#endif
+};
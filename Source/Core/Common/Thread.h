@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 // Don't include common.h here as it will break LogManager
 #include "Common/CommonTypes.h"
@@ -120,4 +122,36 @@ inline void YieldCPU()
 
 void SetCurrentThreadName(const char *name);
 
+inline u32 GetNumHardwareThreads()
+{
+	return std::max(1U, std::thread::hardware_concurrency());
+}
+
+// Calls func(i) for every i in [0, count) spread over num_workers threads,
+// and returns once all calls are done. Worker t handles the indices which
+// are t modulo num_workers, so i % num_workers can index per thread state.
+template <typename F>
+void ParallelFor(u32 num_workers, u32 count, F func)
+{
+	num_workers = std::min(num_workers, count);
+	if (num_workers <= 1)
+	{
+		for (u32 i = 0; i < count; i++)
+			func(i);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	workers.reserve(num_workers);
+	for (u32 t = 0; t < num_workers; t++)
+	{
+		workers.push_back(std::thread([=]() {
+			for (u32 i = t; i < count; i += num_workers)
+				func(i);
+		}));
+	}
+	for (auto& worker : workers)
+		worker.join();
+}
+
 } // namespace Common
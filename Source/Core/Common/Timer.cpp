@@ -169,23 +169,32 @@ u64 Timer::GetLocalTimeSinceJan1970()
 // in the form 00:00:000.
 std::string Timer::GetTimeFormatted()
 {
-	time_t sysTime;
-	time(&sysTime);
-	
+	return GetTimeFormatted(GetTimeMsSinceJan1970());
+}
+
+std::string Timer::GetTimeFormatted(u64 ms_since_jan1970)
+{
+	time_t sysTime = (time_t)(ms_since_jan1970 / 1000);
+
 	struct tm * gmTime = localtime(&sysTime);
 
 	char tmp[13];
 	strftime(tmp, 6, "%M:%S", gmTime);
 
 	// Now tack on the milliseconds
+	return StringFromFormat("%s:%03i", tmp, (int)(ms_since_jan1970 % 1000));
+}
+
+u64 Timer::GetTimeMsSinceJan1970()
+{
 #ifdef _WIN32
 	struct timeb tp;
 	(void)::ftime(&tp);
-	return StringFromFormat("%s:%03i", tmp, tp.millitm);
+	return (u64)tp.time * 1000 + tp.millitm;
 #else
 	struct timeval t;
 	(void)gettimeofday(&t, NULL);
-	return StringFromFormat("%s:%03d", tmp, (int)(t.tv_usec / 1000));
+	return (u64)t.tv_sec * 1000 + t.tv_usec / 1000;
 #endif
 }
 
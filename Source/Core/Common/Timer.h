@@ -29,6 +29,9 @@ public:
 	static double GetDoubleTime();
 
 	static std::string GetTimeFormatted();
+	// Same, for a time returned by GetTimeMsSinceJan1970 earlier
+	static std::string GetTimeFormatted(u64 ms_since_jan1970);
+	static u64 GetTimeMsSinceJan1970();
 	std::string GetTimeElapsedFormatted() const;
 	u64 GetTimeElapsed();
 
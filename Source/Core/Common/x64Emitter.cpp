@@ -554,6 +554,7 @@ void XEmitter::POPF()  {Write8(0x9D);}
 void XEmitter::LFENCE() {Write8(0x0F); Write8(0xAE); Write8(0xE8);}
 void XEmitter::MFENCE() {Write8(0x0F); Write8(0xAE); Write8(0xF0);}
 void XEmitter::SFENCE() {Write8(0x0F); Write8(0xAE); Write8(0xF8);}
+void XEmitter::RDTSC()  {Write8(0x0F); Write8(0x31);}
 
 void XEmitter::WriteSimple1Byte(int bits, u8 byte, X64Reg reg)
 {
@@ -1224,8 +1225,8 @@ void XEmitter::MOVQ_xmm(OpArg arg, X64Reg src) {
 		arg.WriteRest(this, 0);
 	} else {
 		arg.operandReg = src;
-		arg.WriteRex(this, 0, 0);
 		Write8(0x66);
+		arg.WriteRex(this, 0, 0);
 		Write8(0x0f);
 		Write8(0xD6);
 		arg.WriteRest(this, 0);
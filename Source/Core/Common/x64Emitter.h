@@ -343,6 +343,9 @@ public:
 	void MFENCE();
 	void SFENCE();
 
+	// Time stamp counter, result in EDX:EAX
+	void RDTSC();
+
 	// Bit scan
 	void BSF(int bits, X64Reg dest, OpArg src); //bottom bit to top bit
 	void BSR(int bits, X64Reg dest, OpArg src); //top bit to bottom bit
@@ -8,6 +8,7 @@
 #include "Common/IniFile.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/SI.h"
+#include "DiscIO/Blob.h"
 #include "DiscIO/NANDContentLoader.h"
 
 SConfig* SConfig::m_Instance;
@@ -107,6 +108,7 @@ static const struct
 	{ "SaveFirstState",      0,                   0 /* wxMOD_NONE */ },
 	{ "UndoLoadState",       351 /* WXK_F12 */,   0 /* wxMOD_NONE */ },
 	{ "UndoSaveState",       351 /* WXK_F12 */,   4 /* wxMOD_SHIFT */ },
+	{ "Rewind",              0,                   0 /* wxMOD_NONE */ },
 	{ "SaveStateFile",       0,                   0 /* wxMOD_NONE */ },
 	{ "LoadStateFile",       0,                   0 /* wxMOD_NONE */ },
 };
@@ -402,6 +404,7 @@ void SConfig::LoadSettings()
 		ini.Get("Core", "BBA_MAC",           &m_bba_mac);
 		ini.Get("Core", "TimeProfiling",     &m_LocalCoreStartupParameter.bJITILTimeProfiling, false);
 		ini.Get("Core", "OutputIR",          &m_LocalCoreStartupParameter.bJITILOutputIR,      false);
+		ini.Get("Core", "JITPersistentCache", &m_LocalCoreStartupParameter.bJITPersistentCache, false);
 		for (int i = 0; i < MAX_SI_CHANNELS; ++i)
 		{
 			ini.Get("Core", StringFromFormat("SIDevice%i", i), (u32*)&m_SIDevice[i], (i == 0) ? SIDEVICE_GC_CONTROLLER : SIDEVICE_NONE);
@@ -418,6 +421,13 @@ void SConfig::LoadSettings()
 		ini.Get("Core", "VBeam",                     &m_LocalCoreStartupParameter.bVBeamSpeedHack,   false);
 		ini.Get("Core", "SyncGPU",                   &m_LocalCoreStartupParameter.bSyncGPU,          false);
 		ini.Get("Core", "FastDiscSpeed",             &m_LocalCoreStartupParameter.bFastDiscSpeed,    false);
+		ini.Get("Core", "DiscCacheSize",             &m_LocalCoreStartupParameter.iDiscCacheSize,    16);
+		ini.Get("Core", "DiscReadAhead",             &m_LocalCoreStartupParameter.iDiscReadAhead,    8);
+		DiscIO::SectorReader::SetCacheLimits((u32)m_LocalCoreStartupParameter.iDiscCacheSize * 1024 * 1024,
+		                                     m_LocalCoreStartupParameter.iDiscReadAhead);
+		ini.Get("Core", "Rewind",                    &m_LocalCoreStartupParameter.bRewind,           false);
+		ini.Get("Core", "RewindInterval",            &m_LocalCoreStartupParameter.iRewindInterval,   1000);
+		ini.Get("Core", "RewindMemory",              &m_LocalCoreStartupParameter.iRewindMemory,     256);
 		ini.Get("Core", "DCBZ",                      &m_LocalCoreStartupParameter.bDCBZOFF,          false);
 		ini.Get("Core", "FrameLimit",                &m_Framelimit,                                  1); // auto frame limit by default
 		ini.Get("Core", "FrameSkip",                 &m_FrameSkip,                                   0);
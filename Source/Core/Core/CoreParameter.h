@@ -76,6 +76,7 @@ enum Hotkey
 	HK_SAVE_FIRST_STATE,
 	HK_UNDO_LOAD_STATE,
 	HK_UNDO_SAVE_STATE,
+	HK_REWIND,
 	HK_SAVE_STATE_FILE,
 	HK_LOAD_STATE_FILE,
 
@@ -113,6 +114,7 @@ struct SCoreStartupParameter
 	bool bJITBranchOff;
 	bool bJITILTimeProfiling;
 	bool bJITILOutputIR;
+	bool bJITPersistentCache;
 
 	bool bFastmem;
 	bool bEnableFPRF;
@@ -142,6 +144,15 @@ struct SCoreStartupParameter
 	bool bSyncGPU;
 	bool bFastDiscSpeed;
 
+	// Per disc image block cache size in MB and number of blocks to read ahead
+	int iDiscCacheSize;
+	int iDiscReadAhead;
+
+	// Rewind buffer: capture interval in ms of emulated time and memory budget in MB
+	bool bRewind;
+	int iRewindInterval;
+	int iRewindMemory;
+
 	int SelectedLanguage;
 
 	bool bWii;
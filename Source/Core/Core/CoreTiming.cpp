@@ -2,10 +2,12 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <functional>
 #include <vector>
 
-#include "Common/FifoQueue.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 
@@ -24,6 +26,10 @@ struct EventType
 {
 	TimedCallback callback;
 	const char *name;
+	// RemoveEvent only bumps the generation, queued events of an older one are
+	// dropped once they reach the top of the queue.
+	u32 generation;
+	int num_scheduled;
 };
 
 std::vector<EventType> event_types;
@@ -35,15 +41,35 @@ struct BaseEvent
 	int type;
 };
 
-typedef LinkedListItem<BaseEvent> Event;
+struct Event : BaseEvent
+{
+	u64 fifo_order;
+	u32 generation;
+};
 
-// STATE_TO_SAVE
-static Event *first;
-static std::mutex tsWriteLock;
-Common::FifoQueue<BaseEvent, false> tsQueue;
+// Orders the queue by time. Events for the same cycle fire in the order they were scheduled in.
+static bool operator>(const Event& a, const Event& b)
+{
+	return a.time > b.time || (a.time == b.time && a.fifo_order > b.fifo_order);
+}
+
+static bool operator<(const Event& a, const Event& b)
+{
+	return b > a;
+}
 
-// event pools
-Event *eventPool = 0;
+// Events scheduled from other threads are pushed onto this lock-free stack, the
+// CPU thread takes the whole stack at once in MoveEvents.
+struct ThreadsafeEvent : BaseEvent
+{
+	ThreadsafeEvent* next;
+};
+
+// STATE_TO_SAVE
+static std::vector<Event> event_queue; // binary min-heap
+static u64 event_fifo_id;
+static int num_stale_events;
+static std::atomic<ThreadsafeEvent*> ts_first;
 
 int downcount, slicelength;
 int maxSliceLength = MAX_SLICE_LENGTH;
@@ -61,22 +87,6 @@ int ev_lost;
 
 void (*advanceCallback)(int cyclesExecuted) = NULL;
 
-Event* GetNewEvent()
-{
-	if(!eventPool)
-		return new Event;
-
-	Event* ev = eventPool;
-	eventPool = ev->next;
-	return ev;
-}
-
-void FreeEvent(Event* ev)
-{
-	ev->next = eventPool;
-	eventPool = ev;
-}
-
 static void EmptyTimedCallback(u64 userdata, int cyclesLate) {}
 
 int RegisterEvent(const char *name, TimedCallback callback)
@@ -84,6 +94,8 @@ int RegisterEvent(const char *name, TimedCallback callback)
 	EventType type;
 	type.name = name;
 	type.callback = callback;
+	type.generation = 0;
+	type.num_scheduled = 0;
 
 	// check for existing type with same name.
 	// we want event type names to remain unique so that we can use them for serialization.
@@ -105,7 +117,7 @@ int RegisterEvent(const char *name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-	if (first)
+	if (!event_queue.empty())
 		PanicAlertT("Cannot unregister events with events pending");
 	event_types.clear();
 }
@@ -122,16 +134,72 @@ void Init()
 
 void Shutdown()
 {
-	std::lock_guard<std::mutex> lk(tsWriteLock);
 	MoveEvents();
 	ClearPendingEvents();
 	UnregisterAllEvents();
+}
+
+static bool IsStale(const Event& ev)
+{
+	return ev.generation != event_types[ev.type].generation;
+}
+
+// Drops removed events from the top of the queue, so that the front is the next event to fire.
+static void PopStaleEvents()
+{
+	while (!event_queue.empty() && IsStale(event_queue.front()))
+	{
+		std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+		event_queue.pop_back();
+		num_stale_events--;
+	}
+}
 
-	while(eventPool)
+// Returns the events which are still scheduled, in the order they will fire.
+static std::vector<Event> GetSortedEvents()
+{
+	std::vector<Event> events;
+	events.reserve(event_queue.size());
+	for (const Event& ev : event_queue)
 	{
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		delete ev;
+		if (!IsStale(ev))
+			events.push_back(ev);
+	}
+	std::sort(events.begin(), events.end());
+	return events;
+}
+
+static void AddEventToQueue(s64 time, int event_type, u64 userdata)
+{
+	EventType& type = event_types[event_type];
+
+	Event ne;
+	ne.time = time;
+	ne.userdata = userdata;
+	ne.type = event_type;
+	ne.fifo_order = event_fifo_id++;
+	ne.generation = type.generation;
+	type.num_scheduled++;
+
+	event_queue.push_back(ne);
+	std::push_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+}
+
+// Runs all events which are due at globalTimer.
+static void RunDueEvents()
+{
+	PopStaleEvents();
+	while (!event_queue.empty() && event_queue.front().time <= globalTimer)
+	{
+		//LOG(POWERPC, "[Scheduler] %s     (%lld, %lld) ",
+		//             event_types[evt.type].name ? event_types[evt.type].name : "?", (u64)globalTimer, (u64)evt.time);
+		Event evt = event_queue.front();
+		std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+		event_queue.pop_back();
+
+		event_types[evt.type].num_scheduled--;
+		event_types[evt.type].callback(evt.userdata, (int)(globalTimer - evt.time));
+		PopStaleEvents();
 	}
 }
 
@@ -171,7 +239,6 @@ void EventDoState(PointerWrap &p, BaseEvent* ev)
 
 void DoState(PointerWrap &p)
 {
-	std::lock_guard<std::mutex> lk(tsWriteLock);
 	p.Do(downcount);
 	p.Do(slicelength);
 	p.Do(globalTimer);
@@ -184,7 +251,34 @@ void DoState(PointerWrap &p)
 
 	MoveEvents();
 
-	p.DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, EventDoState>(first);
+	// Same layout as the linked list the events used to be kept in: each event
+	// in firing order behind a 1 byte, then a 0 byte.
+	if (p.GetMode() == PointerWrap::MODE_READ)
+	{
+		ClearPendingEvents();
+		while (true)
+		{
+			u8 shouldExist = 0;
+			p.Do(shouldExist);
+			if (shouldExist != 1)
+				break;
+
+			BaseEvent ev;
+			EventDoState(p, &ev);
+			AddEventToQueue(ev.time, ev.type, ev.userdata);
+		}
+	}
+	else
+	{
+		for (Event& ev : GetSortedEvents())
+		{
+			u8 shouldExist = 1;
+			p.Do(shouldExist);
+			EventDoState(p, &ev);
+		}
+		u8 shouldExist = 0;
+		p.Do(shouldExist);
+	}
 	p.DoMarker("CoreTimingEvents");
 }
 
@@ -202,12 +296,14 @@ u64 GetIdleTicks()
 // schedule things to be executed on the main thread.
 void ScheduleEvent_Threadsafe(int cyclesIntoFuture, int event_type, u64 userdata)
 {
-	std::lock_guard<std::mutex> lk(tsWriteLock);
-	Event ne;
-	ne.time = globalTimer + cyclesIntoFuture;
-	ne.type = event_type;
-	ne.userdata = userdata;
-	tsQueue.Push(ne);
+	ThreadsafeEvent* ne = new ThreadsafeEvent;
+	ne->time = globalTimer + cyclesIntoFuture;
+	ne->type = event_type;
+	ne->userdata = userdata;
+	ne->next = ts_first.load(std::memory_order_relaxed);
+	while (!ts_first.compare_exchange_weak(ne->next, ne, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
 }
 
 // Same as ScheduleEvent_Threadsafe(0, ...) EXCEPT if we are already on the CPU thread
@@ -226,30 +322,10 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 
 void ClearPendingEvents()
 {
-	while (first)
-	{
-		Event *e = first->next;
-		FreeEvent(first);
-		first = e;
-	}
-}
-
-void AddEventToQueue(Event* ne)
-{
-	Event* prev = NULL;
-	Event** pNext = &first;
-	for(;;)
-	{
-		Event*& next = *pNext;
-		if(!next || ne->time < next->time)
-		{
-			ne->next = next;
-			next = ne;
-			break;
-		}
-		prev = next;
-		pNext = &prev->next;
-	}
+	event_queue.clear();
+	num_stale_events = 0;
+	for (auto& event_type : event_types)
+		event_type.num_scheduled = 0;
 }
 
 // This must be run ONLY from within the cpu thread
@@ -257,11 +333,7 @@ void AddEventToQueue(Event* ne)
 // than Advance
 void ScheduleEvent(int cyclesIntoFuture, int event_type, u64 userdata)
 {
-	Event *ne = GetNewEvent();
-	ne->userdata = userdata;
-	ne->type = event_type;
-	ne->time = globalTimer + cyclesIntoFuture;
-	AddEventToQueue(ne);
+	AddEventToQueue(globalTimer + cyclesIntoFuture, event_type, userdata);
 }
 
 void RegisterAdvanceCallback(void (*callback)(int cyclesExecuted))
@@ -271,54 +343,26 @@ void RegisterAdvanceCallback(void (*callback)(int cyclesExecuted))
 
 bool IsScheduled(int event_type)
 {
-	if (!first)
-		return false;
-	Event *e = first;
-	while (e) {
-		if (e->type == event_type)
-			return true;
-		e = e->next;
-	}
-	return false;
+	return event_types[event_type].num_scheduled > 0;
 }
 
 void RemoveEvent(int event_type)
 {
-	if (!first)
+	EventType& type = event_types[event_type];
+	if (!type.num_scheduled)
 		return;
 
-	while(first)
-	{
-		if (first->type == event_type)
-		{
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-
-	if (!first)
-		return;
+	num_stale_events += type.num_scheduled;
+	type.num_scheduled = 0;
+	type.generation++;
 
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
+	// Events far in the future may take a while to reach the top, so clean up
+	// once they make up most of the queue.
+	if (num_stale_events > 32 && num_stale_events > (int)event_queue.size() / 2)
 	{
-		if (ptr->type == event_type)
-		{
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
+		event_queue.erase(std::remove_if(event_queue.begin(), event_queue.end(), IsStale), event_queue.end());
+		std::make_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+		num_stale_events = 0;
 	}
 }
 
@@ -352,36 +396,29 @@ void ResetSliceLength()
 void ProcessFifoWaitEvents()
 {
 	MoveEvents();
+	RunDueEvents();
+}
 
-	if (!first)
-		return;
+void MoveEvents()
+{
+	ThreadsafeEvent* list = ts_first.exchange(nullptr, std::memory_order_acquire);
 
-	while (first)
+	// The stack has the newest event on top, reverse it to keep the scheduling order.
+	ThreadsafeEvent* reversed = nullptr;
+	while (list)
 	{
-		if (first->time <= globalTimer)
-		{
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(globalTimer - evt->time));
-			FreeEvent(evt);
-		}
-		else
-		{
-			break;
-		}
+		ThreadsafeEvent* next = list->next;
+		list->next = reversed;
+		reversed = list;
+		list = next;
 	}
-}
 
-void MoveEvents()
-{
-	BaseEvent sevt;
-	while (tsQueue.Pop(sevt))
+	while (reversed)
 	{
-		Event *evt = GetNewEvent();
-		evt->time = sevt.time;
-		evt->userdata = sevt.userdata;
-		evt->type = sevt.type;
-		AddEventToQueue(evt);
+		ThreadsafeEvent* next = reversed->next;
+		AddEventToQueue(reversed->time, reversed->type, reversed->userdata);
+		delete reversed;
+		reversed = next;
 	}
 }
 
@@ -393,31 +430,16 @@ void Advance()
 	globalTimer += cyclesExecuted;
 	downcount = slicelength;
 
-	while (first)
-	{
-		if (first->time <= globalTimer)
-		{
-			//LOG(POWERPC, "[Scheduler] %s     (%lld, %lld) ",
-			//             event_types[first->type].name ? event_types[first->type].name : "?", (u64)globalTimer, (u64)first->time);
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(globalTimer - evt->time));
-			FreeEvent(evt);
-		}
-		else
-		{
-			break;
-		}
-	}
+	RunDueEvents();
 
-	if (!first)
+	if (event_queue.empty())
 	{
 		WARN_LOG(POWERPC, "WARNING - no events in queue. Setting downcount to 10000");
 		downcount += 10000;
 	}
 	else
 	{
-		slicelength = (int)(first->time - globalTimer);
+		slicelength = (int)(event_queue.front().time - globalTimer);
 		if (slicelength > maxSliceLength)
 			slicelength = maxSliceLength;
 		downcount = slicelength;
@@ -429,12 +451,8 @@ void Advance()
 
 void LogPendingEvents()
 {
-	Event *ptr = first;
-	while (ptr)
-	{
-		INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %d", globalTimer, ptr->time, ptr->type);
-		ptr = ptr->next;
-	}
+	for (const Event& ev : GetSortedEvents())
+		INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %d", globalTimer, ev.time, ev.type);
 }
 
 void Idle()
@@ -458,21 +476,19 @@ void Idle()
 
 std::string GetScheduledEventsSummary()
 {
-	Event *ptr = first;
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
-	while (ptr)
+	for (const Event& ev : GetSortedEvents())
 	{
-		unsigned int t = ptr->type;
+		unsigned int t = ev.type;
 		if (t >= event_types.size())
 			PanicAlertT("Invalid event type %i", t);
 
-		const char *name = event_types[ptr->type].name;
+		const char *name = event_types[ev.type].name;
 		if (!name)
 			name = "[unknown]";
 
-		text += StringFromFormat("%s : %" PRIi64 " %016" PRIx64 "\n", name, ptr->time, ptr->userdata);
-		ptr = ptr->next;
+		text += StringFromFormat("%s : %" PRIi64 " %016" PRIx64 "\n", name, ev.time, ev.userdata);
 	}
 	return text;
 }
@@ -20,21 +20,21 @@ void Init()
 	VertexLoader_TextCoord::Init();
 }
 
-u8 ReadFifo8(u8 *&data)
+u8 ReadFifo8(const u8 *&data)
 {
 	u8 value = data[0];
 	data += 1;
 	return value;
 }
 
-u16 ReadFifo16(u8 *&data)
+u16 ReadFifo16(const u8 *&data)
 {
 	u16 value = Common::swap16(data);
 	data += 2;
 	return value;
 }
 
-u32 ReadFifo32(u8 *&data)
+u32 ReadFifo32(const u8 *&data)
 {
 	u32 value = Common::swap32(data);
 	data += 4;
@@ -13,9 +13,9 @@ namespace FifoAnalyzer
 {
 	void Init();
 
-	u8 ReadFifo8(u8 *&data);
-	u16 ReadFifo16(u8 *&data);
-	u32 ReadFifo32(u8 *&data);
+	u8 ReadFifo8(const u8 *&data);
+	u16 ReadFifo16(const u8 *&data);
+	u32 ReadFifo32(const u8 *&data);
 
 	// TODO- move to video common
 	void InitBPMemory(BPMemory *bpMem);
@@ -2,6 +2,9 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <memory>
+
 #include "Common/FileUtil.h"
 
 #include "Core/FifoPlayer/FifoDataFile.h"
@@ -17,6 +20,9 @@ FifoDataFile::FifoDataFile() :
 
 FifoDataFile::~FifoDataFile()
 {
+	if (m_Mapping.IsOpen())
+		return;
+
 	for (auto& frame : m_Frames)
 	{
 		for (auto& update : frame.memoryUpdates)
@@ -127,71 +133,67 @@ bool FifoDataFile::Save(const char *filename)
 
 FifoDataFile *FifoDataFile::Load(const std::string &filename, bool flagsOnly)
 {
-	File::IOFile file;
-	file.Open(filename, "rb");
-	if (!file)
+	// Nothing is read up front, frames are handed out as views of the mapping.
+	std::unique_ptr<FifoDataFile> dataFile(new FifoDataFile);
+	if (!dataFile->m_Mapping.Open(filename))
+		return NULL;
+
+	const u8 *headerData = dataFile->GetFileData(0, sizeof(FileHeader));
+	if (!headerData)
 		return NULL;
 
 	FileHeader header;
-	file.ReadBytes(&header, sizeof(header));
+	memcpy(&header, headerData, sizeof(header));
 
 	if (header.fileId != FILE_ID || header.min_loader_version > VERSION_NUMBER)
-	{
-		file.Close();
 		return NULL;
-	}
-
-	FifoDataFile* dataFile = new FifoDataFile;
 
 	dataFile->m_Flags = header.flags;
 
 	if (flagsOnly)
 	{
-		file.Close();
-		return dataFile;
+		dataFile->m_Mapping.Close();
+		return dataFile.release();
 	}
 
-	u32 size = std::min((u32)BP_MEM_SIZE, header.bpMemSize);
-	file.Seek(header.bpMemOffset, SEEK_SET);
-	file.ReadArray(dataFile->m_BPMem, size);
-
-	size = std::min((u32)CP_MEM_SIZE, header.cpMemSize);
-	file.Seek(header.cpMemOffset, SEEK_SET);
-	file.ReadArray(dataFile->m_CPMem, size);
-
-	size = std::min((u32)XF_MEM_SIZE, header.xfMemSize);
-	file.Seek(header.xfMemOffset, SEEK_SET);
-	file.ReadArray(dataFile->m_XFMem, size);
+	const u8 *bpMem = dataFile->GetFileData(header.bpMemOffset, std::min((u32)BP_MEM_SIZE, header.bpMemSize) * sizeof(u32));
+	const u8 *cpMem = dataFile->GetFileData(header.cpMemOffset, std::min((u32)CP_MEM_SIZE, header.cpMemSize) * sizeof(u32));
+	const u8 *xfMem = dataFile->GetFileData(header.xfMemOffset, std::min((u32)XF_MEM_SIZE, header.xfMemSize) * sizeof(u32));
+	const u8 *xfRegs = dataFile->GetFileData(header.xfRegsOffset, std::min((u32)XF_REGS_SIZE, header.xfRegsSize) * sizeof(u32));
+	const u8 *frameList = dataFile->GetFileData(header.frameListOffset, (u64)header.frameCount * sizeof(FileFrameInfo));
+	if (!bpMem || !cpMem || !xfMem || !xfRegs || !frameList)
+		return NULL;
 
-	size = std::min((u32)XF_REGS_SIZE, header.xfRegsSize);
-	file.Seek(header.xfRegsOffset, SEEK_SET);
-	file.ReadArray(dataFile->m_XFRegs, size);
+	memcpy(dataFile->m_BPMem, bpMem, std::min((u32)BP_MEM_SIZE, header.bpMemSize) * sizeof(u32));
+	memcpy(dataFile->m_CPMem, cpMem, std::min((u32)CP_MEM_SIZE, header.cpMemSize) * sizeof(u32));
+	memcpy(dataFile->m_XFMem, xfMem, std::min((u32)XF_MEM_SIZE, header.xfMemSize) * sizeof(u32));
+	memcpy(dataFile->m_XFRegs, xfRegs, std::min((u32)XF_REGS_SIZE, header.xfRegsSize) * sizeof(u32));
 
 	// Read frames
+	dataFile->m_Frames.resize(header.frameCount);
 	for (u32 i = 0; i < header.frameCount; ++i)
 	{
-		u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
-		file.Seek(frameOffset, SEEK_SET);
 		FileFrameInfo srcFrame;
-		file.ReadBytes(&srcFrame, sizeof(FileFrameInfo));
+		memcpy(&srcFrame, frameList + i * sizeof(FileFrameInfo), sizeof(FileFrameInfo));
 
-		FifoFrameInfo dstFrame;
-		dstFrame.fifoData = new u8[srcFrame.fifoDataSize];
+		FifoFrameInfo &dstFrame = dataFile->m_Frames[i];
+		dstFrame.fifoData = dataFile->GetFileData(srcFrame.fifoDataOffset, srcFrame.fifoDataSize);
 		dstFrame.fifoDataSize = srcFrame.fifoDataSize;
 		dstFrame.fifoStart = srcFrame.fifoStart;
 		dstFrame.fifoEnd = srcFrame.fifoEnd;
 
-		file.Seek(srcFrame.fifoDataOffset, SEEK_SET);
-		file.ReadBytes(dstFrame.fifoData, srcFrame.fifoDataSize);
-
-		ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates, dstFrame.memoryUpdates, file);
-
-		dataFile->AddFrame(dstFrame);
+		if (!dstFrame.fifoData || !dataFile->ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates, dstFrame.memoryUpdates))
+			return NULL;
 	}
 
-	file.Close();
+	return dataFile.release();
+}
 
-	return dataFile;
+const u8 *FifoDataFile::GetFileData(u64 offset, u64 size) const
+{
+	if (offset > m_Mapping.GetSize() || size > m_Mapping.GetSize() - offset)
+		return NULL;
+	return m_Mapping.GetData() + offset;
 }
 
 void FifoDataFile::PadFile(u32 numBytes, File::IOFile &file)
@@ -246,25 +248,29 @@ u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate> &memUpdates
 	return updateListOffset;
 }
 
-void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates, std::vector<MemoryUpdate> &memUpdates, File::IOFile &file)
+bool FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates, std::vector<MemoryUpdate> &memUpdates)
 {
+	const u8 *updateList = GetFileData(fileOffset, (u64)numUpdates * sizeof(FileMemoryUpdate));
+	if (!updateList)
+		return false;
+
 	memUpdates.resize(numUpdates);
 
 	for (u32 i = 0; i < numUpdates; ++i)
 	{
-		u64 updateOffset = fileOffset + (i * sizeof(FileMemoryUpdate));
-		file.Seek(updateOffset, SEEK_SET);
 		FileMemoryUpdate srcUpdate;
-		file.ReadBytes(&srcUpdate, sizeof(FileMemoryUpdate));
+		memcpy(&srcUpdate, updateList + i * sizeof(FileMemoryUpdate), sizeof(FileMemoryUpdate));
 
 		MemoryUpdate &dstUpdate = memUpdates[i];
 		dstUpdate.address = srcUpdate.address;
 		dstUpdate.fifoPosition = srcUpdate.fifoPosition;
 		dstUpdate.size = srcUpdate.dataSize;
-		dstUpdate.data = new u8[srcUpdate.dataSize];
+		dstUpdate.data = GetFileData(srcUpdate.dataOffset, srcUpdate.dataSize);
 		dstUpdate.type = (MemoryUpdate::Type)srcUpdate.type;
 
-		file.Seek(srcUpdate.dataOffset, SEEK_SET);
-		file.ReadBytes(dstUpdate.data, srcUpdate.dataSize);
+		if (!dstUpdate.data)
+			return false;
 	}
+
+	return true;
 }
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "Common/Common.h"
+#include "Common/MappedFile.h"
 
 namespace File
 {
@@ -26,13 +27,14 @@ struct MemoryUpdate
 	u32 fifoPosition;
 	u32 address;
 	u32 size;
-	u8 *data;
+	const u8 *data;
 	Type type;
 };
 
+// For loaded files, fifoData and the memory update data point into the mapped file.
 struct FifoFrameInfo
 {
-	u8 *fifoData;
+	const u8 *fifoData;
 	u32 fifoDataSize;
 
 	u32 fifoStart;
@@ -84,7 +86,10 @@ private:
 	bool GetFlag(u32 flag) const;
 
 	u64 WriteMemoryUpdates(const std::vector<MemoryUpdate> &memUpdates, File::IOFile &file);
-	static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates, std::vector<MemoryUpdate> &memUpdates, File::IOFile &file);
+	bool ReadMemoryUpdates(u64 fileOffset, u32 numUpdates, std::vector<MemoryUpdate> &memUpdates);
+
+	// Returns the given range of the mapped file, or NULL if it doesn't fit.
+	const u8 *GetFileData(u64 offset, u64 size) const;
 
 	u32 m_BPMem[BP_MEM_SIZE];
 	u32 m_CPMem[CP_MEM_SIZE];
@@ -94,4 +99,7 @@ private:
 	u32 m_Flags;
 
 	std::vector<FifoFrameInfo> m_Frames;
+
+	// Backs the frames of loaded files, recorded frames own their buffers instead.
+	MappedFile m_Mapping;
 };
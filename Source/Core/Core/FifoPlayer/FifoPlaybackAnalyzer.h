@@ -33,7 +33,7 @@ private:
 
 	void AddMemoryUpdate(MemoryUpdate memUpdate, AnalyzedFrameInfo &frameInfo);
 
-	u32 DecodeCommand(u8 *data);
+	u32 DecodeCommand(const u8 *data);
 	void LoadBP(u32 value0);
 
 	void StoreEfbCopyRegion();
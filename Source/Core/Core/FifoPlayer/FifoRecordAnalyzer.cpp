@@ -40,7 +40,7 @@ void FifoRecordAnalyzer::AnalyzeGPCommand(u8 *data)
 	DecodeOpcode(data);
 }
 
-void FifoRecordAnalyzer::DecodeOpcode(u8 *data)
+void FifoRecordAnalyzer::DecodeOpcode(const u8 *data)
 {
 	int cmd = ReadFifo8(data);
 
@@ -153,7 +153,7 @@ void FifoRecordAnalyzer::ProcessLoadIndexedXf(u32 val, int array)
 	FifoRecorder::GetInstance().WriteMemory(address, size * 4, MemoryUpdate::XF_DATA);
 }
 
-void FifoRecordAnalyzer::ProcessVertexArrays(u8 *data, u8 vtxAttrGroup)
+void FifoRecordAnalyzer::ProcessVertexArrays(const u8 *data, u8 vtxAttrGroup)
 {
 	int sizes[21];
 	FifoAnalyzer::CalculateVertexElementSizes(sizes, vtxAttrGroup, m_CpMem);
@@ -179,7 +179,7 @@ void FifoRecordAnalyzer::ProcessVertexArrays(u8 *data, u8 vtxAttrGroup)
 	}
 }
 
-void FifoRecordAnalyzer::WriteVertexArray(int arrayIndex, u8 *vertexData, int vertexSize, int numVertices)
+void FifoRecordAnalyzer::WriteVertexArray(int arrayIndex, const u8 *vertexData, int vertexSize, int numVertices)
 {
 	// Skip if not indexed array
 	int arrayType = (m_CpMem.vtxDesc.Hex >> (9 + (arrayIndex * 2))) & 3;
@@ -84,9 +84,10 @@ void FifoRecorder::WriteGPCommand(u8 *data, u32 size)
 	if (m_FrameEnded && m_FifoData.size() > 0)
 	{
 		size_t dataSize = m_FifoData.size();
+		u8 *fifoData = new u8[dataSize];
+		memcpy(fifoData, m_FifoData.data(), dataSize);
 		m_CurrentFrame.fifoDataSize = (u32)dataSize;
-		m_CurrentFrame.fifoData = new u8[dataSize];
-		memcpy(m_CurrentFrame.fifoData, m_FifoData.data(), dataSize);
+		m_CurrentFrame.fifoData = fifoData;
 
 		sMutex.lock();
 
@@ -133,8 +134,9 @@ void FifoRecorder::WriteMemory(u32 address, u32 size, MemoryUpdate::Type type)
 		memUpdate.fifoPosition = (u32)(m_FifoData.size());
 		memUpdate.size = size;
 		memUpdate.type = type;
-		memUpdate.data = new u8[size];
-		memcpy(memUpdate.data, newData, size);
+		u8 *data = new u8[size];
+		memcpy(data, newData, size);
+		memUpdate.data = data;
 
 		m_CurrentFrame.memoryUpdates.push_back(memUpdate);
 	}
@@ -2,12 +2,15 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/FileUtil.h"
 #include "Common/MathUtil.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/UCodes/UCode_AX.h"
+#include "Core/HW/DSPHLE/UCodes/UCode_AX_Mix.h"
 
 #define AX_GC
 #include "Core/HW/DSPHLE/UCodes/UCode_AX_Voice.h"
@@ -23,6 +26,7 @@ CUCode_AX::CUCode_AX(DSPHLE* dsp_hle, u32 crc)
 	DSP::GenerateDSPInterruptFromDSPEmu(DSP::INT_DSP);
 
 	LoadResamplingCoefficients();
+	AXMix::Init();
 
 	// DSP HLE on thread is always disabled because it causes audio
 	// issues/glitching (different timing characteristics). m_run_on_thread is
@@ -421,16 +425,13 @@ void CUCode_AX::DownloadAndMixWithVolume(u32 addr, u16 vol_main, u16 vol_auxa, u
 	for (u32 i = 0; i < 3; ++i)
 	{
 		int* ptr = (int*)HLEMemory_Get_Pointer(addr);
-		u16 volume = volumes[i];
+		u16 volume_ramp[5 * 32];
+		std::fill_n(volume_ramp, 5 * 32, volumes[i]);
 		for (u32 j = 0; j < 3; ++j)
 		{
 			int* buffer = buffers[i][j];
-			for (u32 k = 0; k < 5 * 32; ++k)
-			{
-				s64 sample = (s64)(s32)Common::swap32(*ptr++);
-				sample *= volume;
-				buffer[k] += (s32)(sample >> 15);
-			}
+			AXMix::AddSwappedWithVolume(buffer, ptr, volume_ramp, 5 * 32);
+			ptr += 5 * 32;
 		}
 	}
 }
@@ -504,32 +505,26 @@ void CUCode_AX::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
 	{
 		int* ptr = (int*)HLEMemory_Get_Pointer(write_addr);
 		for (auto& buffer : buffers)
-			for (u32 j = 0; j < 5 * 32; ++j)
-				*ptr++ = Common::swap32(buffer[j]);
+		{
+			AXMix::CopySwapped(ptr, buffer, 5 * 32);
+			ptr += 5 * 32;
+		}
 	}
 
 	// Then, we read the new temp from the CPU and add to our current
 	// temp.
 	int* ptr = (int*)HLEMemory_Get_Pointer(read_addr);
-	for (auto& sample : m_samples_left)
-		sample += (int)Common::swap32(*ptr++);
-	for (auto& sample : m_samples_right)
-		sample += (int)Common::swap32(*ptr++);
-	for (auto& sample : m_samples_surround)
-		sample += (int)Common::swap32(*ptr++);
+	AXMix::AddSwapped(m_samples_left, ptr, 5 * 32);
+	AXMix::AddSwapped(m_samples_right, ptr + 5 * 32, 5 * 32);
+	AXMix::AddSwapped(m_samples_surround, ptr + 2 * 5 * 32, 5 * 32);
 }
 
 void CUCode_AX::UploadLRS(u32 dst_addr)
 {
-	int buffers[3][5 * 32];
-
-	for (u32 i = 0; i < 5 * 32; ++i)
-	{
-		buffers[0][i] = Common::swap32(m_samples_left[i]);
-		buffers[1][i] = Common::swap32(m_samples_right[i]);
-		buffers[2][i] = Common::swap32(m_samples_surround[i]);
-	}
-	memcpy(HLEMemory_Get_Pointer(dst_addr), buffers, sizeof (buffers));
+	int* ptr = (int*)HLEMemory_Get_Pointer(dst_addr);
+	AXMix::CopySwapped(ptr, m_samples_left, 5 * 32);
+	AXMix::CopySwapped(ptr + 5 * 32, m_samples_right, 5 * 32);
+	AXMix::CopySwapped(ptr + 2 * 5 * 32, m_samples_surround, 5 * 32);
 }
 
 void CUCode_AX::SetMainLR(u32 src_addr)
@@ -546,54 +541,26 @@ void CUCode_AX::SetMainLR(u32 src_addr)
 
 void CUCode_AX::OutputSamples(u32 lr_addr, u32 surround_addr)
 {
-	int surround_buffer[5 * 32];
-
-	for (u32 i = 0; i < 5 * 32; ++i)
-		surround_buffer[i] = Common::swap32(m_samples_surround[i]);
-	memcpy(HLEMemory_Get_Pointer(surround_addr), surround_buffer, sizeof (surround_buffer));
-
-	// 32 samples per ms, 5 ms, 2 channels
-	short buffer[5 * 32 * 2];
+	AXMix::CopySwapped((int*)HLEMemory_Get_Pointer(surround_addr), m_samples_surround, 5 * 32);
 
 	// Output samples clamped to 16 bits and interlaced RLRLRLRLRL...
-	for (u32 i = 0; i < 5 * 32; ++i)
-	{
-		int left  = m_samples_left[i];
-		int right = m_samples_right[i];
-
-		MathUtil::Clamp(&left, -32767, 32767);
-		MathUtil::Clamp(&right, -32767, 32767);
-
-		buffer[2 * i + 0] = Common::swap16(right);
-		buffer[2 * i + 1] = Common::swap16(left);
-	}
-
-	memcpy(HLEMemory_Get_Pointer(lr_addr), buffer, sizeof (buffer));
+	// 32 samples per ms, 5 ms, 2 channels
+	AXMix::OutputLR((s16*)HLEMemory_Get_Pointer(lr_addr), m_samples_left, m_samples_right, 5 * 32);
 }
 
 void CUCode_AX::MixAUXBLR(u32 ul_addr, u32 dl_addr)
 {
 	// Upload AUXB L/R
 	int* ptr = (int*)HLEMemory_Get_Pointer(ul_addr);
-	for (auto& sample : m_samples_auxB_left)
-		*ptr++ = Common::swap32(sample);
-	for (auto& sample : m_samples_auxB_right)
-		*ptr++ = Common::swap32(sample);
+	AXMix::CopySwapped(ptr, m_samples_auxB_left, 5 * 32);
+	AXMix::CopySwapped(ptr + 5 * 32, m_samples_auxB_right, 5 * 32);
 
 	// Mix AUXB L/R to MAIN L/R, and replace AUXB L/R
 	ptr = (int*)HLEMemory_Get_Pointer(dl_addr);
-	for (u32 i = 0; i < 5 * 32; ++i)
-	{
-		int samp = Common::swap32(*ptr++);
-		m_samples_auxB_left[i] = samp;
-		m_samples_left[i] += samp;
-	}
-	for (u32 i = 0; i < 5 * 32; ++i)
-	{
-		int samp = Common::swap32(*ptr++);
-		m_samples_auxB_right[i] = samp;
-		m_samples_right[i] += samp;
-	}
+	AXMix::CopySwapped(m_samples_auxB_left, ptr, 5 * 32);
+	AXMix::AddSwapped(m_samples_left, ptr, 5 * 32);
+	AXMix::CopySwapped(m_samples_auxB_right, ptr + 5 * 32, 5 * 32);
+	AXMix::AddSwapped(m_samples_right, ptr + 5 * 32, 5 * 32);
 }
 
 void CUCode_AX::SetOppositeLR(u32 src_addr)
@@ -621,13 +588,14 @@ void CUCode_AX::SendAUXAndMix(u32 main_auxa_up, u32 auxb_s_up, u32 main_l_dl,
 	// Upload AUXA LRS
 	int* ptr = (int*)HLEMemory_Get_Pointer(main_auxa_up);
 	for (auto& up_buffer : up_buffers)
-		for (u32 j = 0; j < 32 * 5; ++j)
-			*ptr++ = Common::swap32(up_buffer[j]);
+	{
+		AXMix::CopySwapped(ptr, up_buffer, 32 * 5);
+		ptr += 32 * 5;
+	}
 
 	// Upload AUXB S
 	ptr = (int*)HLEMemory_Get_Pointer(auxb_s_up);
-	for (auto& sample : m_samples_auxB_surround)
-		*ptr++ = Common::swap32(sample);
+	AXMix::CopySwapped(ptr, m_samples_auxB_surround, 32 * 5);
 
 	// Download buffers and addresses
 	int* dl_buffers[] = {
@@ -647,8 +615,7 @@ void CUCode_AX::SendAUXAndMix(u32 main_auxa_up, u32 auxb_s_up, u32 main_l_dl,
 	for (u32 i = 0; i < sizeof (dl_buffers) / sizeof (dl_buffers[0]); ++i)
 	{
 		int* dl_src = (int*)HLEMemory_Get_Pointer(dl_addrs[i]);
-		for (u32 j = 0; j < 32 * 5; ++j)
-			dl_buffers[i][j] += (int)Common::swap32(*dl_src++);
+		AXMix::AddSwapped(dl_buffers[i], dl_src, 32 * 5);
 	}
 }
 
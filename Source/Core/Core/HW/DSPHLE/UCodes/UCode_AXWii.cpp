@@ -10,6 +10,7 @@
 
 #include "Core/HW/DSPHLE/MailHandler.h"
 
+#include "Core/HW/DSPHLE/UCodes/UCode_AX_Mix.h"
 #include "Core/HW/DSPHLE/UCodes/UCode_AX_Voice.h"
 #include "Core/HW/DSPHLE/UCodes/UCode_AXStructs.h"
 #include "Core/HW/DSPHLE/UCodes/UCode_AXWii.h"
@@ -526,19 +527,19 @@ void CUCode_AXWii::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr, u16
 	{
 		int* ptr = (int*)HLEMemory_Get_Pointer(write_addr);
 		for (auto& buffer : buffers)
-			for (u32 j = 0; j < 3 * 32; ++j)
-				*ptr++ = Common::swap32(buffer[j]);
+		{
+			AXMix::CopySwapped(ptr, buffer, 3 * 32);
+			ptr += 3 * 32;
+		}
 	}
 
 	// Then read the buffers from the CPU and add to our main buffers.
 	int* ptr = (int*)HLEMemory_Get_Pointer(read_addr);
 	for (auto& main_buffer : main_buffers)
-		for (u32 j = 0; j < 3 * 32; ++j)
-		{
-			s64 sample = (s64)(s32)Common::swap32(*ptr++);
-			sample *= volume_ramp[j];
-			main_buffer[j] += (s32)(sample >> 15);
-		}
+	{
+		AXMix::AddSwappedWithVolume(main_buffer, ptr, volume_ramp, 3 * 32);
+		ptr += 3 * 32;
+	}
 }
 
 void CUCode_AXWii::UploadAUXMixLRSC(int aux_id, u32* addresses, u16 volume)
@@ -549,16 +550,12 @@ void CUCode_AXWii::UploadAUXMixLRSC(int aux_id, u32* addresses, u16 volume)
 	int* auxc_buffer = aux_id ? m_samples_auxC_surround : m_samples_auxC_right;
 
 	int* upload_ptr = (int*)HLEMemory_Get_Pointer(addresses[0]);
-	for (u32 i = 0; i < 96; ++i)
-		*upload_ptr++ = Common::swap32(aux_left[i]);
-	for (u32 i = 0; i < 96; ++i)
-		*upload_ptr++ = Common::swap32(aux_right[i]);
-	for (u32 i = 0; i < 96; ++i)
-		*upload_ptr++ = Common::swap32(aux_surround[i]);
+	AXMix::CopySwapped(upload_ptr, aux_left, 96);
+	AXMix::CopySwapped(upload_ptr + 96, aux_right, 96);
+	AXMix::CopySwapped(upload_ptr + 2 * 96, aux_surround, 96);
 
 	upload_ptr = (int*)HLEMemory_Get_Pointer(addresses[1]);
-	for (u32 i = 0; i < 96; ++i)
-		*upload_ptr++ = Common::swap32(auxc_buffer[i]);
+	AXMix::CopySwapped(upload_ptr, auxc_buffer, 96);
 
 	u16 volume_ramp[96];
 	GenerateVolumeRamp(volume_ramp, m_last_aux_volumes[aux_id], volume, 96);
@@ -573,15 +570,8 @@ void CUCode_AXWii::UploadAUXMixLRSC(int aux_id, u32* addresses, u16 volume)
 	for (u32 mix_i = 0; mix_i < 4; ++mix_i)
 	{
 		int* dl_ptr = (int*)HLEMemory_Get_Pointer(addresses[2 + mix_i]);
-		for (u32 i = 0; i < 96; ++i)
-			aux_left[i] = Common::swap32(dl_ptr[i]);
-
-		for (u32 i = 0; i < 96; ++i)
-		{
-			s64 sample = (s64)(s32)aux_left[i];
-			sample *= volume_ramp[i];
-			mix_dest[mix_i][i] += (s32)(sample >> 15);
-		}
+		AXMix::CopySwapped(aux_left, dl_ptr, 96);
+		AXMix::AddSwappedWithVolume(mix_dest[mix_i], dl_ptr, volume_ramp, 96);
 	}
 }
 
@@ -592,22 +582,14 @@ void CUCode_AXWii::OutputSamples(u32 lr_addr, u32 surround_addr, u16 volume,
 	GenerateVolumeRamp(volume_ramp, m_last_main_volume, volume, 96);
 	m_last_main_volume = volume;
 
-	int upload_buffer[3 * 32] = { 0 };
-
-	for (u32 i = 0; i < 3 * 32; ++i)
-		upload_buffer[i] = Common::swap32(m_samples_surround[i]);
-	memcpy(HLEMemory_Get_Pointer(surround_addr), upload_buffer, sizeof (upload_buffer));
+	AXMix::CopySwapped((int*)HLEMemory_Get_Pointer(surround_addr), m_samples_surround, 3 * 32);
 
 	if (upload_auxc)
 	{
-		surround_addr += sizeof (upload_buffer);
-		for (u32 i = 0; i < 3 * 32; ++i)
-			upload_buffer[i] = Common::swap32(m_samples_auxC_left[i]);
-		memcpy(HLEMemory_Get_Pointer(surround_addr), upload_buffer, sizeof (upload_buffer));
+		surround_addr += 3 * 32 * sizeof (int);
+		AXMix::CopySwapped((int*)HLEMemory_Get_Pointer(surround_addr), m_samples_auxC_left, 3 * 32);
 	}
 
-	short buffer[3 * 32 * 2];
-
 	// Clamp internal buffers to 16 bits.
 	for (u32 i = 0; i < 3 * 32; ++i)
 	{
@@ -625,13 +607,7 @@ void CUCode_AXWii::OutputSamples(u32 lr_addr, u32 surround_addr, u16 volume,
 		m_samples_right[i] = right;
 	}
 
-	for (u32 i = 0; i < 3 * 32; ++i)
-	{
-		buffer[2 * i] = Common::swap16(m_samples_right[i]);
-		buffer[2 * i + 1] = Common::swap16(m_samples_left[i]);
-	}
-
-	memcpy(HLEMemory_Get_Pointer(lr_addr), buffer, sizeof (buffer));
+	AXMix::OutputLR((s16*)HLEMemory_Get_Pointer(lr_addr), m_samples_left, m_samples_right, 3 * 32);
 
 	// There should be a DSP_SYNC message sent here. However, it looks like not
 	// sending it does not cause any issue, and sending it actually causes some
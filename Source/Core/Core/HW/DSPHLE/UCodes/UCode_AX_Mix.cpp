@@ -0,0 +1,249 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include "Common/Common.h"
+#include "Common/CPUDetect.h"
+#include "Common/MathUtil.h"
+#include "Core/HW/DSPHLE/UCodes/UCode_AX_Mix.h"
+
+#if (defined(_M_X64) || defined(_M_IX86)) && !defined(_M_GENERIC)
+#define AXMIX_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AXMix
+{
+
+static void MixAdd_Generic(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
+{
+	u16& volume = pvol[0];
+	u16 volume_delta = pvol[1];
+
+	// If volume ramping is disabled, set volume_delta to 0. That way, the
+	// mixing loop can avoid testing if volume ramping is enabled at each step,
+	// and just add volume_delta.
+	if (!ramp)
+		volume_delta = 0;
+
+	for (u32 i = 0; i < count; ++i)
+	{
+		s64 sample = input[i];
+		sample *= volume;
+		sample >>= 15;
+
+		out[i] += (s16)sample;
+		volume += volume_delta;
+
+		*dpop = (s16)sample;
+	}
+}
+
+static void CopySwapped_Generic(int* dst, const int* src, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+		dst[i] = Common::swap32(src[i]);
+}
+
+static void AddSwapped_Generic(int* dst, const int* src_be, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+		dst[i] += (int)Common::swap32(src_be[i]);
+}
+
+static void AddSwappedWithVolume_Generic(int* dst, const int* src_be, const u16* volume, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		s64 sample = (s64)(s32)Common::swap32(src_be[i]);
+		sample *= volume[i];
+		dst[i] += (s32)(sample >> 15);
+	}
+}
+
+static void OutputLR_Generic(s16* out_be, const int* left, const int* right, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		int l = left[i];
+		int r = right[i];
+
+		MathUtil::Clamp(&l, -32767, 32767);
+		MathUtil::Clamp(&r, -32767, 32767);
+
+		out_be[2 * i + 0] = Common::swap16(r);
+		out_be[2 * i + 1] = Common::swap16(l);
+	}
+}
+
+#ifdef AXMIX_SSE2
+
+static inline __m128i Swap16_SSE2(__m128i v)
+{
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static inline __m128i Swap32_SSE2(__m128i v)
+{
+	v = Swap16_SSE2(v);
+	v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+	return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// High 16 bits of a * b for signed a and unsigned b. _mm_mulhi_epi16 sees b
+// as b - 0x10000 when its top bit is set, which takes a off the result.
+static inline __m128i MulhiSignedUnsigned_SSE2(__m128i a, __m128i b)
+{
+	__m128i hi = _mm_mulhi_epi16(a, b);
+	return _mm_add_epi16(hi, _mm_and_si128(a, _mm_srai_epi16(b, 15)));
+}
+
+// (s32)(((s64)x * v) >> 15) for four s32 x and u16 v, the latter stored in the
+// low half of each 32-bit lane. Splits x in its signed high and unsigned low
+// halves: x * v == (xh * v) << 16 + xl * v, and the shift distributes since
+// both parts are exact multiples of 2^15 or positive.
+static inline __m128i MulVolume32_SSE2(__m128i x, __m128i v)
+{
+	const __m128i low_mask = _mm_set1_epi32(0xFFFF);
+	__m128i vv = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+
+	__m128i lo = _mm_mullo_epi16(x, vv);
+	__m128i hi_u = _mm_mulhi_epu16(x, vv);
+	__m128i hi_s = MulhiSignedUnsigned_SSE2(x, vv);
+
+	// xl * v as u32, xh * v as s32
+	__m128i low_part = _mm_or_si128(_mm_and_si128(lo, low_mask), _mm_slli_epi32(hi_u, 16));
+	__m128i high_part = _mm_or_si128(_mm_srli_epi32(lo, 16), _mm_andnot_si128(low_mask, hi_s));
+
+	return _mm_add_epi32(_mm_slli_epi32(high_part, 1), _mm_srli_epi32(low_part, 15));
+}
+
+static void MixAdd_SSE2(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
+{
+	u16 volume = pvol[0];
+	u16 volume_delta = ramp ? pvol[1] : 0;
+	u32 i = 0;
+
+	if (count >= 8)
+	{
+		// Volumes of the next 8 samples, wrapping around like the u16 they are.
+		__m128i vol = _mm_add_epi16(_mm_set1_epi16(volume),
+		                            _mm_mullo_epi16(_mm_set1_epi16(volume_delta), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7)));
+		__m128i vol_step = _mm_set1_epi16((u16)(volume_delta * 8));
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i in = _mm_loadu_si128((const __m128i*)(input + i));
+
+			// 32-bit products, then (s16)(product >> 15)
+			__m128i lo = _mm_mullo_epi16(in, vol);
+			__m128i hi = MulhiSignedUnsigned_SSE2(in, vol);
+			__m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+			__m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+			p0 = _mm_srai_epi32(_mm_slli_epi32(p0, 16), 16);
+			p1 = _mm_srai_epi32(_mm_slli_epi32(p1, 16), 16);
+
+			__m128i* dst = (__m128i*)(out + i);
+			_mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), p0));
+			_mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), p1));
+
+			vol = _mm_add_epi16(vol, vol_step);
+		}
+		volume += volume_delta * i;
+	}
+
+	for (; i < count; ++i)
+	{
+		out[i] += (s16)(((s32)input[i] * volume) >> 15);
+		volume += volume_delta;
+	}
+
+	if (count)
+		*dpop = (s16)(((s32)input[count - 1] * (u16)(volume - volume_delta)) >> 15);
+	pvol[0] = volume;
+}
+
+static void CopySwapped_SSE2(int* dst, const int* src, u32 count)
+{
+	u32 i = 0;
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_si128((__m128i*)(dst + i), Swap32_SSE2(_mm_loadu_si128((const __m128i*)(src + i))));
+	CopySwapped_Generic(dst + i, src + i, count - i);
+}
+
+static void AddSwapped_SSE2(int* dst, const int* src_be, u32 count)
+{
+	u32 i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i s = Swap32_SSE2(_mm_loadu_si128((const __m128i*)(src_be + i)));
+		__m128i* d = (__m128i*)(dst + i);
+		_mm_storeu_si128(d, _mm_add_epi32(_mm_loadu_si128(d), s));
+	}
+	AddSwapped_Generic(dst + i, src_be + i, count - i);
+}
+
+static void AddSwappedWithVolume_SSE2(int* dst, const int* src_be, const u16* volume, u32 count)
+{
+	u32 i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i s = Swap32_SSE2(_mm_loadu_si128((const __m128i*)(src_be + i)));
+		__m128i v = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(volume + i)), _mm_setzero_si128());
+		__m128i* d = (__m128i*)(dst + i);
+		_mm_storeu_si128(d, _mm_add_epi32(_mm_loadu_si128(d), MulVolume32_SSE2(s, v)));
+	}
+	AddSwappedWithVolume_Generic(dst + i, src_be + i, volume + i, count - i);
+}
+
+static void OutputLR_SSE2(s16* out_be, const int* left, const int* right, u32 count)
+{
+	// Saturating to 16 bits and then raising -32768 to -32767 is the same as
+	// clamping to [-32767, 32767].
+	const __m128i min_sample = _mm_set1_epi16(-32767);
+	u32 i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i l = _mm_packs_epi32(_mm_loadu_si128((const __m128i*)(left + i)),
+		                            _mm_loadu_si128((const __m128i*)(left + i + 4)));
+		__m128i r = _mm_packs_epi32(_mm_loadu_si128((const __m128i*)(right + i)),
+		                            _mm_loadu_si128((const __m128i*)(right + i + 4)));
+		l = _mm_max_epi16(l, min_sample);
+		r = _mm_max_epi16(r, min_sample);
+
+		__m128i* dst = (__m128i*)(out_be + 2 * i);
+		_mm_storeu_si128(dst, Swap16_SSE2(_mm_unpacklo_epi16(r, l)));
+		_mm_storeu_si128(dst + 1, Swap16_SSE2(_mm_unpackhi_epi16(r, l)));
+	}
+	OutputLR_Generic(out_be + 2 * i, left + i, right + i, count - i);
+}
+
+#endif
+
+void (*MixAdd)(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp) = MixAdd_Generic;
+void (*CopySwapped)(int* dst, const int* src, u32 count) = CopySwapped_Generic;
+void (*AddSwapped)(int* dst, const int* src_be, u32 count) = AddSwapped_Generic;
+void (*AddSwappedWithVolume)(int* dst, const int* src_be, const u16* volume, u32 count) = AddSwappedWithVolume_Generic;
+void (*OutputLR)(s16* out_be, const int* left, const int* right, u32 count) = OutputLR_Generic;
+
+void Init()
+{
+	MixAdd = MixAdd_Generic;
+	CopySwapped = CopySwapped_Generic;
+	AddSwapped = AddSwapped_Generic;
+	AddSwappedWithVolume = AddSwappedWithVolume_Generic;
+	OutputLR = OutputLR_Generic;
+
+#ifdef AXMIX_SSE2
+	if (cpu_info.bSSE2)
+	{
+		MixAdd = MixAdd_SSE2;
+		CopySwapped = CopySwapped_SSE2;
+		AddSwapped = AddSwapped_SSE2;
+		AddSwappedWithVolume = AddSwappedWithVolume_SSE2;
+		OutputLR = OutputLR_SSE2;
+	}
+#endif
+}
+
+}
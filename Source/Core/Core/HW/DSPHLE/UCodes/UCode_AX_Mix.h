@@ -0,0 +1,39 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Mixing primitives shared by AX GC and AX Wii. Each one has a plain C++
+// version and SIMD versions picked at runtime by Init() according to
+// cpu_info. All versions give bit-identical results.
+//
+// Buffers suffixed with _be hold big endian 32-bit samples, as found in the
+// emulated RAM.
+namespace AXMix
+{
+
+// Selects the implementations matching the host CPU.
+void Init();
+
+// Adds <input> scaled by a volume to <out>, with optional volume ramping.
+// pvol[0] is the current volume, updated on return, and pvol[1] the ramp
+// delta. The last mixed sample is stored to <dpop>.
+extern void (*MixAdd)(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp);
+
+// dst[i] = swap32(src[i]). Works both for uploading and downloading.
+extern void (*CopySwapped)(int* dst, const int* src, u32 count);
+
+// dst[i] += swap32(src_be[i])
+extern void (*AddSwapped)(int* dst, const int* src_be, u32 count);
+
+// dst[i] += (swap32(src_be[i]) * volume[i]) >> 15
+extern void (*AddSwappedWithVolume)(int* dst, const int* src_be, const u16* volume, u32 count);
+
+// Clamps left and right to 16 bits, and writes them interleaved RLRL... as big
+// endian samples to <out_be>.
+extern void (*OutputLR)(s16* out_be, const int* left, const int* right, u32 count);
+
+}
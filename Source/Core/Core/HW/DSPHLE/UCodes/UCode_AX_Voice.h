@@ -12,13 +12,14 @@
 #error UCode_AX_Voice.h included without specifying version
 #endif
 
-#include <functional>
+#include <vector>
 
 #include "Common/Common.h"
 #include "Common/MathUtil.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/DSPHLE/UCodes/UCode_AX.h"
+#include "Core/HW/DSPHLE/UCodes/UCode_AX_Mix.h"
 #include "Core/HW/DSPHLE/UCodes/UCode_AXStructs.h"
 
 #ifdef AX_GC
@@ -249,9 +250,47 @@ u16 AcceleratorGetSample()
 	return ret;
 }
 
-// Reads samples from the input callback, resamples them to <count> samples at
+// Reads <count> samples from the simulated accelerator into <out>.
+void AcceleratorGetSamples(s16* out, u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		// Once a non looping voice ended, only 0000 samples come out and the
+		// accelerator state does not change anymore.
+		if (acc_end_reached)
+		{
+			memset(out + i, 0, (count - i) * sizeof (s16));
+			return;
+		}
+		out[i] = AcceleratorGetSample();
+	}
+}
+
+// Returns the number of input samples ResampleAudio consumes to produce
+// <count> output samples from the same parameters.
+u32 ResampleInputCount(u32 count, u32 curr_pos, u32 ratio, int srctype)
+{
+	if (srctype != SRCTYPE_LINEAR && srctype != SRCTYPE_POLYPHASE)
+		return count;
+
+	u32 input_count = 0;
+	for (u32 i = 0; i < count; ++i)
+	{
+		curr_pos += ratio;
+		input_count += curr_pos >> 16;
+		curr_pos &= 0xFFFF;
+	}
+	return input_count;
+}
+
+// Reads samples from the input buffer, resamples them to <count> samples at
 // the wanted sample rate (computed from the ratio, see below).
 //
+// <input> holds 4 free entries, followed by the samples to resample. There
+// must be at least ResampleInputCount(count, curr_pos, ratio, srctype) of
+// them. The free entries are filled with <last_samples>, so the whole
+// interpolation history is one contiguous buffer.
+//
 // If srctype is SRCTYPE_POLYPHASE, coefficients need to be provided as well
 // (or the srctype will automatically be changed to LINEAR).
 //
@@ -269,11 +308,12 @@ u16 AcceleratorGetSample()
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count,
+u32 ResampleAudio(s16* input, s16* output, u32 count,
                   s16* last_samples, u32 curr_pos, u32 ratio, int srctype,
                   const s16* coeffs)
 {
-	int read_samples_count = 0;
+	// Index in <input> of the oldest of the last four samples read.
+	u32 pos = 0;
 
 	// TODO(delroth): find out why the polyphase resampling algorithm causes
 	// audio glitches in Wii games with non integral ratios.
@@ -281,69 +321,41 @@ u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count
 	// If DSP DROM coefficients are available, support polyphase resampling.
 	if (0) // if (coeffs && srctype == SRCTYPE_POLYPHASE)
 	{
-		s16 temp[4];
-		u32 idx = 0;
-
-		temp[idx++ & 3] = last_samples[0];
-		temp[idx++ & 3] = last_samples[1];
-		temp[idx++ & 3] = last_samples[2];
-		temp[idx++ & 3] = last_samples[3];
+		memcpy(input, last_samples, 4 * sizeof (s16));
 
 		for (u32 i = 0; i < count; ++i)
 		{
 			curr_pos += ratio;
-			while (curr_pos >= 0x10000)
-			{
-				temp[idx++ & 3] = input_callback(read_samples_count++);
-				curr_pos -= 0x10000;
-			}
+			pos += curr_pos >> 16;
+			curr_pos &= 0xFFFF;
 
-			u16 curr_pos_frac = ((curr_pos & 0xFFFF) >> 9) << 2;
+			u16 curr_pos_frac = (curr_pos >> 9) << 2;
 			const s16* c = &coeffs[curr_pos_frac];
+			const s16* t = &input[pos];
 
-			s64 t0 = temp[idx++ & 3];
-			s64 t1 = temp[idx++ & 3];
-			s64 t2 = temp[idx++ & 3];
-			s64 t3 = temp[idx++ & 3];
-
-			s64 samp = (t0 * c[0] + t1 * c[1] + t2 * c[2] + t3 * c[3]) >> 15;
+			s64 samp = ((s64)t[0] * c[0] + (s64)t[1] * c[1] + (s64)t[2] * c[2] + (s64)t[3] * c[3]) >> 15;
 
 			output[i] = (s16)samp;
 		}
 
-		last_samples[3] = temp[--idx & 3];
-		last_samples[2] = temp[--idx & 3];
-		last_samples[1] = temp[--idx & 3];
-		last_samples[0] = temp[--idx & 3];
+		memcpy(last_samples, &input[pos], 4 * sizeof (s16));
 	}
 	else if (srctype == SRCTYPE_LINEAR || srctype == SRCTYPE_POLYPHASE)
 	{
-		// This is the circular buffer containing samples to use for the
-		// interpolation. It is initialized with the values from the PB, and it
-		// will be stored back to the PB at the end.
-		s16 temp[4];
-		u32 idx = 0;
-
-		temp[idx++ & 3] = last_samples[0];
-		temp[idx++ & 3] = last_samples[1];
-		temp[idx++ & 3] = last_samples[2];
-		temp[idx++ & 3] = last_samples[3];
+		// The last four samples of the previous frame come first, new samples
+		// follow them. They are stored back to the PB at the end.
+		memcpy(input, last_samples, 4 * sizeof (s16));
 
 		for (u32 i = 0; i < count; ++i)
 		{
+			// Move forward by the integer part of our current position.
 			curr_pos += ratio;
-
-			// While our current position is >= 1.0, push new samples to the
-			// circular buffer.
-			while (curr_pos >= 0x10000)
-			{
-				temp[idx++ & 3] = input_callback(read_samples_count++);
-				curr_pos -= 0x10000;
-			}
+			pos += curr_pos >> 16;
+			curr_pos &= 0xFFFF;
 
 			// Get our current fractional position, used to know how much of
 			// curr0 and how much of curr1 the output sample should be.
-			u16 curr_frac = curr_pos & 0xFFFF;
+			u16 curr_frac = curr_pos;
 			u16 inv_curr_frac = -curr_frac;
 
 			// Interpolate! If curr_frac is 0, we can simply take the last
@@ -351,40 +363,37 @@ u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count
 			s16 sample;
 			if (curr_frac)
 			{
-				s32 s0 = temp[idx++ & 3];
-				s32 s1 = temp[idx++ & 3];
+				s32 s0 = input[pos];
+				s32 s1 = input[pos + 1];
 
 				sample = ((s0 * inv_curr_frac) + (s1 * curr_frac)) >> 16;
-				idx += 2;
 			}
 			else
 			{
-				sample = temp[idx++ & 3];
-				idx += 3;
+				sample = input[pos];
 			}
 
 			output[i] = sample;
 		}
 
 		// Update the four last_samples values.
-		last_samples[3] = temp[--idx & 3];
-		last_samples[2] = temp[--idx & 3];
-		last_samples[1] = temp[--idx & 3];
-		last_samples[0] = temp[--idx & 3];
+		memcpy(last_samples, &input[pos], 4 * sizeof (s16));
 	}
 	else // SRCTYPE_NEAREST
 	{
-		// No sample rate conversion here: simply read samples from the
-		// accelerator to the output buffer.
-		for (u32 i = 0; i < count; ++i)
-			output[i] = input_callback(i);
-
-		memcpy(last_samples, output + count - 4, 4 * sizeof (u16));
+		// No sample rate conversion here: simply copy the input samples to the
+		// output buffer.
+		memcpy(output, input + 4, count * sizeof (s16));
+		memcpy(last_samples, output + count - 4, 4 * sizeof (s16));
 	}
 
 	return curr_pos;
 }
 
+// Input buffer for GetInputSamples, only grows. Most voices need less than
+// a few frames worth of samples, but the ratio is not bounded.
+std::vector<s16> input_buffer;
+
 // Read <count> input samples from ARAM, decoding and converting rate
 // if required.
 void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
@@ -394,10 +403,17 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 
 	if (coeffs)
 		coeffs += pb.coef_select * 0x200;
-	u32 curr_pos = ResampleAudio([](u32) { return AcceleratorGetSample(); },
-	                             samples, count, pb.src.last_samples,
-	                             pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio),
-	                             pb.src_type, coeffs);
+
+	// Decode all the samples the resampler needs for this frame at once,
+	// then resample from memory.
+	u32 ratio = HILO_TO_32(pb.src.ratio);
+	u32 input_count = ResampleInputCount(count, pb.src.cur_addr_frac, ratio, pb.src_type);
+	if (input_buffer.size() < input_count + 4)
+		input_buffer.resize(input_count + 4);
+	AcceleratorGetSamples(&input_buffer[4], input_count);
+
+	u32 curr_pos = ResampleAudio(&input_buffer[0], samples, count, pb.src.last_samples,
+	                             pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
 	pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
 	// Update current position in the PB.
@@ -405,31 +421,6 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 	pb.audio_addr.cur_addr_lo = (u16)(cur_addr & 0xFFFF);
 }
 
-// Add samples to an output buffer, with optional volume ramping.
-void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
-{
-	u16& volume = pvol[0];
-	u16 volume_delta = pvol[1];
-
-	// If volume ramping is disabled, set volume_delta to 0. That way, the
-	// mixing loop can avoid testing if volume ramping is enabled at each step,
-	// and just add volume_delta.
-	if (!ramp)
-		volume_delta = 0;
-
-	for (u32 i = 0; i < count; ++i)
-	{
-		s64 sample = input[i];
-		sample *= volume;
-		sample >>= 15;
-
-		out[i] += (s16)sample;
-		volume += volume_delta;
-
-		*dpop = (s16)sample;
-	}
-}
-
 // Execute a low pass filter on the samples using one history value. Returns
 // the new history value.
 s16 LowPassFilter(s16* samples, u32 count, s16 yn1, u16 a0, u16 b0)
@@ -473,33 +464,33 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
 #define RAMP_ON(C) (0 != (mctrl & MIX_##C##_RAMP))
 
 	if (MIX_ON(L))
-		MixAdd(buffers.left, samples, count, &pb.mixer.left, &pb.dpop.left, RAMP_ON(L));
+		AXMix::MixAdd(buffers.left, samples, count, &pb.mixer.left, &pb.dpop.left, RAMP_ON(L));
 	if (MIX_ON(R))
-		MixAdd(buffers.right, samples, count, &pb.mixer.right, &pb.dpop.right, RAMP_ON(R));
+		AXMix::MixAdd(buffers.right, samples, count, &pb.mixer.right, &pb.dpop.right, RAMP_ON(R));
 	if (MIX_ON(S))
-		MixAdd(buffers.surround, samples, count, &pb.mixer.surround, &pb.dpop.surround, RAMP_ON(S));
+		AXMix::MixAdd(buffers.surround, samples, count, &pb.mixer.surround, &pb.dpop.surround, RAMP_ON(S));
 
 	if (MIX_ON(AUXA_L))
-		MixAdd(buffers.auxA_left, samples, count, &pb.mixer.auxA_left, &pb.dpop.auxA_left, RAMP_ON(AUXA_L));
+		AXMix::MixAdd(buffers.auxA_left, samples, count, &pb.mixer.auxA_left, &pb.dpop.auxA_left, RAMP_ON(AUXA_L));
 	if (MIX_ON(AUXA_R))
-		MixAdd(buffers.auxA_right, samples, count, &pb.mixer.auxA_right, &pb.dpop.auxA_right, RAMP_ON(AUXA_R));
+		AXMix::MixAdd(buffers.auxA_right, samples, count, &pb.mixer.auxA_right, &pb.dpop.auxA_right, RAMP_ON(AUXA_R));
 	if (MIX_ON(AUXA_S))
-		MixAdd(buffers.auxA_surround, samples, count, &pb.mixer.auxA_surround, &pb.dpop.auxA_surround, RAMP_ON(AUXA_S));
+		AXMix::MixAdd(buffers.auxA_surround, samples, count, &pb.mixer.auxA_surround, &pb.dpop.auxA_surround, RAMP_ON(AUXA_S));
 
 	if (MIX_ON(AUXB_L))
-		MixAdd(buffers.auxB_left, samples, count, &pb.mixer.auxB_left, &pb.dpop.auxB_left, RAMP_ON(AUXB_L));
+		AXMix::MixAdd(buffers.auxB_left, samples, count, &pb.mixer.auxB_left, &pb.dpop.auxB_left, RAMP_ON(AUXB_L));
 	if (MIX_ON(AUXB_R))
-		MixAdd(buffers.auxB_right, samples, count, &pb.mixer.auxB_right, &pb.dpop.auxB_right, RAMP_ON(AUXB_R));
+		AXMix::MixAdd(buffers.auxB_right, samples, count, &pb.mixer.auxB_right, &pb.dpop.auxB_right, RAMP_ON(AUXB_R));
 	if (MIX_ON(AUXB_S))
-		MixAdd(buffers.auxB_surround, samples, count, &pb.mixer.auxB_surround, &pb.dpop.auxB_surround, RAMP_ON(AUXB_S));
+		AXMix::MixAdd(buffers.auxB_surround, samples, count, &pb.mixer.auxB_surround, &pb.dpop.auxB_surround, RAMP_ON(AUXB_S));
 
 #ifdef AX_WII
 	if (MIX_ON(AUXC_L))
-		MixAdd(buffers.auxC_left, samples, count, &pb.mixer.auxC_left, &pb.dpop.auxC_left, RAMP_ON(AUXC_L));
+		AXMix::MixAdd(buffers.auxC_left, samples, count, &pb.mixer.auxC_left, &pb.dpop.auxC_left, RAMP_ON(AUXC_L));
 	if (MIX_ON(AUXC_R))
-		MixAdd(buffers.auxC_right, samples, count, &pb.mixer.auxC_right, &pb.dpop.auxC_right, RAMP_ON(AUXC_R));
+		AXMix::MixAdd(buffers.auxC_right, samples, count, &pb.mixer.auxC_right, &pb.dpop.auxC_right, RAMP_ON(AUXC_R));
 	if (MIX_ON(AUXC_S))
-		MixAdd(buffers.auxC_surround, samples, count, &pb.mixer.auxC_surround, &pb.dpop.auxC_surround, RAMP_ON(AUXC_S));
+		AXMix::MixAdd(buffers.auxC_surround, samples, count, &pb.mixer.auxC_surround, &pb.dpop.auxC_surround, RAMP_ON(AUXC_S));
 #endif
 
 #undef MIX_ON
@@ -523,8 +514,9 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
 
 		// We use ratio 0x55555 == (5 * 65536 + 21845) / 65536 == 5.3333 which
 		// is the nearest we can get to 96/18
-		u32 curr_pos = ResampleAudio([&samples](u32 i) { return samples[i]; },
-		                             wm_samples, wm_count, pb.remote_src.last_samples,
+		s16 wm_input[4 + MAX_SAMPLES_PER_FRAME];
+		memcpy(wm_input + 4, samples, count * sizeof (s16));
+		u32 curr_pos = ResampleAudio(wm_input, wm_samples, wm_count, pb.remote_src.last_samples,
 		                             pb.remote_src.cur_addr_frac, 0x55555,
 		                             SRCTYPE_POLYPHASE, coeffs);
 		pb.remote_src.cur_addr_frac = curr_pos & 0xFFFF;
@@ -534,21 +526,21 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
 #define WMCHAN_MIX_RAMP(n) (0 != ((pb.remote_mixer_control >> (2 * n)) & 2))
 
 		if (WMCHAN_MIX_ON(0))
-			MixAdd(buffers.wm_main0, wm_samples, wm_count, &pb.remote_mixer.main0, &pb.remote_dpop.main0, WMCHAN_MIX_RAMP(0));
+			AXMix::MixAdd(buffers.wm_main0, wm_samples, wm_count, &pb.remote_mixer.main0, &pb.remote_dpop.main0, WMCHAN_MIX_RAMP(0));
 		if (WMCHAN_MIX_ON(1))
-			MixAdd(buffers.wm_aux0, wm_samples, wm_count, &pb.remote_mixer.aux0, &pb.remote_dpop.aux0, WMCHAN_MIX_RAMP(1));
+			AXMix::MixAdd(buffers.wm_aux0, wm_samples, wm_count, &pb.remote_mixer.aux0, &pb.remote_dpop.aux0, WMCHAN_MIX_RAMP(1));
 		if (WMCHAN_MIX_ON(2))
-			MixAdd(buffers.wm_main1, wm_samples, wm_count, &pb.remote_mixer.main1, &pb.remote_dpop.main1, WMCHAN_MIX_RAMP(2));
+			AXMix::MixAdd(buffers.wm_main1, wm_samples, wm_count, &pb.remote_mixer.main1, &pb.remote_dpop.main1, WMCHAN_MIX_RAMP(2));
 		if (WMCHAN_MIX_ON(3))
-			MixAdd(buffers.wm_aux1, wm_samples, wm_count, &pb.remote_mixer.aux1, &pb.remote_dpop.aux1, WMCHAN_MIX_RAMP(3));
+			AXMix::MixAdd(buffers.wm_aux1, wm_samples, wm_count, &pb.remote_mixer.aux1, &pb.remote_dpop.aux1, WMCHAN_MIX_RAMP(3));
 		if (WMCHAN_MIX_ON(4))
-			MixAdd(buffers.wm_main2, wm_samples, wm_count, &pb.remote_mixer.main2, &pb.remote_dpop.main2, WMCHAN_MIX_RAMP(4));
+			AXMix::MixAdd(buffers.wm_main2, wm_samples, wm_count, &pb.remote_mixer.main2, &pb.remote_dpop.main2, WMCHAN_MIX_RAMP(4));
 		if (WMCHAN_MIX_ON(5))
-			MixAdd(buffers.wm_aux2, wm_samples, wm_count, &pb.remote_mixer.aux2, &pb.remote_dpop.aux2, WMCHAN_MIX_RAMP(5));
+			AXMix::MixAdd(buffers.wm_aux2, wm_samples, wm_count, &pb.remote_mixer.aux2, &pb.remote_dpop.aux2, WMCHAN_MIX_RAMP(5));
 		if (WMCHAN_MIX_ON(6))
-			MixAdd(buffers.wm_main3, wm_samples, wm_count, &pb.remote_mixer.main3, &pb.remote_dpop.main3, WMCHAN_MIX_RAMP(6));
+			AXMix::MixAdd(buffers.wm_main3, wm_samples, wm_count, &pb.remote_mixer.main3, &pb.remote_dpop.main3, WMCHAN_MIX_RAMP(6));
 		if (WMCHAN_MIX_ON(7))
-			MixAdd(buffers.wm_aux3, wm_samples, wm_count, &pb.remote_mixer.aux3, &pb.remote_dpop.aux3, WMCHAN_MIX_RAMP(7));
+			AXMix::MixAdd(buffers.wm_aux3, wm_samples, wm_count, &pb.remote_mixer.aux3, &pb.remote_dpop.aux3, WMCHAN_MIX_RAMP(7));
 	}
 #undef WMCHAN_MIX_RAMP
 #undef WMCHAN_MIX_ON
@@ -45,6 +45,9 @@ void CEXIMemoryCard::CmdDoneCallback(u64 userdata, int cyclesLate)
 CEXIMemoryCard::CEXIMemoryCard(const int index)
 	: card_index(index)
 	, m_bDirty(false)
+	, flushBusy(false)
+	, flushStop(false)
+	, flushFailed(false)
 {
 	m_strFilename = (card_index == 0) ? SConfig::GetInstance().m_strMemoryCardA : SConfig::GetInstance().m_strMemoryCardB;
 	if (Movie::IsPlayingInput() && Movie::IsConfigSaved() && Movie::IsUsingMemcard() && Movie::IsStartingFromClearSave())
@@ -100,63 +103,134 @@ CEXIMemoryCard::CEXIMemoryCard(const int index)
 		WARN_LOG(EXPANSIONINTERFACE, "No memory card found. Will create a new one.");
 	}
 	SetCardFlashID(memory_card_content, card_index);
+
+	dirty_blocks.assign((memory_card_size + BLOCK_SIZE - 1) / BLOCK_SIZE, false);
+	flushThread = std::thread(&CEXIMemoryCard::FlushThread, this);
 }
 
-void innerFlush(FlushData* data)
+void CEXIMemoryCard::MarkDirty(u32 offset, u32 size)
 {
-	File::IOFile pFile(data->filename, "r+b");
-	if (!pFile)
-	{
-		std::string dir;
-		SplitPath(data->filename, &dir, 0, 0);
-		if (!File::IsDirectory(dir))
-			File::CreateFullPath(dir);
-		pFile.Open(data->filename, "wb");
-	}
+	for (u32 block = offset / BLOCK_SIZE; block <= (offset + size - 1) / BLOCK_SIZE && block < dirty_blocks.size(); ++block)
+		dirty_blocks[block] = true;
+}
 
-	if (!pFile) // Note - pFile changed inside above if
+void CEXIMemoryCard::FlushThread()
+{
+	Common::SetCurrentThreadName(card_index ? "Memcard B flush thread" : "Memcard A flush thread");
+
+	std::unique_lock<std::mutex> lk(flushMutex);
+	while (true)
 	{
-		PanicAlertT("Could not write memory card file %s.\n\n"
-			"Are you running Dolphin from a CD/DVD, or is the save file maybe write protected?\n\n"
-			"Are you receiving this after moving the emulator directory?\nIf so, then you may "
-			"need to re-specify your memory card location in the options.", data->filename.c_str());
-		return;
-	}
+		flushCondition.wait(lk, [this]{ return flushStop || !flushQueue.empty(); });
+		if (flushQueue.empty())
+			return;
+
+		// Everything queued since the last batch goes out with a single fsync.
+		std::deque<FlushData> batch;
+		batch.swap(flushQueue);
+		flushBusy = true;
+		lk.unlock();
+
+		File::IOFile pFile(m_strFilename, "r+b");
+		if (!pFile)
+		{
+			std::string dir;
+			SplitPath(m_strFilename, &dir, 0, 0);
+			if (!File::IsDirectory(dir))
+				File::CreateFullPath(dir);
+			pFile.Open(m_strFilename, "wb");
+		}
 
-	pFile.WriteBytes(data->memcardContent, data->memcardSize);
+		bool exiting = false;
+		if (pFile) // Note - pFile changed inside above if
+		{
+			for (const FlushData& data : batch)
+			{
+				for (const auto& block : data.blocks)
+				{
+					pFile.Seek(block.first, SEEK_SET);
+					pFile.WriteBytes(block.second.data(), block.second.size());
+				}
+				exiting |= data.bExiting;
+			}
+			pFile.Sync();
+		}
+
+		if (!pFile)
+		{
+			PanicAlertT("Could not write memory card file %s.\n\n"
+				"Are you running Dolphin from a CD/DVD, or is the save file maybe write protected?\n\n"
+				"Are you receiving this after moving the emulator directory?\nIf so, then you may "
+				"need to re-specify your memory card location in the options.", m_strFilename.c_str());
+		}
+		else if (!exiting)
+		{
+			Core::DisplayMessage(StringFromFormat("Wrote memory card %c contents to %s",
+				card_index ? 'B' : 'A', m_strFilename.c_str()).c_str(), 4000);
+		}
+
+		lk.lock();
+		if (!pFile)
+			flushFailed = true;
+		flushBusy = false;
+		flushCondition.notify_all();
+	}
+}
 
-	if (!data->bExiting)
-		Core::DisplayMessage(StringFromFormat("Wrote memory card %c contents to %s",
-			data->memcardIndex ? 'B' : 'A', data->filename.c_str()).c_str(), 4000);
-	return;
+void CEXIMemoryCard::WaitForFlush()
+{
+	std::unique_lock<std::mutex> lk(flushMutex);
+	flushCondition.wait(lk, [this]{ return flushQueue.empty() && !flushBusy; });
 }
 
 // Flush memory card contents to disc
 void CEXIMemoryCard::Flush(bool exiting)
 {
-	if(!m_bDirty)
-		return;
-
 	if (!Core::g_CoreStartupParameter.bEnableMemcardSaving)
 		return;
 
-	if (flushThread.joinable())
+	// The blocks of a failed batch are no longer marked dirty, and later
+	// batches only hold newer blocks, so write out the whole card again.
 	{
-		flushThread.join();
+		std::lock_guard<std::mutex> lk(flushMutex);
+		if (flushFailed)
+		{
+			flushFailed = false;
+			MarkDirty(0, memory_card_size);
+			m_bDirty = true;
+		}
 	}
 
+	if(!m_bDirty)
+		return;
+
 	if(!exiting)
 		Core::DisplayMessage(StringFromFormat("Writing to memory card %c", card_index ? 'B' : 'A'), 1000);
 
-	flushData.filename = m_strFilename;
-	flushData.memcardContent = memory_card_content;
-	flushData.memcardIndex = card_index;
-	flushData.memcardSize = memory_card_size;
-	flushData.bExiting = exiting;
+	// A new or deleted file needs the whole card.
+	if (!File::Exists(m_strFilename))
+		MarkDirty(0, memory_card_size);
+
+	// The game keeps writing to the card while the thread is busy, so it gets copies.
+	FlushData data;
+	data.bExiting = exiting;
+	for (u32 block = 0; block < dirty_blocks.size(); ++block)
+	{
+		if (!dirty_blocks[block])
+			continue;
+		u32 offset = block * BLOCK_SIZE;
+		u8 *start = memory_card_content + offset;
+		data.blocks.push_back(std::make_pair(offset, std::vector<u8>(start, start + std::min<u32>(BLOCK_SIZE, memory_card_size - offset))));
+		dirty_blocks[block] = false;
+	}
 
-	flushThread = std::thread(innerFlush, &flushData);
+	{
+		std::lock_guard<std::mutex> lk(flushMutex);
+		flushQueue.push_back(std::move(data));
+	}
+	flushCondition.notify_all();
 	if (exiting)
-		flushThread.join();
+		WaitForFlush();
 
 	m_bDirty = false;
 }
@@ -165,13 +239,16 @@ CEXIMemoryCard::~CEXIMemoryCard()
 {
 	CoreTiming::RemoveEvent(et_this_card);
 	Flush(true);
-	delete[] memory_card_content;
-	memory_card_content = NULL;
 
-	if (flushThread.joinable())
 	{
-		flushThread.join();
+		std::lock_guard<std::mutex> lk(flushMutex);
+		flushStop = true;
 	}
+	flushCondition.notify_all();
+	flushThread.join();
+
+	delete[] memory_card_content;
+	memory_card_content = NULL;
 }
 
 bool CEXIMemoryCard::IsPresent()
@@ -196,12 +273,6 @@ void CEXIMemoryCard::CmdDoneLater(u64 cycles)
 
 void CEXIMemoryCard::SetCS(int cs)
 {
-	// So that memory card won't be invalidated during flushing
-	if (flushThread.joinable())
-	{
-		flushThread.join();
-	}
-
 	if (cs)  // not-selected to selected
 	{
 		m_uPosition = 0;
@@ -214,6 +285,7 @@ void CEXIMemoryCard::SetCS(int cs)
 			if (m_uPosition > 2)
 			{
 				memset(memory_card_content + (address & (memory_card_size-1)), 0xFF, 0x2000);
+				MarkDirty(address & (memory_card_size-1), 0x2000);
 				status |= MC_STATUS_BUSY;
 				status &= ~MC_STATUS_READY;
 
@@ -227,6 +299,7 @@ void CEXIMemoryCard::SetCS(int cs)
 			if (m_uPosition > 2)
 			{
 				memset(memory_card_content, 0xFF, memory_card_size);
+				MarkDirty(0, memory_card_size);
 				status &= ~MC_STATUS_BUSY;
 				m_bDirty = true;
 			}
@@ -238,6 +311,7 @@ void CEXIMemoryCard::SetCS(int cs)
 				int count = m_uPosition - 5;
 				int i=0;
 				status &= ~0x80;
+				MarkDirty(address & ~0x1FF, 0x200);
 
 				while (count--)
 				{
@@ -443,11 +517,8 @@ void CEXIMemoryCard::PauseAndLock(bool doLock, bool unpauseOnUnlock)
 	if (doLock)
 	{
 		// we don't exactly have anything to pause,
-		// but let's make sure the flush thread isn't running.
-		if (flushThread.joinable())
-		{
-			flushThread.join();
-		}
+		// but let's make sure the flush thread isn't writing.
+		WaitForFlush();
 	}
 }
 
@@ -476,6 +547,9 @@ void CEXIMemoryCard::DoState(PointerWrap &p)
 		p.Do(memory_card_size);
 		p.DoArray(memory_card_content, memory_card_size);
 		p.Do(card_index);
+
+		if (p.GetMode() == PointerWrap::MODE_READ)
+			MarkDirty(0, memory_card_size);
 	}
 }
 
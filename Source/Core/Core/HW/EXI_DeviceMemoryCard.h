@@ -4,15 +4,17 @@
 
 #pragma once
 
+#include <deque>
+#include <utility>
+#include <vector>
+
 #include "Common/Thread.h"
 
-// Data structure to be passed to the flushing thread.
+// Copies of the blocks which changed since the previous flush, for the flushing thread.
 struct FlushData
 {
 	bool bExiting;
-	std::string filename;
-	u8 *memcardContent;
-	int memcardSize, memcardIndex;
+	std::vector<std::pair<u32, std::vector<u8>>> blocks;  // offset, contents
 };
 
 class CEXIMemoryCard : public IEXIDevice
@@ -36,9 +38,18 @@ private:
 	// Scheduled when a command that required delayed end signaling is done.
 	static void CmdDoneCallback(u64 userdata, int cyclesLate);
 
-	// Flushes the memory card contents to disk.
+	// Flushes the changed blocks of the memory card to disk.
 	void Flush(bool exiting = false);
 
+	// Remembers the blocks touched by a write or an erase for the next flush.
+	void MarkDirty(u32 offset, u32 size);
+
+	// Writes the queued flushes, a batch at a time with one fsync each.
+	void FlushThread();
+
+	// Waits until the flushing thread has written everything queued so far.
+	void WaitForFlush();
+
 	// Signals that the command that was previously executed is now done.
 	void CmdDone();
 
@@ -64,6 +75,9 @@ private:
 		cmdChipErase        = 0xF4,
 	};
 
+	// Granularity of the dirty tracking, the size of an erasable sector.
+	enum { BLOCK_SIZE = 0x2000 };
+
 	std::string m_strFilename;
 	int card_index;
 	int et_this_card, et_cmd_done;
@@ -84,8 +98,15 @@ private:
 	int memory_card_size; //! in bytes, must be power of 2.
 	u8 *memory_card_content;
 
-	FlushData flushData;
+	std::vector<bool> dirty_blocks;
+
 	std::thread flushThread;
+	std::mutex flushMutex;
+	std::condition_variable flushCondition;  // work queued, a batch written or stopping
+	std::deque<FlushData> flushQueue;
+	bool flushBusy;
+	bool flushStop;
+	bool flushFailed; // a batch didn't make it to disk, so the next flush writes the whole card
 
 protected:
 	virtual void TransferByte(u8 &byte) override;
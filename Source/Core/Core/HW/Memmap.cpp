@@ -8,6 +8,8 @@
 // However, if a JITed instruction (for example lwz) wants to access a bad memory area that call
 // may be redirected here (for example to Read_U32()).
 
+#include <atomic>
+
 #include "Common/ChunkFile.h"
 #include "Common/Common.h"
 #include "Common/MemArena.h"
@@ -15,6 +17,7 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/MemTools.h"
 #include "Core/Debugger/Debugger_SymbolMap.h"
 #include "Core/HLE/HLE.h"
 #include "Core/HW/AudioInterface.h"
@@ -139,6 +142,168 @@ static const MemoryView views[] =
 };
 static const int num_views = sizeof(views) / sizeof(MemoryView);
 
+// Write tracking needs an exception handler which sees faults from every thread,
+// the mach exception port on OS X is only installed for the CPU thread.
+#if defined(_M_X64) && !defined(__APPLE__) && !defined(ANDROID)
+#define HAVE_WRITE_TRACKING
+#endif
+
+enum
+{
+	TRACKING_PAGE_SHIFT = 12,
+	RAM_TRACKING_PAGES  = RAM_SIZE >> TRACKING_PAGE_SHIFT,
+	NUM_TRACKING_PAGES  = (RAM_SIZE + EXRAM_SIZE) >> TRACKING_PAGE_SHIFT,
+};
+
+// Pages are only ever unprotected by bumping their write counter, so the sum of the
+// counters over a range changes whenever one of its pages may have been written.
+static u32 s_page_writes[NUM_TRACKING_PAGES];
+static bool s_page_protected[NUM_TRACKING_PAGES];
+// Host writes in progress per page, which TrackWrites must not protect again.
+static u32 s_host_writes[NUM_TRACKING_PAGES];
+static std::atomic<u64> s_write_generation;
+static volatile bool s_write_tracking_active = false;
+
+// Taken from the fault handler, so it must not be a mutex.
+static std::atomic_flag s_tracking_lock = ATOMIC_FLAG_INIT;
+
+class TrackingLock
+{
+public:
+	TrackingLock()
+	{
+		while (s_tracking_lock.test_and_set(std::memory_order_acquire))
+			Common::YieldCPU();
+	}
+	~TrackingLock() { s_tracking_lock.clear(std::memory_order_release); }
+};
+
+static void GetTrackingViews(u32 page, u8* region_views[4])
+{
+	if (page < RAM_TRACKING_PAGES)
+	{
+		region_views[0] = m_pRAM;
+		region_views[1] = m_pPhysicalRAM;
+		region_views[2] = m_pVirtualCachedRAM;
+		region_views[3] = m_pVirtualUncachedRAM;
+	}
+	else
+	{
+		region_views[0] = m_pEXRAM;
+		region_views[1] = m_pPhysicalEXRAM;
+		region_views[2] = m_pVirtualCachedEXRAM;
+		region_views[3] = m_pVirtualUncachedEXRAM;
+	}
+}
+
+// Changes the protection of pages [first, end), which must not cross from RAM to EXRAM.
+static void ProtectPages(u32 first, u32 end, bool protect)
+{
+	u8* region_views[4];
+	GetTrackingViews(first, region_views);
+	const u32 offset = (first < RAM_TRACKING_PAGES ? first : first - RAM_TRACKING_PAGES) << TRACKING_PAGE_SHIFT;
+	const u32 size = (end - first) << TRACKING_PAGE_SHIFT;
+
+	for (u8* view : region_views)
+	{
+		if (!view)
+			continue;
+		if (protect)
+			WriteProtectMemory(view + offset, size, false);
+		else
+			UnWriteProtectMemory(view + offset, size, false);
+	}
+}
+
+// Lifts the protection of the given pages and counts them as written.
+// Must be called with the tracking lock held.
+static void UnprotectPages(u32 first, u32 end)
+{
+	u32 run_start = end;
+	for (u32 page = first; page < end; ++page)
+	{
+		if (s_page_protected[page])
+		{
+			if (run_start == end)
+				run_start = page;
+			s_page_protected[page] = false;
+			s_page_writes[page]++;
+		}
+		else if (run_start != end)
+		{
+			ProtectPages(run_start, page, false);
+			run_start = end;
+		}
+	}
+	if (run_start != end)
+		ProtectPages(run_start, end, false);
+	s_write_generation++;
+}
+
+static void UnprotectAllPages()
+{
+	if (!s_write_tracking_active)
+		return;
+	TrackingLock lock;
+	UnprotectPages(0, RAM_TRACKING_PAGES);
+	UnprotectPages(RAM_TRACKING_PAGES, NUM_TRACKING_PAGES);
+}
+
+// Maps a guest range to tracking pages, returns false unless it lies entirely in RAM or EXRAM.
+static bool GetTrackingPages(u32 address, u32 size, u32* first, u32* end)
+{
+	u32 region_size, region_first;
+	switch (address >> 28)
+	{
+	case 0x0:
+	case 0x8:
+	case 0xc:
+		region_size = REALRAM_SIZE;
+		region_first = 0;
+		break;
+	case 0x1:
+	case 0x9:
+	case 0xd:
+		if (!SConfig::GetInstance().m_LocalCoreStartupParameter.bWii)
+			return false;
+		region_size = EXRAM_SIZE;
+		region_first = RAM_TRACKING_PAGES;
+		break;
+	default:
+		return false;
+	}
+
+	const u32 offset = address & 0x0FFFFFFF;
+	if (size == 0 || offset >= region_size || size > region_size - offset)
+		return false;
+
+	*first = region_first + (offset >> TRACKING_PAGE_SHIFT);
+	*end = region_first + ((offset + size - 1) >> TRACKING_PAGE_SHIFT) + 1;
+	return true;
+}
+
+// Returns the tracking page of a host address in any of the RAM or EXRAM views.
+static bool GetHostTrackingPage(uintptr_t host_address, u32* page)
+{
+	static const u32 region_first[2] = {0, RAM_TRACKING_PAGES};
+	static const uintptr_t region_size[2] = {RAM_SIZE, EXRAM_SIZE};
+
+	for (int i = 0; i < 2; i++)
+	{
+		u8* region_views[4];
+		GetTrackingViews(region_first[i], region_views);
+		for (u8* view : region_views)
+		{
+			if (view && host_address - (uintptr_t)view < region_size[i])
+			{
+				*page = region_first[i] + (u32)((host_address - (uintptr_t)view) >> TRACKING_PAGE_SHIFT);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 void Init()
 {
 	bool wii = SConfig::GetInstance().m_LocalCoreStartupParameter.bWii;
@@ -165,6 +330,8 @@ void Init()
 void DoState(PointerWrap &p)
 {
 	bool wii = SConfig::GetInstance().m_LocalCoreStartupParameter.bWii;
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		UnprotectAllPages();
 	p.DoArray(m_pPhysicalRAM, RAM_SIZE);
 	//p.DoArray(m_pVirtualEFB, EFB_SIZE);
 	p.DoArray(m_pVirtualL1Cache, L1_CACHE_SIZE);
@@ -180,6 +347,7 @@ void DoState(PointerWrap &p)
 void Shutdown()
 {
 	m_IsInitialized = false;
+	UnprotectAllPages();
 	u32 flags = 0;
 	if (SConfig::GetInstance().m_LocalCoreStartupParameter.bWii) flags |= MV_WII_ONLY;
 	if (bFakeVMEM) flags |= MV_FAKE_VMEM;
@@ -192,6 +360,7 @@ void Shutdown()
 
 void Clear()
 {
+	UnprotectAllPages();
 	if (m_pRAM)
 		memset(m_pRAM, 0, RAM_SIZE);
 	if (m_pL1Cache)
@@ -234,6 +403,134 @@ void Memset(const u32 _Address, const u8 _iValue, const u32 _iLength)
 	}
 }
 
+bool TrackWrites(const u32 _Address, const u32 _iSize, u64* generation, u64* write_count)
+{
+#ifdef HAVE_WRITE_TRACKING
+	u32 first, end;
+	if (!m_IsInitialized || !GetTrackingPages(_Address, _iSize, &first, &end))
+		return false;
+
+	if (!s_write_tracking_active)
+	{
+		EMM::InstallExceptionHandler();
+		s_write_tracking_active = true;
+	}
+
+	// Read before protecting: anything written in between is still seen by the caller's hash.
+	*generation = s_write_generation;
+
+	TrackingLock lock;
+	// A fault inside the host write would fail it instead of reaching the handler.
+	for (u32 page = first; page < end; ++page)
+	{
+		if (s_host_writes[page])
+			return false;
+	}
+
+	u64 sum = 0;
+	u32 run_start = end;
+	for (u32 page = first; page < end; ++page)
+	{
+		if (!s_page_protected[page])
+		{
+			if (run_start == end)
+				run_start = page;
+			s_page_protected[page] = true;
+		}
+		else if (run_start != end)
+		{
+			ProtectPages(run_start, page, true);
+			run_start = end;
+		}
+		sum += s_page_writes[page];
+	}
+	if (run_start != end)
+		ProtectPages(run_start, end, true);
+
+	*write_count = sum;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool HasBeenWritten(const u32 _Address, const u32 _iSize, u64* generation, const u64 write_count)
+{
+	const u64 current_generation = s_write_generation;
+	if (*generation == current_generation)
+		return false;
+
+	u32 first, end;
+	if (!GetTrackingPages(_Address, _iSize, &first, &end))
+		return true;
+
+	u64 sum = 0;
+	{
+		TrackingLock lock;
+		for (u32 page = first; page < end; ++page)
+			sum += s_page_writes[page];
+	}
+	if (sum != write_count)
+		return true;
+
+	*generation = current_generation;
+	return false;
+}
+
+// Maps a host range to tracking pages, returns false unless it lies entirely in one view.
+static bool GetHostTrackingPages(const void* ptr, const size_t size, u32* first, u32* end)
+{
+	u32 last;
+	if (size == 0 ||
+		!GetHostTrackingPage((uintptr_t)ptr, first) ||
+		!GetHostTrackingPage((uintptr_t)ptr + size - 1, &last) ||
+		(*first < RAM_TRACKING_PAGES) != (last < RAM_TRACKING_PAGES))
+		return false;
+	*end = last + 1;
+	return true;
+}
+
+void BeginHostWrite(const void* ptr, const size_t size)
+{
+	u32 first, end;
+	if (!GetHostTrackingPages(ptr, size, &first, &end))
+		return;
+
+	TrackingLock lock;
+	for (u32 page = first; page < end; ++page)
+		s_host_writes[page]++;
+	UnprotectPages(first, end);
+}
+
+void EndHostWrite(const void* ptr, const size_t size)
+{
+	u32 first, end;
+	if (!GetHostTrackingPages(ptr, size, &first, &end))
+		return;
+
+	// Whoever snapshotted the counters while the write was running has to look again.
+	TrackingLock lock;
+	for (u32 page = first; page < end; ++page)
+	{
+		s_host_writes[page]--;
+		s_page_writes[page]++;
+	}
+	s_write_generation++;
+}
+
+bool HandleWriteFault(const uintptr_t host_address)
+{
+	u32 page;
+	if (!s_write_tracking_active || !GetHostTrackingPage(host_address, &page))
+		return false;
+
+	TrackingLock lock;
+	// If the page isn't protected anymore another thread got here first, so just retry.
+	if (s_page_protected[page])
+		UnprotectPages(page, page + 1);
+	return true;
+}
+
 void DMA_LCToMemory(const u32 _MemAddr, const u32 _CacheAddr, const u32 _iNumBlocks)
 {
 	const u8 *src = GetCachePtr() + (_CacheAddr & 0x3FFFF);
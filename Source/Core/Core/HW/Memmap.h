@@ -158,6 +158,21 @@ void DMA_LCToMemory(const u32 _iMemAddr, const u32 _iCacheAddr, const u32 _iNumB
 void DMA_MemoryToLC(const u32 _iCacheAddr, const u32 _iMemAddr, const u32 _iNumBlocks);
 void Memset(const u32 _Address, const u8 _Data, const u32 _iLength);
 
+// Write tracking, used by the texture cache to skip hashing data which wasn't touched.
+// TrackWrites write protects the host pages behind a RAM/EXRAM range in all views and
+// returns a snapshot of their write counters, or false if the range (or the platform)
+// can't be tracked. HasBeenWritten compares against such a snapshot; generation is a
+// cheap global check which it refreshes when the range turns out to be clean.
+bool TrackWrites(const u32 _Address, const u32 _iSize, u64* generation, u64* write_count);
+bool HasBeenWritten(const u32 _Address, const u32 _iSize, u64* generation, const u64 write_count);
+// Must surround host writes to guest memory which can't take a page fault, e.g.
+// passing a guest pointer to fread or recv. In between, TrackWrites fails for the
+// range instead of protecting it again.
+void BeginHostWrite(const void* ptr, const size_t size);
+void EndHostWrite(const void* ptr, const size_t size);
+// Called by the exception handler, returns true if the fault was a write to a tracked page.
+bool HandleWriteFault(const uintptr_t host_address);
+
 // TLB functions
 void SDRUpdated();
 enum XCheckTLBFlag
@@ -169,6 +184,8 @@ enum XCheckTLBFlag
 };
 u32 TranslateAddress(u32 _Address, XCheckTLBFlag _Flag);
 void InvalidateTLBEntry(u32 _Address);
+// Needed whenever translations change for more than a page: SR, SDR1 and BAT writes
+void InvalidateTLB();
 void GenerateDSIException(u32 _EffectiveAdress, bool _bWrite);
 void GenerateISIException(u32 _EffectiveAdress);
 extern u32 pagetable_base;
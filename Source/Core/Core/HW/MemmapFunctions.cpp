@@ -598,167 +598,101 @@ void SDRUpdated()
 }
 
 
-// TLB cache
-//#define FAST_TLB_CACHE
+#define BATU_BEPI(v) ((v)&0xfffe0000)
+#define BATU_BL(v)   (((v)&0x1ffc)>>2)
+#define BATU_Vs      (1<<1)
+#define BATU_Vp      (1)
+#define BATL_BRPN(v) ((v)&0xfffe0000)
 
-#define TLB_SIZE 128
-#define TLB_WAYS 2
-#define NUM_TLBS 2
+#define BAT_EA_OFFSET(v) ((v)&0x1ffff)
+#define BAT_EA_11(v)     ((v)&0x0ffe0000)
+#define BAT_EA_4(v)      ((v)&0xf0000000)
 
-#define HW_PAGE_SIZE 4096
+// TLB cache
 #define HW_PAGE_INDEX_SHIFT 12
-#define HW_PAGE_INDEX_MASK 0x3f
-#define HW_PAGE_TAG_SHIFT 18
-
-#define TLB_FLAG_MOST_RECENT 0x01
-#define TLB_FLAG_INVALID 0x02
 
-typedef struct tlb_entry
+static PowerPC::TLBSet& GetTLBSet(const XCheckTLBFlag _Flag, const u32 vpa)
 {
-	u32 tag;
-	u32 paddr;
-	u8 flags;
-} tlb_entry;
-
-// TODO: tlb needs to be in ppcState for save-state purposes.
-#ifdef FAST_TLB_CACHE
-static tlb_entry tlb[NUM_TLBS][TLB_SIZE/TLB_WAYS][TLB_WAYS];
-#endif
+	const int tlb_index = _Flag == FLAG_OPCODE ? PowerPC::TLB_INDEX_INST : PowerPC::TLB_INDEX_DATA;
+	return PowerPC::ppcState.tlb[tlb_index][(vpa >> HW_PAGE_INDEX_SHIFT) & (PowerPC::TLB_SETS - 1)];
+}
 
-u32 LookupTLBPageAddress(const XCheckTLBFlag _Flag, const u32 vpa, u32 *paddr)
+static bool LookupTLBPageAddress(const XCheckTLBFlag _Flag, const u32 vpa, u32 *paddr)
 {
-#ifdef FAST_TLB_CACHE
-	tlb_entry *tlbe = tlb[_Flag == FLAG_OPCODE][(vpa>>HW_PAGE_INDEX_SHIFT)&HW_PAGE_INDEX_MASK];
-	if(tlbe[0].tag == (vpa & ~0xfff) && !(tlbe[0].flags & TLB_FLAG_INVALID))
-	{
-		tlbe[0].flags |= TLB_FLAG_MOST_RECENT;
-		tlbe[1].flags &= ~TLB_FLAG_MOST_RECENT;
-		*paddr = tlbe[0].paddr | (vpa & 0xfff);
-		return 1;
-	}
-	if(tlbe[1].tag == (vpa & ~0xfff) && !(tlbe[1].flags & TLB_FLAG_INVALID))
+	PowerPC::TLBSet& set = GetTLBSet(_Flag, vpa);
+	const u32 tag = vpa & ~0xfff;
+	for (u32 way = 0; way < PowerPC::TLB_WAYS; way++)
 	{
-		tlbe[1].flags |= TLB_FLAG_MOST_RECENT;
-		tlbe[0].flags &= ~TLB_FLAG_MOST_RECENT;
-		*paddr = tlbe[1].paddr | (vpa & 0xfff);
-		return 1;
-	}
-	return 0;
-#else
-	u32 _Address = vpa;
-	if (_Flag == FLAG_OPCODE)
-	{
-		for (u32 i = (PowerPC::ppcState.itlb_last); i > (PowerPC::ppcState.itlb_last - 128); i--)
+		if (set.tag[way] == tag)
 		{
-			if ((_Address & ~0xfff) == (PowerPC::ppcState.itlb_va[i & 127]))
-			{
-				*paddr = PowerPC::ppcState.itlb_pa[i & 127] | (_Address & 0xfff);
-				PowerPC::ppcState.itlb_last = i;
-				return 1;
-			}
+			set.recent = way;
+			*paddr = set.paddr[way] | (vpa & 0xfff);
+			return true;
 		}
 	}
-	else
-	{
-		for (u32 i = (PowerPC::ppcState.dtlb_last); i > (PowerPC::ppcState.dtlb_last - 128); i--)
-		{
-			if ((_Address & ~0xfff) == (PowerPC::ppcState.dtlb_va[i & 127]))
-			{
-				*paddr = PowerPC::ppcState.dtlb_pa[i & 127] | (_Address & 0xfff);
-				PowerPC::ppcState.dtlb_last = i;
-				return 1;
-			}
-		}
-	}
-	return 0;
-#endif
+	return false;
 }
 
-void UpdateTLBEntry(const XCheckTLBFlag _Flag, UPTE2 PTE2, const u32 vpa)
+// Whether a BAT covers the address in either privilege level. Such pages are
+// never put in the TLB: it is checked before the BATs, and which BATs are valid
+// depends on MSR[PR].
+static bool IsBlockAddressCovered(const u32 addr, const XCheckTLBFlag _Flag)
 {
-#ifdef FAST_TLB_CACHE
-	tlb_entry *tlbe = tlb[_Flag == FLAG_OPCODE][(vpa>>HW_PAGE_INDEX_SHIFT)&HW_PAGE_INDEX_MASK];
-	if((tlbe[0].flags & TLB_FLAG_MOST_RECENT) == 0)
-	{
-		tlbe[0].flags = TLB_FLAG_MOST_RECENT;
-		tlbe[1].flags &= ~TLB_FLAG_MOST_RECENT;
-		tlbe[0].paddr = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
-		tlbe[0].tag = vpa & ~0xfff;
-	}
-	else
-	{
-		tlbe[1].flags = TLB_FLAG_MOST_RECENT;
-		tlbe[0].flags &= ~TLB_FLAG_MOST_RECENT;
-		tlbe[1].paddr = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
-		tlbe[1].tag = vpa & ~0xfff;
-	}
-#else
-	if (_Flag == FLAG_OPCODE)
-	{
-		// ITLB cache
-		PowerPC::ppcState.itlb_last++;
-		PowerPC::ppcState.itlb_last &= 127;
-		PowerPC::ppcState.itlb_pa[PowerPC::ppcState.itlb_last] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
-		PowerPC::ppcState.itlb_va[PowerPC::ppcState.itlb_last] = vpa & ~0xfff;
-	}
-	else
+	const int bats = (Core::g_CoreStartupParameter.bWii && HID4.SBE) ? 8 : 4;
+	const int batu_spr = _Flag == FLAG_OPCODE ? SPR_IBAT0U : SPR_DBAT0U;
+	for (int i = 0; i < bats; i++)
 	{
-		// DTLB cache
-		PowerPC::ppcState.dtlb_last++;
-		PowerPC::ppcState.dtlb_last &= 127;
-		PowerPC::ppcState.dtlb_pa[PowerPC::ppcState.dtlb_last] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
-		PowerPC::ppcState.dtlb_va[PowerPC::ppcState.dtlb_last] = vpa & ~0xfff;
+		const u32 batu = PowerPC::ppcState.spr[batu_spr + i * 2];
+		const u32 bl17 = ~(BATU_BL(batu) << 17);
+		if ((batu & (BATU_Vs | BATU_Vp)) && BATU_BEPI(addr & (bl17 | 0xf001ffff)) == BATU_BEPI(batu))
+			return true;
 	}
-#endif
+	return false;
+}
+
+static void UpdateTLBEntry(const XCheckTLBFlag _Flag, UPTE2 PTE2, const u32 vpa)
+{
+	if (IsBlockAddressCovered(vpa, _Flag))
+		return;
+
+	// Replace the way which wasn't used last
+	PowerPC::TLBSet& set = GetTLBSet(_Flag, vpa);
+	const u32 way = (set.recent + 1) % PowerPC::TLB_WAYS;
+	set.tag[way] = vpa & ~0xfff;
+	set.paddr[way] = PTE2.RPN << HW_PAGE_INDEX_SHIFT;
+	set.recent = way;
 }
 
 void InvalidateTLBEntry(u32 vpa)
 {
-#ifdef FAST_TLB_CACHE
-	tlb_entry *tlbe = tlb[0][(vpa>>HW_PAGE_INDEX_SHIFT)&HW_PAGE_INDEX_MASK];
-	if(tlbe[0].tag == (vpa & ~0xfff))
-	{
-		tlbe[0].flags |= TLB_FLAG_INVALID;
-	}
-	if(tlbe[1].tag == (vpa & ~0xfff))
-	{
-		tlbe[1].flags |= TLB_FLAG_INVALID;
-	}
-	tlb_entry *tlbe_i = tlb[1][(vpa>>HW_PAGE_INDEX_SHIFT)&HW_PAGE_INDEX_MASK];
-	if(tlbe_i[0].tag == (vpa & ~0xfff))
-	{
-		tlbe_i[0].flags |= TLB_FLAG_INVALID;
-	}
-	if(tlbe_i[1].tag == (vpa & ~0xfff))
+	// Like tlbie on the Gekko, this drops the whole set in both TLBs.
+	for (auto& tlb : PowerPC::ppcState.tlb)
 	{
-		tlbe_i[1].flags |= TLB_FLAG_INVALID;
+		PowerPC::TLBSet& set = tlb[(vpa >> HW_PAGE_INDEX_SHIFT) & (PowerPC::TLB_SETS - 1)];
+		for (u32 way = 0; way < PowerPC::TLB_WAYS; way++)
+			set.tag[way] = PowerPC::TLB_TAG_INVALID;
 	}
-#else
-	u32 _Address = vpa;
-	for (int i = 0; i < 128; i++)
+}
+
+void InvalidateTLB()
+{
+	for (auto& tlb : PowerPC::ppcState.tlb)
 	{
-		if ((_Address & ~0xfff) == (PowerPC::ppcState.dtlb_va[(PowerPC::ppcState.dtlb_last + i) & 127]))
-		{
-			PowerPC::ppcState.dtlb_pa[(PowerPC::ppcState.dtlb_last + i) & 127] = 0;
-			PowerPC::ppcState.dtlb_va[(PowerPC::ppcState.dtlb_last + i) & 127] = 0;
-		}
-		if ((_Address & ~0xfff) == (PowerPC::ppcState.itlb_va[(PowerPC::ppcState.itlb_last + i) & 127]))
+		for (PowerPC::TLBSet& set : tlb)
 		{
-			PowerPC::ppcState.itlb_pa[(PowerPC::ppcState.itlb_last + i) & 127] = 0;
-			PowerPC::ppcState.itlb_va[(PowerPC::ppcState.itlb_last + i) & 127] = 0;
+			for (u32 way = 0; way < PowerPC::TLB_WAYS; way++)
+			{
+				set.tag[way] = PowerPC::TLB_TAG_INVALID;
+				set.paddr[way] = 0;
+			}
+			set.recent = 0;
 		}
 	}
-#endif
 }
 
 // Page Address Translation
 u32 TranslatePageAddress(const u32 _Address, const XCheckTLBFlag _Flag)
 {
-	// TLB cache
-	u32 translatedAddress = 0;
-	if (LookupTLBPageAddress(_Flag, _Address, &translatedAddress))
-		return translatedAddress;
-
 	u32 sr = PowerPC::ppcState.sr[EA_SR(_Address)];
 
 	u32 offset = EA_Offset(_Address);        // 12 bit
@@ -835,16 +769,6 @@ u32 TranslatePageAddress(const u32 _Address, const XCheckTLBFlag _Flag)
 	return 0;
 }
 
-#define BATU_BEPI(v) ((v)&0xfffe0000)
-#define BATU_BL(v)   (((v)&0x1ffc)>>2)
-#define BATU_Vs      (1<<1)
-#define BATU_Vp      (1)
-#define BATL_BRPN(v) ((v)&0xfffe0000)
-
-#define BAT_EA_OFFSET(v) ((v)&0x1ffff)
-#define BAT_EA_11(v)     ((v)&0x0ffe0000)
-#define BAT_EA_4(v)      ((v)&0xf0000000)
-
 // Block Address Translation
 u32 TranslateBlockAddress(const u32 addr, const XCheckTLBFlag _Flag)
 {
@@ -913,20 +837,17 @@ u32 TranslateAddress(const u32 _Address, const XCheckTLBFlag _Flag)
 	// Check MSR[DR] bit before translating data addresses
 	//if (((_Flag == FLAG_READ) || (_Flag == FLAG_WRITE)) && !(MSR & (1 << (31 - 27)))) return _Address;
 
-	u32 tlb_addr = TranslateBlockAddress(_Address, _Flag);
+	// Pages only get into the TLB if no BAT covers them in either privilege
+	// level, and it's flushed when the BATs change, so it can be checked first.
+	// Jit64 does the same inline.
+	u32 tlb_addr = 0;
+	if (LookupTLBPageAddress(_Flag, _Address, &tlb_addr))
+		return tlb_addr;
+
+	tlb_addr = TranslateBlockAddress(_Address, _Flag);
 	if (tlb_addr == 0)
-	{
 		tlb_addr = TranslatePageAddress(_Address, _Flag);
-		if (tlb_addr != 0)
-		{
-			return tlb_addr;
-		}
-	}
-	else
-	{
-		return tlb_addr;
-	}
 
-	return 0;
+	return tlb_addr;
 }
 } // namespace
@@ -539,6 +539,7 @@ static void EndField()
 {
 	g_video_backend->Video_EndField();
 	Core::VideoThrottle();
+	State::OnFrameEnd();
 }
 
 // Purpose: Send VI interrupt when triggered
@@ -419,7 +419,10 @@ bool CWII_IPC_HLE_Device_es::IOCtlV(u32 _CommandAddress)
 							ERROR_LOG(WII_IPC_ES, "ES: couldn't seek!");
 						}
 						WARN_LOG(WII_IPC_ES, "2 %p", pFile->GetHandle());
-						if (!pFile->ReadBytes(pDest, Size))
+						Memory::BeginHostWrite(pDest, Size);
+						const bool read = pFile->ReadBytes(pDest, Size);
+						Memory::EndHostWrite(pDest, Size);
+						if (!read)
 						{
 							ERROR_LOG(WII_IPC_ES, "ES: short read; returning uninitialized data!");
 						}
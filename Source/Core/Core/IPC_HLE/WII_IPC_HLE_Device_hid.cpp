@@ -56,6 +56,9 @@ void CWII_IPC_HLE_Device_hid::handleUsbUpdates(struct libusb_transfer *transfer)
 		ret = transfer->length;
 	}
 
+	if (transfer->type == LIBUSB_TRANSFER_TYPE_INTERRUPT && (transfer->endpoint & LIBUSB_ENDPOINT_IN))
+		Memory::EndHostWrite(transfer->buffer, transfer->length);
+
 	Memory::Write_U32(8, replyAddress);
 	// IOS seems to write back the command that was responded to
 	Memory::Write_U32(/*COMMAND_IOCTL*/ 6, replyAddress + 8);
@@ -233,9 +236,15 @@ bool CWII_IPC_HLE_Device_hid::IOCtl(u32 _CommandAddress)
 
 		struct libusb_transfer *transfer = libusb_alloc_transfer(0);
 		transfer->flags |= LIBUSB_TRANSFER_FREE_TRANSFER;
+		// libusb writes incoming data straight into guest memory, until handleUsbUpdates.
+		// It goes by the endpoint for the direction, and so does the callback.
+		const bool incoming = (endpoint & LIBUSB_ENDPOINT_IN) != 0;
+		if (incoming)
+			Memory::BeginHostWrite(Memory::GetPointer(data), length);
 		libusb_fill_interrupt_transfer(transfer, dev_handle, endpoint, Memory::GetPointer(data), length,
 									   handleUsbUpdates, (void*)(size_t)_CommandAddress, 0);
-		libusb_submit_transfer(transfer);
+		if (libusb_submit_transfer(transfer) < 0 && incoming)
+			Memory::EndHostWrite(Memory::GetPointer(data), length);
 
 		//DEBUG_LOG(WII_IPC_HID, "HID::IOCtl(Interrupt %s)(%d,%d,%X) (BufferIn: (%08x, %i), BufferOut: (%08x, %i)",
 		//          Parameter == IOCTL_HID_INTERRUPT_IN ? "In" : "Out", endpoint, length, data, BufferIn, BufferInSize, BufferOut, BufferOutSize);
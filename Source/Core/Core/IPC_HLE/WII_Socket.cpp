@@ -485,9 +485,11 @@ void WiiSocket::update(bool read, bool write, bool except)
 					}
 #endif
 					socklen_t addrlen = sizeof(sockaddr_in);
+					Memory::BeginHostWrite(data, data_len);
 					int ret = recvfrom(fd, data, data_len, flags,
 									BufferOutSize2 ? (struct sockaddr*) &local_name : NULL,
 									BufferOutSize2 ? &addrlen : 0);
+					Memory::EndHostWrite(data, data_len);
 					ReturnValue = WiiSockMan::getNetErrorCode(ret, BufferOutSize2 ? "SO_RECVFROM" : "SO_RECV", true);
 
 					INFO_LOG(WII_IPC_NET, "%s(%d, %p) Socket: %08X, Flags: %08X, "
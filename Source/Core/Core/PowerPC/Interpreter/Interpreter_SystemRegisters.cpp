@@ -176,6 +176,7 @@ void Interpreter::mtmsr(UGeckoInstruction _inst)
 static void SetSR(int index, u32 value) {
 	DEBUG_LOG(POWERPC, "%08x: MMU: Segment register %i set to %08x", PowerPC::ppcState.pc, index, value);
 	PowerPC::ppcState.sr[index] = value;
+	Memory::InvalidateTLB();
 }
 
 void Interpreter::mtsr(UGeckoInstruction _inst)
@@ -368,6 +369,19 @@ void Interpreter::mtspr(UGeckoInstruction _inst)
 	// Page table base etc
 	case SPR_SDR:
 		Memory::SDRUpdated();
+		Memory::InvalidateTLB();
+		break;
+
+	// Translation looks at the BATs before the TLB, so pages which they cover
+	// now mustn't stay in there. HID4 enables the extra Wii BATs.
+	case SPR_HID4:
+		if (oldValue != rSPR(iIndex))
+			Memory::InvalidateTLB();
+		break;
+
+	default:
+		if (iIndex >= SPR_IBAT0U && iIndex < SPR_IBAT0U + 48 && oldValue != rSPR(iIndex))
+			Memory::InvalidateTLB();
 		break;
 	}
 }
@@ -2,6 +2,7 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <map>
 
 // for the PROFILER stuff
@@ -181,6 +182,18 @@ void Jit64::Init()
 
 	blocks.Init();
 	asm_routines.Init();
+
+	if (Core::g_CoreStartupParameter.bJITPersistentCache &&
+	    !Core::g_CoreStartupParameter.bEnableDebugging &&
+	    !Core::g_CoreStartupParameter.bJITNoBlockCache &&
+	    !Core::g_CoreStartupParameter.bMMU)
+	{
+		persistent_cache.Init(Core::g_CoreStartupParameter.GetUniqueID());
+	}
+
+	// The debugger wants the code it asked for, and without a block cache no block lives long enough.
+	profile_branches = !Core::g_CoreStartupParameter.bEnableDebugging &&
+	                   !Core::g_CoreStartupParameter.bJITNoBlockCache;
 }
 
 void Jit64::ClearCache()
@@ -192,6 +205,9 @@ void Jit64::ClearCache()
 
 void Jit64::Shutdown()
 {
+	persistent_cache.Shutdown();
+	branch_hints.clear();
+	profiled_branches.clear();
 	FreeCodeSpace();
 
 	blocks.Shutdown();
@@ -239,6 +255,33 @@ static const bool ImHereDebug = false;
 static const bool ImHereLog = false;
 static std::map<u32, int> been_here;
 
+static void BranchProfileDone(u32 em_address, u32 branch_address)
+{
+	((Jit64 *)jit)->ResolveBranchProfile(em_address, branch_address);
+}
+
+// Only drops the block: this runs from inside its code, which must stay intact
+// until we're back in the dispatcher. Jit() then compiles the address again.
+// Branches without a clear direction keep their block, which stops counting
+// the next time it is compiled.
+void Jit64::ResolveBranchProfile(u32 em_address, u32 branch_address)
+{
+	profiled_branches.insert(branch_address);
+	int block_num = blocks.GetBlockNumberFromStartAddress(em_address);
+	if (block_num < 0)
+		return;
+
+	JitBlock *b = blocks.GetBlock(block_num);
+	int runs = b->runCount - 1;  // This run hasn't got to the branch yet.
+	if (b->takenCount * 8 >= runs * 7)
+		branch_hints[branch_address] = true;
+	else if (b->takenCount * 8 <= runs)
+		branch_hints[branch_address] = false;
+	else
+		return;
+	blocks.DestroyBlock(block_num, false);
+}
+
 static void ImHere()
 {
 	static File::IOFile f;
@@ -276,6 +319,12 @@ void Jit64::Cleanup()
 		ABI_CallFunctionCCC((void *)&PowerPC::UpdatePerformanceMonitor, js.downcountAmount, jit->js.numLoadStoreInst, jit->js.numFloatingPointInst);
 }
 
+// Only blocks compiled while profiling count their trips through the dispatcher.
+void Jit64::JumpToDispatcher()
+{
+	JMP(Profiler::g_ProfileBlocks ? asm_routines.profiledDispatcher : asm_routines.dispatcher, true);
+}
+
 void Jit64::WriteExit(u32 destination)
 {
 	Cleanup();
@@ -300,10 +349,10 @@ void Jit64::WriteExit(u32 destination)
 	else
 	{
 		MOV(32, M(&PC), Imm32(destination));
-		JMP(asm_routines.dispatcher, true);
+		JumpToDispatcher();
 	}
 
-	b->linkData.push_back(linkData);
+	blocks.AddLinkData(b, linkData);
 }
 
 void Jit64::WriteExitDestInEAX()
@@ -311,7 +360,7 @@ void Jit64::WriteExitDestInEAX()
 	MOV(32, M(&PC), R(EAX));
 	Cleanup();
 	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
-	JMP(asm_routines.dispatcher, true);
+	JumpToDispatcher();
 }
 
 void Jit64::WriteRfiExitDestInEAX()
@@ -321,7 +370,7 @@ void Jit64::WriteRfiExitDestInEAX()
 	Cleanup();
 	ABI_CallFunction(reinterpret_cast<void *>(&PowerPC::CheckExceptions));
 	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
-	JMP(asm_routines.dispatcher, true);
+	JumpToDispatcher();
 }
 
 void Jit64::WriteExceptionExit()
@@ -331,7 +380,7 @@ void Jit64::WriteExceptionExit()
 	MOV(32, M(&NPC), R(EAX));
 	ABI_CallFunction(reinterpret_cast<void *>(&PowerPC::CheckExceptions));
 	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
-	JMP(asm_routines.dispatcher, true);
+	JumpToDispatcher();
 }
 
 void Jit64::WriteExternalExceptionExit()
@@ -341,7 +390,7 @@ void Jit64::WriteExternalExceptionExit()
 	MOV(32, M(&NPC), R(EAX));
 	ABI_CallFunction(reinterpret_cast<void *>(&PowerPC::CheckExternalExceptions));
 	SUB(32, M(&CoreTiming::downcount), js.downcountAmount > 127 ? Imm32(js.downcountAmount) : Imm8(js.downcountAmount));
-	JMP(asm_routines.dispatcher, true);
+	JumpToDispatcher();
 }
 
 void STACKALIGN Jit64::Run()
@@ -392,12 +441,73 @@ void STACKALIGN Jit64::Jit(u32 em_address)
 		ClearCache();
 	}
 
+	if (persistent_cache.IsEnabled())
+		PrecompilePersistentBlocks(em_address);
+
 	int block_num = blocks.AllocateBlock(em_address);
 	JitBlock *b = blocks.GetBlock(block_num);
 	blocks.FinalizeBlock(block_num, jo.enableBlocklink, DoJit(em_address, &code_buffer, b));
+
+	if (persistent_cache.IsEnabled() && b->originalSize > 0)
+		persistent_cache.AddBlock(em_address, JitPersistentCache::HashBlock(&code_buffer, b->originalSize));
+}
+
+void Jit64::PrecompilePersistentBlocks(u32 em_address)
+{
+	std::vector<JitPersistentCache::BlockKey> keys;
+	persistent_cache.TakePending(em_address, keys);
+	if (keys.empty())
+		return;
+
+	// Big pages are spread over the next blocks compiled in them instead of
+	// stalling this one. Entries which don't validate are dropped.
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(PRECOMPILE_BUDGET_US);
+	size_t taken = 0;
+	int compiled = 0;
+	// Leave room for the block which triggered the precompilation.
+	while (taken < keys.size() && GetSpaceLeft() >= 0x20000 && !blocks.IsFull() &&
+	       std::chrono::steady_clock::now() < deadline)
+	{
+		if (PrecompileBlock(keys[taken++], em_address))
+			compiled++;
+	}
+	for (size_t i = taken; i < keys.size(); i++)
+		persistent_cache.Defer(keys[i]);
+
+	INFO_LOG(DYNA_REC, "Precompiled %i of %i persistent blocks (PC %08x)", compiled, (int)taken, em_address);
+}
+
+// Compiles a block remembered from an earlier session, provided guest memory
+// still holds the same instructions. Returns false if the entry didn't validate.
+// The instructions are peeked at, as the guest hasn't fetched them yet.
+bool Jit64::PrecompileBlock(const JitPersistentCache::BlockKey& key, u32 em_address)
+{
+	// The block at em_address is compiled right after this.
+	if (key.address == em_address || blocks.GetBlockNumberFromStartAddress(key.address) >= 0)
+		return true;
+
+	if (!Memory::IsRAMAddress(key.address))
+		return false;
+
+	PPCAnalyst::BlockStats st;
+	PPCAnalyst::BlockRegStats gpa, fpa;
+	bool broken_block = false;
+	u32 merged_addresses[32];
+	int size_of_merged_addresses = 0;
+	int size = 0;
+	PPCAnalyst::Flatten(key.address, &size, &st, &gpa, &fpa, broken_block, &code_buffer, code_buffer.GetSize(),
+	                    merged_addresses, sizeof(merged_addresses) / sizeof(merged_addresses[0]), size_of_merged_addresses,
+	                    &branch_hints, true);
+	if (size == 0 || JitPersistentCache::HashBlock(&code_buffer, size) != key.hash)
+		return false;
+
+	int block_num = blocks.AllocateBlock(key.address);
+	JitBlock *b = blocks.GetBlock(block_num);
+	blocks.FinalizeBlock(block_num, jo.enableBlocklink, DoJit(key.address, &code_buffer, b, true));
+	return true;
 }
 
-const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBlock *b)
+const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBlock *b, bool precompile)
 {
 	int blockSize = code_buf->GetSize();
 
@@ -453,7 +563,7 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	if (!memory_exception)
 	{
 		// If there is a memory exception inside a block (broken_block==true), compile up to that instruction.
-		nextPC = PPCAnalyst::Flatten(em_address, &size, &js.st, &js.gpa, &js.fpa, broken_block, code_buf, blockSize, merged_addresses, capacity_of_merged_addresses, size_of_merged_addresses);
+		nextPC = PPCAnalyst::Flatten(em_address, &size, &js.st, &js.gpa, &js.fpa, broken_block, code_buf, blockSize, merged_addresses, capacity_of_merged_addresses, size_of_merged_addresses, &branch_hints, precompile);
 	}
 
 	PPCAnalyst::CodeOp *ops = code_buf->codebuffer;
@@ -461,6 +571,13 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	const u8 *start = AlignCode4(); // TODO: Test if this or AlignCode16 make a difference from GetCodePtr
 	b->checkedEntry = start;
 	b->runCount = 0;
+	b->takenCount = 0;
+
+	// The block profiler shares the run counters.
+	u32 branch_address = size > 0 ? ops[size - 1].address : 0;
+	count_branches = profile_branches && !Profiler::g_ProfileBlocks && size > 0 &&
+	                 ops[size - 1].inst.OPCD == 16 && !ops[size - 1].inst.LK &&
+	                 !branch_hints.count(branch_address) && !profiled_branches.count(branch_address);
 
 	// Downcount flag check. The last block decremented downcounter, and the flag should still be available.
 	FixupBranch skip = J_CC(CC_NBE);
@@ -474,16 +591,36 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	if (ImHereDebug)
 		ABI_CallFunction((void *)&ImHere); //Used to get a trace of the last few blocks before a crash, sometimes VERY useful
 
+	if (count_branches)
+	{
+		// Count the runs of the block, and look at the profile once there are enough.
+#ifdef _M_X64
+		MOV(64, R(RAX), ImmPtr(&b->runCount));
+		ADD(32, MatR(RAX), Imm8(1));
+		CMP(32, MatR(RAX), Imm32(BRANCH_PROFILE_RUNS));
+#else
+		ADD(32, M(&b->runCount), Imm8(1));
+		CMP(32, M(&b->runCount), Imm32(BRANCH_PROFILE_RUNS));
+#endif
+		FixupBranch counting = J_CC(CC_NE);
+		ABI_CallFunctionCC((void *)&BranchProfileDone, js.blockStart, branch_address);
+		MOV(32, M(&PC), Imm32(js.blockStart));
+		JMP(asm_routines.dispatcherNoCheck, true);
+		SetJumpTarget(counting);
+	}
+
 	// Conditionally add profiling code.
 	if (Profiler::g_ProfileBlocks) {
+#ifdef _M_X64
+		// The block array is out of RIP range, nothing is in a register yet at this point.
+		MOV(64, R(RAX), ImmPtr(&b->runCount));
+		ADD(32, MatR(RAX), Imm8(1));
+#else
 		ADD(32, M(&b->runCount), Imm8(1));
-#ifdef _WIN32
+#endif
 		b->ticCounter = 0;
 		b->ticStart = 0;
 		b->ticStop = 0;
-#else
-//TODO
-#endif
 		// get start tic
 		PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
 	}
@@ -632,7 +769,10 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 				SetJumpTarget(noBreakpoint);
 			}
 
+			// Let the register cache drop values which are overwritten before anything reads them
+			gpr.SetLiveRegisters(ops[i].gprInUse);
 			Jit64Tables::CompileInstruction(ops[i]);
+			gpr.SetLiveRegisters(0xFFFFFFFF);
 
 			if (js.memcheck && (opinfo->flags & FL_LOADSTORE))
 			{
@@ -717,6 +857,20 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	b->codeSize = (u32)(GetCodePtr() - normalEntry);
 	b->originalSize = size;
 
+	// Blocks which followed branches have to be invalidated by writes to any
+	// of the places their instructions came from.
+	if (size_of_merged_addresses > 1)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			u32 address = ops[i].address & 0x1FFFFFFF;
+			if (!b->physicalRanges.empty() && b->physicalRanges.back().second + 1 == address)
+				b->physicalRanges.back().second = address + 3;
+			else
+				b->physicalRanges.push_back(std::make_pair(address, address + 3));
+		}
+	}
+
 #ifdef JIT_LOG_X86
 	LogGeneratedX86(size, code_buf, normalEntry, b);
 #endif
@@ -18,6 +18,8 @@
 // ----------
 #pragma once
 
+#include <unordered_set>
+
 #include "Common/x64ABI.h"
 #include "Common/x64Analyzer.h"
 #include "Common/x64Emitter.h"
@@ -36,6 +38,7 @@
 #include "Core/PowerPC/JitCommon/JitBackpatch.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitCommon/JitPersistentCache.h"
 
 class Jit64 : public Jitx86Base
 {
@@ -48,6 +51,24 @@ private:
 	PPCAnalyst::CodeBuffer code_buffer;
 	Jit64AsmRoutineManager asm_routines;
 
+	// Blocks compiled in previous sessions of the running game.
+	JitPersistentCache persistent_cache;
+
+	// How long compiling persistent blocks may hold up a single Jit() call.
+	static const int PRECOMPILE_BUDGET_US = 1000;
+	void PrecompilePersistentBlocks(u32 em_address);
+	bool PrecompileBlock(const JitPersistentCache::BlockKey& key, u32 em_address);
+
+	// Blocks ending in a bcx which hasn't been profiled yet count their runs and
+	// how often the bcx is taken. After BRANCH_PROFILE_RUNS runs, a branch which
+	// mostly goes one way gets a hint, and the block is compiled again as a
+	// superblock following it.
+	static const int BRANCH_PROFILE_RUNS = 64;
+	bool profile_branches;
+	bool count_branches;
+	PPCAnalyst::BranchHints branch_hints;
+	std::unordered_set<u32> profiled_branches;
+
 public:
 	Jit64() : code_buffer(32000) {}
 	~Jit64() {}
@@ -58,7 +79,9 @@ public:
 	// Jit!
 
 	void Jit(u32 em_address) override;
-	const u8* DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buffer, JitBlock *b);
+	const u8* DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buffer, JitBlock *b, bool precompile = false);
+	// Called by blocks counting their final bcx once they ran BRANCH_PROFILE_RUNS times.
+	void ResolveBranchProfile(u32 em_address, u32 branch_address);
 
 	u32 RegistersInUse();
 
@@ -96,6 +119,7 @@ public:
 	void WriteRfiExitDestInEAX();
 	void WriteCallInterpreter(UGeckoInstruction _inst);
 	void Cleanup();
+	void JumpToDispatcher();
 
 	void GenerateConstantOverflow(bool overflow);
 	void GenerateOverflow();
@@ -106,6 +130,11 @@ public:
 	void GenerateRC();
 	void ComputeRC(const Gen::OpArg & arg);
 
+	// Whether the instruction being compiled has to write CR field n or XER[CA],
+	// or if they are overwritten before anything reads them.
+	bool WantsCR(int field) const { return (js.op->wantsCR >> field) & 1; }
+	bool WantsCA() const { return js.op->wantsCA; }
+
 	void tri_op(int d, int a, int b, bool reversible, void (XEmitter::*op)(Gen::X64Reg, Gen::OpArg));
 	typedef u32 (*Operation)(u32 a, u32 b);
 	void regimmop(int d, int a, bool binary, u32 value, Operation doop, void (XEmitter::*op)(int, const Gen::OpArg&, const Gen::OpArg&), bool Rc = false, bool carry = false);
@@ -181,6 +181,14 @@ void Jit64AsmRoutineManager::Generate()
 	ABI_PopAllCalleeSavedRegsAndAdjustStack();
 	RET();
 
+	// MOV and LEA keep the flags of the downcount subtraction for the dispatcher,
+	// and EAX is free since the dispatcher reloads it from PC.
+	profiledDispatcher = AlignCode4();
+	MOV(32, R(EAX), M(&g_dispatcherEntries));
+	LEA(32, EAX, MDisp(EAX, 1));
+	MOV(32, M(&g_dispatcherEntries), R(EAX));
+	JMP(dispatcher, true);
+
 	GenerateCommon();
 }
 
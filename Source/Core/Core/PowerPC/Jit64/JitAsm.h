@@ -27,6 +27,10 @@ private:
 	void GenerateCommon();
 
 public:
+	// Same as dispatcher, but counts g_dispatcherEntries. The exits of blocks
+	// compiled while Profiler::g_ProfileBlocks is set jump here instead.
+	const u8 *profiledDispatcher;
+
 	void Init() {
 		AllocCodeSpace(8192);
 		Generate();
@@ -9,7 +9,7 @@
 using namespace Gen;
 using namespace PowerPC;
 
-RegCache::RegCache() : emit(0)
+RegCache::RegCache() : live(0xFFFFFFFF), emit(0)
 {
 	memset(locks, 0, sizeof(locks));
 	memset(xlocks, 0, sizeof(xlocks));
@@ -34,6 +34,7 @@ void RegCache::Start(PPCAnalyst::BlockRegStats &stats)
 		regs[i].location = GetDefaultLocation(i);
 		regs[i].away = false;
 	}
+	live = 0xFFFFFFFF;
 
 	// todo: sort to find the most popular regs
 	/*
@@ -307,7 +308,7 @@ void GPRRegCache::StoreFromRegister(int i)
 			doStore = true;
 		}
 		OpArg newLoc = GetDefaultLocation(i);
-		if (doStore)
+		if (doStore && (live & (1U << i)))
 			emit->MOV(32, newLoc, regs[i].location);
 		regs[i].location = newLoc;
 		regs[i].away = false;
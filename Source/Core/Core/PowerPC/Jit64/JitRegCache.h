@@ -56,6 +56,9 @@ protected:
 	PPCCachedReg saved_regs[32];
 	X64CachedReg saved_xregs[NUMXREGS];
 
+	// PPC registers whose value might still be read, see SetLiveRegisters
+	u32 live;
+
 	virtual const int *GetAllocationOrder(int &count) = 0;
 
 	XEmitter *emit;
@@ -69,6 +72,11 @@ public:
 	void DiscardRegContentsIfCached(int preg);
 	void SetEmitter(XEmitter *emitter) {emit = emitter;}
 
+	// Dirty values of registers outside the mask are dropped rather than
+	// stored, pass the gprInUse of the instruction being compiled. Only
+	// the GPR cache has liveness information.
+	void SetLiveRegisters(u32 mask) {live = mask;}
+
 	void FlushR(X64Reg reg);
 	void FlushR(X64Reg reg, X64Reg reg2) {FlushR(reg); FlushR(reg2);}
 	void FlushLockX(X64Reg reg) {
@@ -103,8 +103,6 @@ void Jit64::bcx(UGeckoInstruction inst)
 	JITDISABLE(bJITBranchOff)
 
 	// USES_CR
-	_assert_msg_(DYNA_REC, js.isLastInstruction, "bcx not last instruction of block");
-
 	gpr.Flush(FLUSH_ALL);
 	fpr.Flush(FLUSH_ALL);
 
@@ -136,13 +134,37 @@ void Jit64::bcx(UGeckoInstruction inst)
 		destination = SignExt16(inst.BD << 2);
 	else
 		destination = js.compilerPC + SignExt16(inst.BD << 2);
+
+	// Superblocks carry on in the likely direction of the branch, see PPCAnalyst::Flatten.
+	if (!js.isLastInstruction && js.op[1].address == destination && destination != js.compilerPC + 4)
+	{
+		FixupBranch taken = J();
+		if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
+			SetJumpTarget( pConditionDontBranch );
+		if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
+			SetJumpTarget( pCTRDontBranch );
+		WriteExit(js.compilerPC + 4);
+		SetJumpTarget(taken);
+		return;
+	}
+
+	if (count_branches && js.isLastInstruction)
+	{
+#ifdef _M_X64
+		MOV(64, R(RAX), ImmPtr(&js.curBlock->takenCount));
+		ADD(32, MatR(RAX), Imm8(1));
+#else
+		ADD(32, M(&js.curBlock->takenCount), Imm8(1));
+#endif
+	}
 	WriteExit(destination);
 
 	if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
 		SetJumpTarget( pConditionDontBranch );
 	if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
 		SetJumpTarget( pCTRDontBranch );
-	WriteExit(js.compilerPC + 4);
+	if (js.isLastInstruction)
+		WriteExit(js.compilerPC + 4);
 }
 
 void Jit64::bcctrx(UGeckoInstruction inst)
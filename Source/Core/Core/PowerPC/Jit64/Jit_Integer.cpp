@@ -175,10 +175,14 @@ u32 Xor(u32 a, u32 b) {return a ^ b;}
 
 void Jit64::regimmop(int d, int a, bool binary, u32 value, Operation doop, void (XEmitter::*op)(int, const Gen::OpArg&, const Gen::OpArg&), bool Rc, bool carry)
 {
+	// Flags which are overwritten before anything reads them needn't be computed
+	Rc = Rc && WantsCR(0);
+	bool generate_carry = carry && WantsCA();
+
 	gpr.Lock(d, a);
 	if (a || binary || carry)  // yeh nasty special case addic
 	{
-		if (gpr.R(a).IsImm() && !carry)
+		if (gpr.R(a).IsImm() && !generate_carry)
 		{
 			gpr.SetImmediate32(d, doop((u32)gpr.R(a).offset, value));
 			if (Rc)
@@ -195,7 +199,7 @@ void Jit64::regimmop(int d, int a, bool binary, u32 value, Operation doop, void
 				// All of the possible passed operators affect Sign/Zero flags
 				GenerateRC();
 			}
-			if (carry)
+			if (generate_carry)
 				GenerateCarry();
 		}
 		else
@@ -208,7 +212,7 @@ void Jit64::regimmop(int d, int a, bool binary, u32 value, Operation doop, void
 				// All of the possible passed operators affect Sign/Zero flags
 				GenerateRC();
 			}
-			if (carry)
+			if (generate_carry)
 				GenerateCarry();
 		}
 	}
@@ -310,6 +314,10 @@ void Jit64::cmpXX(UGeckoInstruction inst)
 	int b = inst.RB;
 	int crf = inst.CRFD;
 
+	// Overwritten before anything reads it
+	if (!WantsCR(crf))
+		return;
+
 	bool merge_branch = false;
 	int test_crf = js.next_inst.BI >> 2;
 	// Check if the next instruction is a branch - if it is, merge the two.
@@ -323,6 +331,9 @@ void Jit64::cmpXX(UGeckoInstruction inst)
 			if (test_crf == crf) {
 				merge_branch = true;
 			}
+			// bcx is in charge of superblock side exits and of branch counting.
+			if (js.next_inst.OPCD == 16 && (js.instructionNumber + 2 != js.blockSize || count_branches))
+				merge_branch = false;
 	}
 
 	OpArg comparand;
@@ -569,7 +580,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 			gpr.SetImmediate32(a, (u32)gpr.R(s).offset ^ (u32)gpr.R(b).offset);
 		else if (inst.SUBOP10 == 284) /* eqvx */
 			gpr.SetImmediate32(a, ~((u32)gpr.R(s).offset ^ (u32)gpr.R(b).offset));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -613,7 +624,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			PanicAlert("WTF!");
 		}
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -627,7 +638,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		if (inst.SUBOP10 == 28) /* andx */
 		{
 			AND(32, gpr.R(a), operand);
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -636,7 +647,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			AND(32, gpr.R(a), operand);
 			NOT(32, gpr.R(a));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -654,7 +665,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 				NOT(32, R(EAX));
 				AND(32, gpr.R(a), R(EAX));
 			}
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -662,7 +673,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		else if (inst.SUBOP10 == 444) /* orx */
 		{
 			OR(32, gpr.R(a), operand);
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -671,7 +682,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			OR(32, gpr.R(a), operand);
 			NOT(32, gpr.R(a));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -689,7 +700,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 				NOT(32, R(EAX));
 				OR(32, gpr.R(a), R(EAX));
 			}
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -697,7 +708,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		else if (inst.SUBOP10 == 316) /* xorx */
 		{
 			XOR(32, gpr.R(a), operand);
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -706,7 +717,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			NOT(32, gpr.R(a));
 			XOR(32, gpr.R(a), operand);
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -726,7 +737,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			MOV(32, gpr.R(a), gpr.R(s));
 			AND(32, gpr.R(a), gpr.R(b));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -736,7 +747,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 			MOV(32, gpr.R(a), gpr.R(s));
 			AND(32, gpr.R(a), gpr.R(b));
 			NOT(32, gpr.R(a));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -746,7 +757,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 			MOV(32, gpr.R(a), gpr.R(b));
 			NOT(32, gpr.R(a));
 			AND(32, gpr.R(a), gpr.R(s));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -755,7 +766,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			MOV(32, gpr.R(a), gpr.R(s));
 			OR(32, gpr.R(a), gpr.R(b));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -765,7 +776,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 			MOV(32, gpr.R(a), gpr.R(s));
 			OR(32, gpr.R(a), gpr.R(b));
 			NOT(32, gpr.R(a));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -775,7 +786,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 			MOV(32, gpr.R(a), gpr.R(b));
 			NOT(32, gpr.R(a));
 			OR(32, gpr.R(a), gpr.R(s));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -784,7 +795,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 		{
 			MOV(32, gpr.R(a), gpr.R(s));
 			XOR(32, gpr.R(a), gpr.R(b));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -794,7 +805,7 @@ void Jit64::boolX(UGeckoInstruction inst)
 			MOV(32, gpr.R(a), gpr.R(s));
 			NOT(32, gpr.R(a));
 			XOR(32, gpr.R(a), gpr.R(b));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -829,7 +840,7 @@ void Jit64::extsbx(UGeckoInstruction inst)
 		gpr.UnlockAll();
 	}
 
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(a));
 	}
@@ -857,7 +868,7 @@ void Jit64::extshx(UGeckoInstruction inst)
 		gpr.UnlockAll();
 	}
 
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(a));
 	}
@@ -871,7 +882,22 @@ void Jit64::subfic(UGeckoInstruction inst)
 	gpr.Lock(a, d);
 	gpr.BindToRegister(d, a == d, true);
 	int imm = inst.SIMM_16;
-	if (d == a)
+	if (!WantsCA())
+	{
+		// Nothing reads the carry before it's overwritten, so this is just a subtraction
+		if (d == a)
+		{
+			NEG(32, gpr.R(d));
+			if (imm != 0)
+				ADD(32, gpr.R(d), Imm32(imm));
+		}
+		else
+		{
+			MOV(32, gpr.R(d), Imm32(imm));
+			SUB(32, gpr.R(d), gpr.R(a));
+		}
+	}
+	else if (d == a)
 	{
 		if (imm == 0)
 		{
@@ -919,10 +945,13 @@ void Jit64::subfcx(UGeckoInstruction inst)
 	INSTRUCTION_START;
 	JITDISABLE(bJITIntegerOff)
 	int a = inst.RA, b = inst.RB, d = inst.RD;
+	// Unless the carry is read before it's overwritten, only OE needs XER
+	bool write_xer = WantsCA() || inst.OE;
 	gpr.Lock(a, b, d);
 	gpr.BindToRegister(d, (d == a || d == b), true);
 
-	JitClearCAOV(inst.OE);
+	if (write_xer)
+		JitClearCAOV(inst.OE);
 	if (d == b)
 	{
 		SUB(32, gpr.R(d), gpr.R(a));
@@ -938,10 +967,11 @@ void Jit64::subfcx(UGeckoInstruction inst)
 		MOV(32, gpr.R(d), gpr.R(b));
 		SUB(32, gpr.R(d), gpr.R(a));
 	}
-	if (inst.Rc) {
+	if (inst.Rc && WantsCR(0)) {
 		GenerateRC();
 	}
-	FinalizeCarryOverflow(inst.OE, true);
+	if (write_xer)
+		FinalizeCarryOverflow(inst.OE, true);
 
 	gpr.UnlockAll();
 }
@@ -975,7 +1005,7 @@ void Jit64::subfex(UGeckoInstruction inst)
 		NOT(32, gpr.R(d));
 		ADC(32, gpr.R(d), gpr.R(b));
 	}
-	if (inst.Rc) {
+	if (inst.Rc && WantsCR(0)) {
 		GenerateRC();
 	}
 	FinalizeCarryGenerateOverflowEAX(inst.OE, invertedCarry);
@@ -999,7 +1029,7 @@ void Jit64::subfmex(UGeckoInstruction inst)
 	}
 	NOT(32, gpr.R(d));
 	ADC(32, gpr.R(d), Imm32(0xFFFFFFFF));
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		GenerateRC();
 	}
@@ -1024,7 +1054,7 @@ void Jit64::subfzex(UGeckoInstruction inst)
 	}
 	NOT(32, gpr.R(d));
 	ADC(32, gpr.R(d), Imm8(0));
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		GenerateRC();
 	}
@@ -1043,7 +1073,7 @@ void Jit64::subfx(UGeckoInstruction inst)
 	{
 		s32 i = (s32)gpr.R(b).offset, j = (s32)gpr.R(a).offset;
 		gpr.SetImmediate32(d, i - j);
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(d));
 		}
@@ -1071,7 +1101,7 @@ void Jit64::subfx(UGeckoInstruction inst)
 			MOV(32, gpr.R(d), gpr.R(b));
 			SUB(32, gpr.R(d), gpr.R(a));
 		}
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1200,7 +1230,7 @@ void Jit64::mullwx(UGeckoInstruction inst)
 		}
 		gpr.UnlockAll();
 	}
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(d));
 	}
@@ -1231,7 +1261,7 @@ void Jit64::mulhwux(UGeckoInstruction inst)
 		MOV(32, gpr.R(d), R(EDX));
 	}
 
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(d));
 	}
@@ -1388,7 +1418,7 @@ void Jit64::divwux(UGeckoInstruction inst)
 		gpr.UnlockAllX();
 	}
 
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(d));
 	}
@@ -1462,7 +1492,7 @@ void Jit64::divwx(UGeckoInstruction inst)
 		gpr.UnlockAllX();
 	}
 
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(d));
 	}
@@ -1478,7 +1508,7 @@ void Jit64::addx(UGeckoInstruction inst)
 	{
 		s32 i = (s32)gpr.R(a).offset, j = (s32)gpr.R(b).offset;
 		gpr.SetImmediate32(d, i + j);
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(d));
 		}
@@ -1487,7 +1517,7 @@ void Jit64::addx(UGeckoInstruction inst)
 			GenerateConstantOverflow((s64)(i + j) != (s64)i + (s64)j);
 		}
 	}
-	else if (gpr.R(a).IsSimpleReg() && gpr.R(b).IsSimpleReg() && !inst.Rc && !inst.OE)
+	else if (gpr.R(a).IsSimpleReg() && gpr.R(b).IsSimpleReg() && !(inst.Rc && WantsCR(0)) && !inst.OE)
 	{
 		gpr.Lock(a, b, d);
 		gpr.BindToRegister(d, false);
@@ -1500,7 +1530,7 @@ void Jit64::addx(UGeckoInstruction inst)
 		gpr.Lock(a, b, d);
 		gpr.BindToRegister(d, true);
 		ADD(32, gpr.R(d), gpr.R(operand));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1516,7 +1546,7 @@ void Jit64::addx(UGeckoInstruction inst)
 		gpr.BindToRegister(d, false);
 		MOV(32, gpr.R(d), gpr.R(a));
 		ADD(32, gpr.R(d), gpr.R(b));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1542,7 +1572,7 @@ void Jit64::addex(UGeckoInstruction inst)
 
 		GetCarryEAXAndClear();
 		ADC(32, gpr.R(d), gpr.R((d == a) ? b : a));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1557,7 +1587,7 @@ void Jit64::addex(UGeckoInstruction inst)
 		GetCarryEAXAndClear();
 		MOV(32, gpr.R(d), gpr.R(a));
 		ADC(32, gpr.R(d), gpr.R(b));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1571,33 +1601,39 @@ void Jit64::addcx(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITIntegerOff)
 	int a = inst.RA, b = inst.RB, d = inst.RD;
+	// Unless the carry is read before it's overwritten, only OE needs XER
+	bool write_xer = WantsCA() || inst.OE;
 
 	if ((d == a) || (d == b))
 	{
 		int operand = ((d == a) ? b : a);
 		gpr.Lock(a, b, d);
 		gpr.BindToRegister(d, true);
-		JitClearCAOV(inst.OE);
+		if (write_xer)
+			JitClearCAOV(inst.OE);
 		ADD(32, gpr.R(d), gpr.R(operand));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
-		FinalizeCarryOverflow(inst.OE);
+		if (write_xer)
+			FinalizeCarryOverflow(inst.OE);
 		gpr.UnlockAll();
 	}
 	else
 	{
 		gpr.Lock(a, b, d);
 		gpr.BindToRegister(d, false);
-		JitClearCAOV(inst.OE);
+		if (write_xer)
+			JitClearCAOV(inst.OE);
 		MOV(32, gpr.R(d), gpr.R(a));
 		ADD(32, gpr.R(d), gpr.R(b));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
-		FinalizeCarryOverflow(inst.OE);
+		if (write_xer)
+			FinalizeCarryOverflow(inst.OE);
 		gpr.UnlockAll();
 	}
 }
@@ -1616,7 +1652,7 @@ void Jit64::addmex(UGeckoInstruction inst)
 
 		GetCarryEAXAndClear();
 		ADC(32, gpr.R(d), Imm32(0xFFFFFFFF));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1631,7 +1667,7 @@ void Jit64::addmex(UGeckoInstruction inst)
 		GetCarryEAXAndClear();
 		MOV(32, gpr.R(d), gpr.R(a));
 		ADC(32, gpr.R(d), Imm32(0xFFFFFFFF));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1654,7 +1690,7 @@ void Jit64::addzex(UGeckoInstruction inst)
 
 		GetCarryEAXAndClear();
 		ADC(32, gpr.R(d), Imm8(0));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1669,7 +1705,7 @@ void Jit64::addzex(UGeckoInstruction inst)
 		GetCarryEAXAndClear();
 		MOV(32, gpr.R(d), gpr.R(a));
 		ADC(32, gpr.R(d), Imm8(0));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1691,7 +1727,7 @@ void Jit64::rlwinmx(UGeckoInstruction inst)
 			result = _rotl(result, inst.SH);
 		result &= Helper_Mask(inst.MB, inst.ME);
 		gpr.SetImmediate32(a, result);
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -1708,7 +1744,7 @@ void Jit64::rlwinmx(UGeckoInstruction inst)
 		if (inst.SH && inst.MB == 0 && inst.ME==31-inst.SH)
 		{
 			SHL(32, gpr.R(a), Imm8(inst.SH));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -1716,7 +1752,7 @@ void Jit64::rlwinmx(UGeckoInstruction inst)
 		else if (inst.SH && inst.ME == 31 && inst.MB == 32 - inst.SH)
 		{
 			SHR(32, gpr.R(a), Imm8(inst.MB));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -1730,12 +1766,12 @@ void Jit64::rlwinmx(UGeckoInstruction inst)
 			if (!(inst.MB==0 && inst.ME==31))
 			{
 				AND(32, gpr.R(a), Imm32(Helper_Mask(inst.MB, inst.ME)));
-				if (inst.Rc)
+				if (inst.Rc && WantsCR(0))
 				{
 					GenerateRC();
 				}
 			}
-			else if (inst.Rc)
+			else if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -1756,7 +1792,7 @@ void Jit64::rlwimix(UGeckoInstruction inst)
 	{
 		u32 mask = Helper_Mask(inst.MB,inst.ME);
 		gpr.SetImmediate32(a, ((u32)gpr.R(a).offset & ~mask) | (_rotl((u32)gpr.R(s).offset,inst.SH) & mask));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -1768,7 +1804,7 @@ void Jit64::rlwimix(UGeckoInstruction inst)
 		u32 mask = Helper_Mask(inst.MB, inst.ME);
 		if (mask == 0 || (a == s && inst.SH == 0))
 		{
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -1783,7 +1819,7 @@ void Jit64::rlwimix(UGeckoInstruction inst)
 			{
 				ROL(32, gpr.R(a), Imm8(inst.SH));
 			}
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				ComputeRC(gpr.R(a));
 			}
@@ -1812,7 +1848,7 @@ void Jit64::rlwimix(UGeckoInstruction inst)
 				AND(32, R(EAX), Imm32(mask));
 				XOR(32, gpr.R(a), R(EAX));
 			}
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -1822,7 +1858,7 @@ void Jit64::rlwimix(UGeckoInstruction inst)
 			XOR(32, gpr.R(a), gpr.R(s));
 			AND(32, gpr.R(a), Imm32(~mask));
 			XOR(32, gpr.R(a), gpr.R(s));
-			if (inst.Rc)
+			if (inst.Rc && WantsCR(0))
 			{
 				GenerateRC();
 			}
@@ -1841,7 +1877,7 @@ void Jit64::rlwnmx(UGeckoInstruction inst)
 	if (gpr.R(b).IsImm() && gpr.R(s).IsImm())
 	{
 		gpr.SetImmediate32(a, _rotl((u32)gpr.R(s).offset, (u32)gpr.R(b).offset & 0x1F) & mask);
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -1858,7 +1894,7 @@ void Jit64::rlwnmx(UGeckoInstruction inst)
 		}
 		ROL(32, gpr.R(a), R(ECX));
 		AND(32, gpr.R(a), Imm32(mask));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1877,7 +1913,7 @@ void Jit64::negx(UGeckoInstruction inst)
 	if (gpr.R(a).IsImm())
 	{
 		gpr.SetImmediate32(d, ~((u32)gpr.R(a).offset) + 1);
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(d));
 		}
@@ -1893,7 +1929,7 @@ void Jit64::negx(UGeckoInstruction inst)
 		if (a != d)
 			MOV(32, gpr.R(d), gpr.R(a));
 		NEG(32, gpr.R(d));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
@@ -1951,7 +1987,7 @@ void Jit64::srwx(UGeckoInstruction inst)
 #endif
 	}
 	// Shift of 0 doesn't update flags, so compare manually just in case
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(a));
 	}
@@ -1969,7 +2005,7 @@ void Jit64::slwx(UGeckoInstruction inst)
 	{
 		u32 amount = (u32)gpr.R(b).offset;
 		gpr.SetImmediate32(a, (amount & 0x20) ? 0 : (u32)gpr.R(s).offset << amount);
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -1986,7 +2022,7 @@ void Jit64::slwx(UGeckoInstruction inst)
 			MOV(32, gpr.R(a), gpr.R(s));
 		}
 		SHL(64, gpr.R(a), R(ECX));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			AND(32, gpr.R(a), gpr.R(a));
 			GenerateRC();
@@ -2014,7 +2050,7 @@ void Jit64::slwx(UGeckoInstruction inst)
 		gpr.UnlockAll();
 		gpr.UnlockAllX();
 		// Shift of 0 doesn't update flags, so compare manually just in case
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			ComputeRC(gpr.R(a));
 		}
@@ -2031,21 +2067,27 @@ void Jit64::srawx(UGeckoInstruction inst)
 	int b = inst.RB;
 	int s = inst.RS;
 #ifdef _M_X64
+	bool carry = WantsCA();
 	gpr.Lock(a, s, b);
 	gpr.FlushLockX(ECX);
 	gpr.BindToRegister(a, (a == s || a == b), true);
-	JitClearCA();
+	if (carry)
+		JitClearCA();
 	MOV(32, R(ECX), gpr.R(b));
 	if (a != s)
 		MOV(32, gpr.R(a), gpr.R(s));
 	SHL(64, gpr.R(a), Imm8(32));
 	SAR(64, gpr.R(a), R(ECX));
-	MOV(32, R(EAX), gpr.R(a));
+	if (carry)
+		MOV(32, R(EAX), gpr.R(a));
 	SHR(64, gpr.R(a), Imm8(32));
-	TEST(32, gpr.R(a), R(EAX));
-	FixupBranch nocarry = J_CC(CC_Z);
-	JitSetCA();
-	SetJumpTarget(nocarry);
+	if (carry)
+	{
+		TEST(32, gpr.R(a), R(EAX));
+		FixupBranch nocarry = J_CC(CC_Z);
+		JitSetCA();
+		SetJumpTarget(nocarry);
+	}
 	gpr.UnlockAll();
 	gpr.UnlockAllX();
 #else
@@ -2075,7 +2117,7 @@ void Jit64::srawx(UGeckoInstruction inst)
 	gpr.UnlockAll();
 	gpr.UnlockAllX();
 #endif
-	if (inst.Rc) {
+	if (inst.Rc && WantsCR(0)) {
 		ComputeRC(gpr.R(a));
 	}
 }
@@ -2089,24 +2131,29 @@ void Jit64::srawix(UGeckoInstruction inst)
 	int amount = inst.SH;
 	if (amount != 0)
 	{
+		bool carry = WantsCA();
 		gpr.Lock(a, s);
 		gpr.BindToRegister(a, a == s, true);
-		JitClearCA();
+		if (carry)
+			JitClearCA();
 		MOV(32, R(EAX), gpr.R(s));
 		if (a != s)
 		{
 			MOV(32, gpr.R(a), R(EAX));
 		}
 		SAR(32, gpr.R(a), Imm8(amount));
-		if (inst.Rc)
+		if (inst.Rc && WantsCR(0))
 		{
 			GenerateRC();
 		}
-		SHL(32, R(EAX), Imm8(32-amount));
-		TEST(32, R(EAX), gpr.R(a));
-		FixupBranch nocarry = J_CC(CC_Z);
-		JitSetCA();
-		SetJumpTarget(nocarry);
+		if (carry)
+		{
+			SHL(32, R(EAX), Imm8(32-amount));
+			TEST(32, R(EAX), gpr.R(a));
+			FixupBranch nocarry = J_CC(CC_Z);
+			JitSetCA();
+			SetJumpTarget(nocarry);
+		}
 		gpr.UnlockAll();
 	}
 	else
@@ -2119,7 +2166,7 @@ void Jit64::srawix(UGeckoInstruction inst)
 		{
 			MOV(32, gpr.R(a), gpr.R(s));
 		}
-		if (inst.Rc) {
+		if (inst.Rc && WantsCR(0)) {
 			ComputeRC(gpr.R(a));
 		}
 		gpr.UnlockAll();
@@ -2156,7 +2203,7 @@ void Jit64::cntlzwx(UGeckoInstruction inst)
 		gpr.UnlockAll();
 	}
 
-	if (inst.Rc)
+	if (inst.Rc && WantsCR(0))
 	{
 		ComputeRC(gpr.R(a));
 		// TODO: Check PPC manual too
@@ -405,7 +405,7 @@ void JitIL::WriteExit(u32 destination)
 		MOV(32, M(&PC), Imm32(destination));
 		JMP(asm_routines.dispatcher, true);
 	}
-	b->linkData.push_back(linkData);
+	blocks.AddLinkData(b, linkData);
 }
 
 void JitIL::WriteExitDestInOpArg(const Gen::OpArg& arg)
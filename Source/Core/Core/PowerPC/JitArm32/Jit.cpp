@@ -203,7 +203,7 @@ void JitArm::WriteExit(u32 destination)
 		B(A);
 	}
 
-	b->linkData.push_back(linkData);
+	blocks.AddLinkData(b, linkData);
 }
 
 void STACKALIGN JitArm::Run()
@@ -152,6 +152,13 @@ void JitArm::mtsr(UGeckoInstruction inst)
 	INSTRUCTION_START
 	JITDISABLE(bJITSystemRegistersOff)
 
+	// The TLB has to be flushed
+	if (Core::g_CoreStartupParameter.bMMU)
+	{
+		Default(inst);
+		return;
+	}
+
 	STR(gpr.R(inst.RS), R9, PPCSTATE_OFF(sr[inst.SR]));
 }
 
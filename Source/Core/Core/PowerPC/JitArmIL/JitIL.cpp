@@ -143,7 +143,7 @@ void JitArmIL::WriteExit(u32 destination)
 		B(R14);
 	}
 
-	b->linkData.push_back(linkData);
+	blocks.AddLinkData(b, linkData);
 }
 void JitArmIL::PrintDebug(UGeckoInstruction inst, u32 level)
 {
@@ -10,6 +10,7 @@
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 JitBase *jit;
+u32 g_dispatcherEntries;
 
 void Jit(u32 em_address)
 {
@@ -113,6 +113,8 @@ public:
 };
 
 extern JitBase *jit;
+// Exits to the Jit64 dispatcher of blocks compiled while profiling, for the profile results.
+extern u32 g_dispatcherEntries;
 
 void Jit(u32 em_address);
 
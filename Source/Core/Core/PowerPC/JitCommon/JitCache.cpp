@@ -9,11 +9,14 @@
 // performance hit, it's not enabled by default, but it's useful for
 // locating performance issues.
 
+#include <algorithm>
+
 #include "disasm.h"
 
 #include "Common/Common.h"
 #include "Common/MemoryUtil.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 #ifdef _WIN32
@@ -46,6 +49,7 @@ using namespace Gen;
 #endif
 		blocks = new JitBlock[MAX_NUM_BLOCKS];
 		blockCodePointers = new const u8*[MAX_NUM_BLOCKS];
+		block_pages.resize(NUM_BLOCK_PAGES);
 		if (iCache == 0 && iCacheEx == 0 && iCacheVMEM == 0)
 		{
 			iCache = new u8[JIT_ICACHE_SIZE];
@@ -82,9 +86,13 @@ using namespace Gen;
 		blocks = 0;
 		blockCodePointers = 0;
 		num_blocks = 0;
+		link_pool.clear();
+		links_to.clear();
+		block_pages.clear();
 #if defined USE_OPROFILE && USE_OPROFILE
 		op_close_agent(agent);
 #endif
+		Profiler::ClosePerfMap();
 
 #ifdef USE_VTUNE
 		iJIT_NotifyEvent(iJVM_EVENT_TYPE_SHUTDOWN, NULL);
@@ -106,8 +114,8 @@ using namespace Gen;
 		{
 			DestroyBlock(i, false);
 		}
+		link_pool.clear();
 		links_to.clear();
-		block_map.clear();
 		valid_block.reset();
 		num_blocks = 0;
 		memset(blockCodePointers, 0, sizeof(u8*)*MAX_NUM_BLOCKS);
@@ -164,11 +172,26 @@ using namespace Gen;
 		JitBlock &b = blocks[num_blocks];
 		b.invalid = false;
 		b.originalAddress = em_address;
-		b.linkData.clear();
+		b.physicalRanges.clear();
+		b.firstLink = (int)link_pool.size();
+		b.numLinks = 0;
+		b.ticStart = 0;
+		b.ticStop = 0;
+		b.ticCounter = 0;
 		num_blocks++; //commit the current block
 		return num_blocks - 1;
 	}
 
+	void JitBaseBlockCache::AddLinkData(JitBlock *b, const JitBlock::LinkData &link)
+	{
+		// Blocks are compiled one at a time, so a block's exits stay contiguous.
+		_dbg_assert_msg_(DYNA_REC, b->firstLink + b->numLinks == (int)link_pool.size(), "Interleaved block exits");
+		link_pool.push_back(link);
+		link_pool.back().prevLink = -1;
+		link_pool.back().nextLink = -1;
+		b->numLinks++;
+	}
+
 	void JitBaseBlockCache::FinalizeBlock(int block_num, bool block_link, const u8 *code_ptr)
 	{
 		blockCodePointers[block_num] = code_ptr;
@@ -176,24 +199,34 @@ using namespace Gen;
 		u32* icp = GetICachePtr(b.originalAddress);
 		*icp = block_num;
 
-		// Convert the logical address to a physical address for the block map
-		u32 pAddr = b.originalAddress & 0x1FFFFFFF;
+		if (b.physicalRanges.empty())
+		{
+			// Convert the logical address to a physical address for the block map
+			u32 start = b.originalAddress & 0x1FFFFFFF;
+			u32 end = std::min<u32>(start + 4 * std::max<u32>(b.originalSize, 1) - 1, 0x1FFFFFFF);
+			b.physicalRanges.push_back(std::make_pair(start, end));
+		}
 
-		for (u32 i = 0; i < (b.originalSize + 7) / 8; ++i)
-			valid_block[pAddr / 32 + i] = true;
+		for (const auto& range : b.physicalRanges)
+		{
+			for (u32 line = range.first / 32; line <= range.second / 32; ++line)
+				valid_block[line] = true;
+		}
 
-		block_map[std::make_pair(pAddr + 4 * b.originalSize - 1, pAddr)] = block_num;
+		AddBlockToPages(block_num);
+		AddLinksTo(block_num);
 		if (block_link)
 		{
-			for (const auto& e : b.linkData)
-			{
-				links_to.insert(std::pair<u32, int>(e.exitAddress, block_num));
-			}
-
 			LinkBlock(block_num);
 			LinkBlockExits(block_num);
 		}
 
+		if (Profiler::g_ProfileBlocks)
+		{
+			Profiler::RegisterPerfMapBlock(b.checkedEntry, (u32)(b.normalEntry + b.codeSize - b.checkedEntry),
+			                               b.originalAddress);
+		}
+
 #if defined USE_OPROFILE && USE_OPROFILE
 		char buf[100];
 		sprintf(buf, "EmuCode%x", b.originalAddress);
@@ -225,11 +258,11 @@ using namespace Gen;
 	u32* JitBaseBlockCache::GetICachePtr(u32 addr)
 	{
 		if (addr & JIT_ICACHE_VMEM_BIT)
-			return (u32*)(jit->GetBlockCache()->iCacheVMEM + (addr & JIT_ICACHE_MASK));
+			return (u32*)(iCacheVMEM + (addr & JIT_ICACHE_MASK));
 		else if (addr & JIT_ICACHE_EXRAM_BIT)
-			return (u32*)(jit->GetBlockCache()->iCacheEx + (addr & JIT_ICACHEEX_MASK));
+			return (u32*)(iCacheEx + (addr & JIT_ICACHEEX_MASK));
 		else
-			return (u32*)(jit->GetBlockCache()->iCache + (addr & JIT_ICACHE_MASK));
+			return (u32*)(iCache + (addr & JIT_ICACHE_MASK));
 	}
 
 	int JitBaseBlockCache::GetBlockNumberFromStartAddress(u32 addr)
@@ -258,6 +291,79 @@ using namespace Gen;
 	//Can be faster by doing a queue for blocks to link up, and only process those
 	//Should probably be done
 
+	bool JitBaseBlockCache::BlockIntersects(const JitBlock &b, u32 start, u32 end) const
+	{
+		for (const auto& range : b.physicalRanges)
+		{
+			if (RangeIntersect(range.first, range.second, start, end))
+				return true;
+		}
+		return false;
+	}
+
+	// A block is on the bucket of a page once per range overlapping it.
+	void JitBaseBlockCache::AddBlockToPages(int block_num)
+	{
+		for (const auto& range : blocks[block_num].physicalRanges)
+		{
+			for (u32 page = range.first >> BLOCK_PAGE_SHIFT; page <= range.second >> BLOCK_PAGE_SHIFT; ++page)
+				block_pages[page].push_back(block_num);
+		}
+	}
+
+	void JitBaseBlockCache::RemoveBlockFromPages(int block_num)
+	{
+		for (const auto& range : blocks[block_num].physicalRanges)
+		{
+			for (u32 page = range.first >> BLOCK_PAGE_SHIFT; page <= range.second >> BLOCK_PAGE_SHIFT; ++page)
+			{
+				std::vector<int> &bucket = block_pages[page];
+				auto it = std::find(bucket.begin(), bucket.end(), block_num);
+				if (it != bucket.end())
+				{
+					*it = bucket.back();
+					bucket.pop_back();
+				}
+			}
+		}
+	}
+
+	// Pushes the block's exits onto the lists of exits sharing their destination.
+	void JitBaseBlockCache::AddLinksTo(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		for (int i = b.firstLink; i < b.firstLink + b.numLinks; i++)
+		{
+			JitBlock::LinkData &e = link_pool[i];
+			auto result = links_to.insert(std::make_pair(e.exitAddress, i));
+			if (!result.second)
+			{
+				int head = result.first->second;
+				e.nextLink = head;
+				link_pool[head].prevLink = i;
+				result.first->second = i;
+			}
+		}
+	}
+
+	void JitBaseBlockCache::RemoveLinksTo(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		for (int i = b.firstLink; i < b.firstLink + b.numLinks; i++)
+		{
+			JitBlock::LinkData &e = link_pool[i];
+			if (e.prevLink != -1)
+				link_pool[e.prevLink].nextLink = e.nextLink;
+			else if (e.nextLink != -1)
+				links_to[e.exitAddress] = e.nextLink;
+			else
+				links_to.erase(e.exitAddress);
+			if (e.nextLink != -1)
+				link_pool[e.nextLink].prevLink = e.prevLink;
+			e.prevLink = e.nextLink = -1;
+		}
+	}
+
 	void JitBaseBlockCache::LinkBlockExits(int i)
 	{
 		JitBlock &b = blocks[i];
@@ -266,8 +372,9 @@ using namespace Gen;
 			// This block is dead. Don't relink it.
 			return;
 		}
-		for (auto& e : b.linkData)
+		for (int l = b.firstLink; l < b.firstLink + b.numLinks; l++)
 		{
+			JitBlock::LinkData &e = link_pool[l];
 			if (!e.linkStatus)
 			{
 				int destinationBlock = GetBlockNumberFromStartAddress(e.exitAddress);
@@ -280,40 +387,34 @@ using namespace Gen;
 		}
 	}
 
-	using namespace std;
-
+	// Links all exits jumping to the start of block i. Only exits of live
+	// blocks are on the lists, so this touches nothing but the affected jumps.
 	void JitBaseBlockCache::LinkBlock(int i)
 	{
-		LinkBlockExits(i);
 		JitBlock &b = blocks[i];
-		pair<multimap<u32, int>::iterator, multimap<u32, int>::iterator> ppp;
-		// equal_range(b) returns pair<iterator,iterator> representing the range
-		// of element with key b
-		ppp = links_to.equal_range(b.originalAddress);
-		if (ppp.first == ppp.second)
+		auto it = links_to.find(b.originalAddress);
+		if (it == links_to.end())
 			return;
-		for (multimap<u32, int>::iterator iter = ppp.first; iter != ppp.second; ++iter) {
-			// PanicAlert("Linking block %i to block %i", iter->second, i);
-			LinkBlockExits(iter->second);
+		for (int l = it->second; l != -1; l = link_pool[l].nextLink)
+		{
+			JitBlock::LinkData &e = link_pool[l];
+			if (!e.linkStatus)
+			{
+				WriteLinkBlock(e.exitPtrs, b.checkedEntry);
+				e.linkStatus = true;
+			}
 		}
 	}
 
 	void JitBaseBlockCache::UnlinkBlock(int i)
 	{
 		JitBlock &b = blocks[i];
-		pair<multimap<u32, int>::iterator, multimap<u32, int>::iterator> ppp;
-		ppp = links_to.equal_range(b.originalAddress);
-		if (ppp.first == ppp.second)
+		auto it = links_to.find(b.originalAddress);
+		if (it == links_to.end())
 			return;
-		for (multimap<u32, int>::iterator iter = ppp.first; iter != ppp.second; ++iter) {
-			JitBlock &sourceBlock = blocks[iter->second];
-			for (auto& e : sourceBlock.linkData)
-			{
-				if (e.exitAddress == b.originalAddress)
-					e.linkStatus = false;
-			}
-		}
-		links_to.erase(b.originalAddress);
+		// The exits stay on the list, so they get relinked if the block is recompiled.
+		for (int l = it->second; l != -1; l = link_pool[l].nextLink)
+			link_pool[l].linkStatus = false;
 	}
 
 	void JitBaseBlockCache::DestroyBlock(int block_num, bool invalidate)
@@ -333,6 +434,8 @@ using namespace Gen;
 		b.invalid = true;
 		*GetICachePtr(b.originalAddress) = JIT_ICACHE_INVALID_WORD;
 
+		RemoveBlockFromPages(block_num);
+		RemoveLinksTo(block_num);
 		UnlinkBlock(block_num);
 
 		// Send anyone who tries to run this block back to the dispatcher.
@@ -357,20 +460,20 @@ using namespace Gen;
 		}
 
 		// destroy JIT blocks
-		// !! this works correctly under assumption that any two overlapping blocks end at the same address
-		if (destroy_block)
-		{
-			std::map<pair<u32,u32>, u32>::iterator it1 = block_map.lower_bound(std::make_pair(pAddr, 0)), it2 = it1;
-			while (it2 != block_map.end() && it2->first.second < pAddr + length)
+		if (destroy_block && length > 0)
 		{
-				JitBlock &b = blocks[it2->second];
-				*GetICachePtr(b.originalAddress) = JIT_ICACHE_INVALID_WORD;
-				DestroyBlock(it2->second, true);
-				++it2;
-			}
-			if (it1 != it2)
+			u32 last = std::min<u32>(pAddr + length - 1, 0x1FFFFFFF);
+			for (u32 page = pAddr >> BLOCK_PAGE_SHIFT; page <= last >> BLOCK_PAGE_SHIFT; ++page)
 			{
-				block_map.erase(it1, it2);
+				std::vector<int> &bucket = block_pages[page];
+				size_t i = 0;
+				while (i < bucket.size())
+				{
+					if (BlockIntersects(blocks[bucket[i]], pAddr, last))
+						DestroyBlock(bucket[i], true); // removes the block from the bucket
+					else
+						++i;
+				}
 			}
 		}
 
@@ -5,7 +5,8 @@
 #pragma once
 
 #include <bitset>
-#include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Core/PowerPC/Gekko.h"
@@ -38,24 +39,37 @@ struct JitBlock
 	u32 codeSize;
 	u32 originalSize;
 	int runCount;  // for profiling.
+	int takenCount;  // for branch profiling, see Jit64::bcx.
 	int flags;
 
 	bool invalid;
 
+	// Physical address ranges (first and last byte) the instructions came
+	// from. Blocks which followed branches cover several of them. Left empty
+	// by the JITs which don't fill it, which makes FinalizeBlock use the
+	// originalSize instructions starting at originalAddress.
+	std::vector<std::pair<u32, u32>> physicalRanges;
+
 	struct LinkData {
 		u8 *exitPtrs;    // to be able to rewrite the exit jum
 		u32 exitAddress;
 		bool linkStatus; // is it already linked?
+
+		// Intrusive list of all exits with the same exitAddress, as indices
+		// into the block cache's link pool. Maintained by the block cache.
+		int prevLink;
+		int nextLink;
 	};
-	std::vector<LinkData> linkData;
+	// This block's exits, a contiguous range in the block cache's link pool.
+	int firstLink;
+	int numLinks;
 
-#ifdef _WIN32
 	// we don't really need to save start and stop
 	// TODO (mb2): ticStart and ticStop -> "local var" mean "in block" ... low priority ;)
+	// Units are QueryPerformanceCounter ticks on 32-bit Windows and RDTSC cycles on x86-64.
 	u64 ticStart;   // for profiling - time.
 	u64 ticStop;    // for profiling - time.
 	u64 ticCounter; // for profiling - time.
-#endif
 
 #ifdef USE_VTUNE
 	char blockName[32];
@@ -70,15 +84,29 @@ class JitBaseBlockCache
 	const u8 **blockCodePointers;
 	JitBlock *blocks;
 	int num_blocks;
-	std::multimap<u32, int> links_to;
-	std::map<std::pair<u32,u32>, u32> block_map; // (end_addr, start_addr) -> number
+
+	// Exits of all blocks, appended to while a block is compiled and only
+	// reclaimed by Clear(). links_to maps an exit address to the first
+	// entry of the intrusive list of exits jumping to it.
+	std::vector<JitBlock::LinkData> link_pool;
+	std::unordered_map<u32, int> links_to;
+
+	// Blocks overlapping each physical page, for InvalidateICache.
+	std::vector<std::vector<int>> block_pages;
 	std::bitset<0x20000000 / 32> valid_block;
 	enum
 	{
-		MAX_NUM_BLOCKS = 65536*2
+		MAX_NUM_BLOCKS = 65536*2,
+		BLOCK_PAGE_SHIFT = 12,
+		NUM_BLOCK_PAGES = 0x20000000 >> BLOCK_PAGE_SHIFT,
 	};
 
 	bool RangeIntersect(int s1, int e1, int s2, int e2) const;
+	bool BlockIntersects(const JitBlock &b, u32 start, u32 end) const;
+	void AddBlockToPages(int block_num);
+	void RemoveBlockFromPages(int block_num);
+	void AddLinksTo(int block_num);
+	void RemoveLinksTo(int block_num);
 	void LinkBlockExits(int i);
 	void LinkBlock(int i);
 	void UnlinkBlock(int i);
@@ -92,6 +120,8 @@ public:
 		blockCodePointers(0), blocks(0), num_blocks(0),
 		iCache(0), iCacheEx(0), iCacheVMEM(0) {}
 	int AllocateBlock(u32 em_address);
+	// Records an exit of the block currently being compiled.
+	void AddLinkData(JitBlock *b, const JitBlock::LinkData &link);
 	void FinalizeBlock(int block_num, bool block_link, const u8 *code_ptr);
 
 	void Clear();
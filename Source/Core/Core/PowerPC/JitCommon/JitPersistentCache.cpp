@@ -0,0 +1,77 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/StringUtil.h"
+#include "Core/PowerPC/JitCommon/JitPersistentCache.h"
+
+void JitPersistentCache::Inserter::Read(const BlockKey& key, const u8* value, u32 value_size)
+{
+	if (m_cache.m_known.insert(key).second)
+		m_cache.m_pending[key.address >> PAGE_SHIFT].push_back(key);
+}
+
+void JitPersistentCache::Init(const std::string& game_id)
+{
+	Shutdown();
+
+	std::string cache_dir = File::GetUserPath(D_CACHE_IDX);
+	if (!File::Exists(cache_dir))
+		File::CreateFullPath(cache_dir);
+
+	std::string filename = StringFromFormat("%sjit-%s-blocks.cache", cache_dir.c_str(), game_id.c_str());
+
+	Inserter inserter(*this);
+	u32 num_entries = m_disk_cache.OpenAndRead(filename.c_str(), inserter);
+	INFO_LOG(DYNA_REC, "Loaded %u persistent JIT block entries from %s", num_entries, filename.c_str());
+
+	m_enabled = true;
+}
+
+void JitPersistentCache::Shutdown()
+{
+	if (m_enabled)
+	{
+		m_disk_cache.Sync();
+		m_disk_cache.Close();
+	}
+	m_known.clear();
+	m_pending.clear();
+	m_enabled = false;
+}
+
+void JitPersistentCache::AddBlock(u32 address, u32 hash)
+{
+	BlockKey key = { address, hash };
+	if (m_known.insert(key).second)
+		m_disk_cache.Append(key, nullptr, 0);
+}
+
+void JitPersistentCache::TakePending(u32 em_address, std::vector<BlockKey>& out)
+{
+	auto it = m_pending.find(em_address >> PAGE_SHIFT);
+	if (it != m_pending.end())
+	{
+		out.swap(it->second);
+		m_pending.erase(it);
+	}
+}
+
+void JitPersistentCache::Defer(const BlockKey& key)
+{
+	m_pending[key.address >> PAGE_SHIFT].push_back(key);
+}
+
+u32 JitPersistentCache::HashBlock(const PPCAnalyst::CodeBuffer* code_buffer, int size)
+{
+	std::vector<u32> words;
+	words.reserve(size * 2);
+	for (int i = 0; i < size; i++)
+	{
+		words.push_back(code_buffer->codebuffer[i].address);
+		words.push_back(code_buffer->codebuffer[i].inst.hex);
+	}
+	return HashAdler32((const u8*)words.data(), words.size() * sizeof(u32));
+}
@@ -0,0 +1,79 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/LinearDiskCache.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+
+// Remembers which guest blocks were compiled in earlier sessions of a game, so
+// the JIT can compile a whole page of them once execution enters it instead of
+// one by one as execution first reaches them.
+//
+// Only the guest side of a block is stored: its entry address and a hash of the
+// flattened instruction stream. The generated x86 code is not persisted since it
+// references emulator state, the dispatcher and the trampolines through
+// absolute and RIP-relative addresses which change from run to run. The hash is
+// checked against guest memory before an entry is recompiled, so stale entries
+// (overlays, self-modifying code, game updates) are simply skipped.
+class JitPersistentCache
+{
+public:
+	struct BlockKey
+	{
+		u32 address;
+		u32 hash;
+
+		bool operator<(const BlockKey& other) const
+		{
+			return address < other.address || (address == other.address && hash < other.hash);
+		}
+	};
+
+	JitPersistentCache() : m_enabled(false) {}
+
+	void Init(const std::string& game_id);
+	void Shutdown();
+
+	bool IsEnabled() const { return m_enabled; }
+
+	// Records a block which was just compiled. Unknown blocks are appended to the file.
+	void AddBlock(u32 address, u32 hash);
+
+	// Hands out the entries in the same page as em_address, which should be
+	// compiled before the block at em_address. Each entry is handed out once.
+	void TakePending(u32 em_address, std::vector<BlockKey>& out);
+
+	// Puts an entry which there was no time for back, for the next block in its page.
+	void Defer(const BlockKey& key);
+
+	static u32 HashBlock(const PPCAnalyst::CodeBuffer* code_buffer, int size);
+
+private:
+	enum
+	{
+		PAGE_SHIFT = 12
+	};
+
+	class Inserter : public LinearDiskCacheReader<BlockKey, u8>
+	{
+	public:
+		Inserter(JitPersistentCache& cache) : m_cache(cache) {}
+		void Read(const BlockKey& key, const u8* value, u32 value_size) override;
+
+	private:
+		JitPersistentCache& m_cache;
+	};
+
+	LinearDiskCache<BlockKey, u8> m_disk_cache;
+	std::set<BlockKey> m_known;
+	std::map<u32, std::vector<BlockKey>> m_pending; // page -> entries
+	bool m_enabled;
+};
@@ -117,6 +117,51 @@ u8 *EmuCodeBlock::UnsafeLoadToReg(X64Reg reg_value, Gen::OpArg opAddress, int ac
 	return result;
 }
 
+#ifdef _M_X64
+Gen::FixupBranch EmuCodeBlock::LookupDataTLB(X64Reg reg_addr)
+{
+	// Same as LookupTLBPageAddress in MemmapFunctions.cpp
+	const int tag_offset = offsetof(PowerPC::TLBSet, tag);
+	const int paddr_offset = offsetof(PowerPC::TLBSet, paddr);
+	const int recent_offset = offsetof(PowerPC::TLBSet, recent);
+
+	X64Reg set = reg_addr == RCX ? RSI : RCX;
+	X64Reg tmp = reg_addr == RDX ? RSI : RDX;
+
+	PUSH(set);
+	PUSH(tmp);
+	MOV(32, R(set), R(reg_addr));
+	SHR(32, R(set), Imm8(12 - 5)); // sizeof(TLBSet) == 32
+	AND(32, R(set), Imm32((PowerPC::TLB_SETS - 1) << 5));
+	MOV(64, R(tmp), ImmPtr(&PowerPC::ppcState.tlb[PowerPC::TLB_INDEX_DATA][0]));
+	ADD(64, R(set), R(tmp));
+	MOV(32, R(tmp), R(reg_addr));
+	AND(32, R(tmp), Imm32(~0xfff));
+	CMP(32, R(tmp), MDisp(set, tag_offset));
+	FixupBranch hit0 = J_CC(CC_E);
+	CMP(32, R(tmp), MDisp(set, tag_offset + 4));
+	FixupBranch hit1 = J_CC(CC_E);
+	POP(tmp);
+	POP(set);
+	FixupBranch miss = J(true);
+
+	SetJumpTarget(hit1);
+	MOV(32, R(tmp), MDisp(set, paddr_offset + 4));
+	MOV(32, MDisp(set, recent_offset), Imm32(1));
+	FixupBranch translate = J();
+	SetJumpTarget(hit0);
+	MOV(32, R(tmp), MDisp(set, paddr_offset));
+	MOV(32, MDisp(set, recent_offset), Imm32(0));
+	SetJumpTarget(translate);
+	AND(32, R(reg_addr), Imm32(0xfff));
+	OR(32, R(reg_addr), R(tmp));
+	AND(32, R(reg_addr), Imm32(Memory::RAM_MASK));
+	POP(tmp);
+	POP(set);
+	return miss;
+}
+#endif
+
 void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress, int accessSize, s32 offset, u32 registersInUse, bool signExtend, int flags)
 {
 	if (!jit->js.memcheck)
@@ -195,6 +240,17 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 				TEST(32, R(EAX), Imm32(mem_mask));
 				FixupBranch fast = J_CC(CC_Z, true);
 
+#if defined(_M_X64)
+				FixupBranch tlb_hit;
+				if (Core::g_CoreStartupParameter.bMMU)
+				{
+					FixupBranch tlb_miss = LookupDataTLB(EAX);
+					UnsafeLoadToReg(reg_value, R(EAX), accessSize, 0, signExtend);
+					tlb_hit = J(true);
+					SetJumpTarget(tlb_miss);
+				}
+#endif
+
 				ABI_PushRegistersAndAdjustStack(registersInUse, false);
 				switch (accessSize)
 				{
@@ -222,12 +278,28 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 				SetJumpTarget(fast);
 				UnsafeLoadToReg(reg_value, R(EAX), accessSize, 0, signExtend);
 				SetJumpTarget(exit);
+#if defined(_M_X64)
+				if (Core::g_CoreStartupParameter.bMMU)
+					SetJumpTarget(tlb_hit);
+#endif
 			}
 			else
 			{
 				TEST(32, opAddress, Imm32(mem_mask));
 				FixupBranch fast = J_CC(CC_Z, true);
 
+#if defined(_M_X64)
+				FixupBranch tlb_hit;
+				if (Core::g_CoreStartupParameter.bMMU)
+				{
+					MOV(32, R(EAX), opAddress);
+					FixupBranch tlb_miss = LookupDataTLB(EAX);
+					UnsafeLoadToReg(reg_value, R(EAX), accessSize, 0, signExtend);
+					tlb_hit = J(true);
+					SetJumpTarget(tlb_miss);
+				}
+#endif
+
 				ABI_PushRegistersAndAdjustStack(registersInUse, false);
 				switch (accessSize)
 				{
@@ -255,6 +327,10 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 				SetJumpTarget(fast);
 				UnsafeLoadToReg(reg_value, opAddress, accessSize, offset, signExtend);
 				SetJumpTarget(exit);
+#if defined(_M_X64)
+				if (Core::g_CoreStartupParameter.bMMU)
+					SetJumpTarget(tlb_hit);
+#endif
 			}
 		}
 	}
@@ -326,6 +402,29 @@ void EmuCodeBlock::SafeWriteRegToReg(X64Reg reg_value, X64Reg reg_addr, int acce
 	FixupBranch fast = J_CC(CC_Z, true);
 	bool noProlog = (0 != (flags & SAFE_LOADSTORE_NO_PROLOG));
 	bool swap = !(flags & SAFE_LOADSTORE_NO_SWAP);
+#if defined(_M_X64)
+	FixupBranch tlb_hit;
+	if (Core::g_CoreStartupParameter.bMMU)
+	{
+		// The float and paired stores pass their value in EAX, so translate
+		// a copy of the address in another register in that case.
+		X64Reg tlb_addr = EAX;
+		if (reg_value == EAX)
+		{
+			tlb_addr = reg_addr == RCX ? RDX : RCX;
+			PUSH(tlb_addr);
+		}
+		MOV(32, R(tlb_addr), R(reg_addr));
+		FixupBranch tlb_miss = LookupDataTLB(tlb_addr);
+		UnsafeWriteRegToReg(reg_value, tlb_addr, accessSize, 0, swap);
+		if (tlb_addr != EAX)
+			POP(tlb_addr);
+		tlb_hit = J(true);
+		SetJumpTarget(tlb_miss);
+		if (tlb_addr != EAX)
+			POP(tlb_addr);
+	}
+#endif
 	ABI_PushRegistersAndAdjustStack(registersInUse, noProlog);
 	switch (accessSize)
 	{
@@ -338,6 +437,10 @@ void EmuCodeBlock::SafeWriteRegToReg(X64Reg reg_value, X64Reg reg_addr, int acce
 	SetJumpTarget(fast);
 	UnsafeWriteRegToReg(reg_value, reg_addr, accessSize, 0, swap);
 	SetJumpTarget(exit);
+#if defined(_M_X64)
+	if (Core::g_CoreStartupParameter.bMMU)
+		SetJumpTarget(tlb_hit);
+#endif
 }
 
 void EmuCodeBlock::SafeWriteFloatToReg(X64Reg xmm_value, X64Reg reg_addr, u32 registersInUse, int flags)
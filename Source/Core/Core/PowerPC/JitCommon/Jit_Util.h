@@ -35,6 +35,12 @@ public:
 		SAFE_LOADSTORE_NO_FASTMEM = 4
 	};
 	void SafeLoadToReg(Gen::X64Reg reg_value, const Gen::OpArg & opAddress, int accessSize, s32 offset, u32 registersInUse, bool signExtend, int flags = 0);
+#ifdef _M_X64
+	// Looks the effective address in reg_addr up in the data TLB, for the slow path in MMU
+	// mode. On a hit, reg_addr is replaced by the physical address and no other register
+	// is modified. The returned branch is taken on a miss, with reg_addr unchanged.
+	Gen::FixupBranch LookupDataTLB(Gen::X64Reg reg_addr);
+#endif
 	void SafeWriteRegToReg(Gen::X64Reg reg_value, Gen::X64Reg reg_addr, int accessSize, s32 offset, u32 registersInUse, int flags = 0);
 
 	// Trashes both inputs and EAX.
@@ -10,6 +10,7 @@
 #endif
 
 #include "Core/ConfigManager.h"
+#include "Core/Movie.h"
 #include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -40,8 +41,14 @@ namespace JitInterface
 		if (jit && p.GetMode() == PointerWrap::MODE_READ)
 			jit->GetBlockCache()->ClearSafe();
 	}
+	// Dispatcher entries and frames when the profile results were last written.
+	static u32 s_last_dispatcher_entries;
+	static u64 s_last_frame;
+
 	CPUCoreBase *InitJitCore(int core)
 	{
+		g_dispatcherEntries = s_last_dispatcher_entries = 0;
+		s_last_frame = Movie::g_currentFrame;
 		bFakeVMEM = SConfig::GetInstance().m_LocalCoreStartupParameter.bTLBHack == true;
 		bMMU = SConfig::GetInstance().m_LocalCoreStartupParameter.bMMU;
 
@@ -132,8 +139,8 @@ namespace JitInterface
 		std::vector<BlockStat> stats;
 		stats.reserve(jit->GetBlockCache()->GetNumBlocks());
 		u64 cost_sum = 0;
-	#ifdef _WIN32
 		u64 timecost_sum = 0;
+	#if defined(_WIN32) && defined(_M_IX86)
 		u64 countsPerSec;
 		QueryPerformanceFrequency((LARGE_INTEGER *)&countsPerSec);
 	#endif
@@ -142,16 +149,12 @@ namespace JitInterface
 			const JitBlock *block = jit->GetBlockCache()->GetBlock(i);
 			// Rough heuristic.  Mem instructions should cost more.
 			u64 cost = block->originalSize * (block->runCount / 4);
-	#ifdef _WIN32
 			u64 timecost = block->ticCounter;
-	#endif
 			// Todo: tweak.
 			if (block->runCount >= 1)
-				stats.push_back(BlockStat(i, cost));
+				stats.push_back(BlockStat(i, cost, timecost));
 			cost_sum += cost;
-	#ifdef _WIN32
 			timecost_sum += timecost;
-	#endif
 		}
 
 		sort(stats.begin(), stats.end());
@@ -161,7 +164,14 @@ namespace JitInterface
 			PanicAlert("Failed to open %s", filename);
 			return;
 		}
-		fprintf(f.GetHandle(), "origAddr\tblkName\tcost\ttimeCost\tpercent\ttimePercent\tOvAllinBlkTime(ms)\tblkCodeSize\n");
+		// timeCost is in QueryPerformanceCounter ticks on 32-bit Windows and in RDTSC cycles on x86-64.
+		u64 frames = Movie::g_currentFrame - s_last_frame;
+		u32 dispatcher_entries = g_dispatcherEntries - s_last_dispatcher_entries;
+		s_last_frame = Movie::g_currentFrame;
+		s_last_dispatcher_entries = g_dispatcherEntries;
+		fprintf(f.GetHandle(), "blocks: %i\tdispatcher entries per frame: %.1lf (over %" PRIu64 " frames)\n",
+				jit->GetBlockCache()->GetNumBlocks(), frames ? (double)dispatcher_entries / frames : 0.0, frames);
+		fprintf(f.GetHandle(), "origAddr\tblkName\tcost\ttimeCost\tpercent\ttimePercent\trunCount\ttimePerRun\tOvAllinBlkTime(ms)\tblkCodeSize\n");
 		for (auto& stat : stats)
 		{
 			const JitBlock *block = jit->GetBlockCache()->GetBlock(stat.blockNum);
@@ -169,15 +179,17 @@ namespace JitInterface
 			{
 				std::string name = g_symbolDB.GetDescription(block->originalAddress);
 				double percent = 100.0 * (double)stat.cost / (double)cost_sum;
-	#ifdef _WIN32
-				double timePercent = 100.0 * (double)block->ticCounter / (double)timecost_sum;
-				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%.2lf\t%llf\t%lf\t%i\n",
+				double timePercent = timecost_sum ? 100.0 * (double)stat.timeCost / (double)timecost_sum : 0.0;
+				u64 timePerRun = stat.timeCost / block->runCount;
+	#if defined(_WIN32) && defined(_M_IX86)
+				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%.2lf\t%.2lf\t%i\t%" PRIu64 "\t%lf\t%i\n",
 						block->originalAddress, name.c_str(), stat.cost,
-						block->ticCounter, percent, timePercent,
-						(double)block->ticCounter*1000.0/(double)countsPerSec, block->codeSize);
+						stat.timeCost, percent, timePercent, block->runCount, timePerRun,
+						(double)stat.timeCost*1000.0/(double)countsPerSec, block->codeSize);
 	#else
-				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t???\t%.2lf\t???\t???\t%i\n",
-						block->originalAddress, name.c_str(), stat.cost,  percent, block->codeSize);
+				fprintf(f.GetHandle(), "%08x\t%s\t%" PRIu64 "\t%" PRIu64 "\t%.2lf\t%.2lf\t%i\t%" PRIu64 "\t???\t%i\n",
+						block->originalAddress, name.c_str(), stat.cost,
+						stat.timeCost, percent, timePercent, block->runCount, timePerRun, block->codeSize);
 	#endif
 			}
 		}
@@ -234,6 +246,26 @@ namespace JitInterface
 		return inst;
 	}
 
+	u32 Peek_Opcode_JIT(u32 _Address)
+	{
+	#ifdef FAST_ICACHE
+		if (bMMU && !bFakeVMEM && (_Address & Memory::ADDR_MASK_MEM1))
+		{
+			_Address = Memory::TranslateAddress(_Address, Memory::FLAG_OPCODE);
+			if (_Address == 0)
+			{
+				return 0;
+			}
+		}
+
+		if ( (_Address & 0x0FFFFF00) == 0x00000500 )
+			return Memory::ReadUnchecked_U32(_Address);
+		return PowerPC::ppcState.iCache.PeekInstruction(_Address);
+	#else
+		return Memory::ReadUnchecked_U32(_Address);
+	#endif
+	}
+
 	void Shutdown()
 	{
 		if (jit)
@@ -24,6 +24,9 @@ namespace JitInterface
 
 	// used by JIT to read instructions
 	u32 Read_Opcode_JIT(const u32 _Address);
+	// Same, without loading the instructions into the emulated icache. For
+	// compiling code ahead of the guest running it.
+	u32 Peek_Opcode_JIT(const u32 _Address);
 
 	// Clearing CodeCache
 	void ClearCache();
@@ -269,12 +269,74 @@ bool CanSwapAdjacentOps(const CodeOp &a, const CodeOp &b)
 	return true;
 }
 
+// Whether everything has to be up to date before the instruction runs: it
+// might leave the block through a branch or an exception, or it only has
+// approximate flags. Integer arithmetic stays in the block.
+static bool IsLivenessBarrier(const CodeOp &op)
+{
+	const int flags = op.opinfo->flags;
+	if (op.opinfo->type != OPTYPE_INTEGER)
+		return true;
+	if (flags & (FL_ENDBLOCK | FL_CHECKEXCEPTIONS | FL_EVIL | FL_TIMER | FL_USE_FPU | FL_LOADSTORE))
+		return true;
+	// eciwx, ecowx and eieio
+	return !(flags & (FL_OUT_A | FL_OUT_D | FL_SET_CRx));
+}
+
+// Backwards liveness pass over GPRs, CR fields and XER[CA]. Anything still in
+// use at the end of the block or at a barrier is live, so the JIT may skip
+// computing dead flags and drop dead register values instead of storing them.
+static void AnalyzeLiveness(CodeOp *code, int size)
+{
+	// The debugger can stop at any instruction.
+	const bool everything_live = SConfig::GetInstance().m_LocalCoreStartupParameter.bEnableDebugging;
+
+	u32 gpr_live = 0xFFFFFFFF;
+	u8 cr_live = 0xFF;
+	bool ca_live = true;
+	for (int i = size - 1; i >= 0; i--)
+	{
+		CodeOp &op = code[i];
+		const u32 gpr_live_out = gpr_live;
+		op.wantsCR = cr_live;
+		op.wantsCA = ca_live;
+
+		if (everything_live || IsLivenessBarrier(op))
+		{
+			gpr_live = 0xFFFFFFFF;
+			cr_live = 0xFF;
+			ca_live = true;
+		}
+		else
+		{
+			for (s8 reg : op.regsOut)
+			{
+				if (reg >= 0)
+					gpr_live &= ~(1U << reg);
+			}
+			for (s8 reg : op.regsIn)
+			{
+				if (reg >= 0)
+					gpr_live |= 1U << reg;
+			}
+			cr_live &= ~op.outputCR;
+			if (op.outputCA)
+				ca_live = false;
+			if (op.opinfo->flags & FL_READ_CA)
+				ca_live = true;
+		}
+
+		op.gprInUse = gpr_live_out | gpr_live;
+	}
+}
+
 // Does not yet perform inlining - although there are plans for that.
 // Returns the exit address of the next PC
 u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			BlockRegStats *fpa, bool &broken_block, CodeBuffer *buffer,
 			int blockSize, u32* merged_addresses,
-			int capacity_of_merged_addresses, int& size_of_merged_addresses)
+			int capacity_of_merged_addresses, int& size_of_merged_addresses,
+			const BranchHints *branch_hints, bool peek)
 {
 	if (capacity_of_merged_addresses < FUNCTION_FOLLOWING_THRESHOLD) {
 		PanicAlert("Capacity of merged_addresses is too small!");
@@ -317,7 +379,7 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 	int numSystemInstructions = 0;
 	for (int i = 0; i < maxsize; i++)
 	{
-		UGeckoInstruction inst = JitInterface::Read_Opcode_JIT(address);
+		UGeckoInstruction inst = peek ? JitInterface::Peek_Opcode_JIT(address) : JitInterface::Read_Opcode_JIT(address);
 
 		if (inst.hex != 0)
 		{
@@ -333,10 +395,6 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			code[i].skip = false;
 			numCycles += opinfo->numCyclesMinusOne + 1;
 
-			code[i].wantsCR0 = false;
-			code[i].wantsCR1 = false;
-			code[i].wantsPS1 = false;
-
 			int flags = opinfo->flags;
 
 			if (flags & FL_USE_FPU)
@@ -345,21 +403,16 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			if (flags & FL_TIMER)
 				gpa->anyTimer = true;
 
-			// Does the instruction output CR0?
-			if (flags & FL_RC_BIT)
-				code[i].outputCR0 = inst.hex & 1; //todo fix
-			else if ((flags & FL_SET_CRn) && inst.CRFD == 0)
-				code[i].outputCR0 = true;
-			else
-				code[i].outputCR0 = (flags & FL_SET_CR0) ? true : false;
+			// Which CR fields does the instruction output?
+			code[i].outputCR = 0;
+			if (((flags & FL_RC_BIT) && inst.Rc) || (flags & FL_SET_CR0))
+				code[i].outputCR |= 1 << 0;
+			if (((flags & FL_RC_BIT_F) && inst.Rc) || (flags & FL_SET_CR1))
+				code[i].outputCR |= 1 << 1;
+			if (flags & FL_SET_CRn)
+				code[i].outputCR |= 1 << inst.CRFD;
 
-			// Does the instruction output CR1?
-			if (flags & FL_RC_BIT_F)
-				code[i].outputCR1 = inst.hex & 1; //todo fix
-			else if ((flags & FL_SET_CRn) && inst.CRFD == 1)
-				code[i].outputCR1 = true;
-			else
-				code[i].outputCR1 = (flags & FL_SET_CR1) ? true : false;
+			code[i].outputCA = (flags & FL_SET_CA) ? true : false;
 
 			int numOut = 0;
 			int numIn = 0;
@@ -419,12 +472,6 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			case OPTYPE_FPU:
 				break;
 			case OPTYPE_BRANCH:
-				if (code[i].inst.hex == 0x4e800020)
-				{
-					// For analysis purposes, we can assume that blr eats flags.
-					code[i].outputCR0 = true;
-					code[i].outputCR1 = true;
-				}
 				break;
 			case OPTYPE_SYSTEM:
 			case OPTYPE_SYSTEMFP:
@@ -433,6 +480,7 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			}
 
 			bool follow = false;
+			bool hinted = false;
 			u32 destination = 0;
 			if (inst.OPCD == 18 && blockSize > 1)
 			{
@@ -444,6 +492,22 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 				if (destination != blockstart)
 					follow = true;
 			}
+			else if (inst.OPCD == 16 && !inst.LK && branch_hints && blockSize > 1)
+			{
+				// bcx - follow the way it usually goes
+				auto hint = branch_hints->find(address);
+				if (hint != branch_hints->end())
+				{
+					if (!hint->second)
+						destination = address + 4;
+					else if (inst.AA)
+						destination = SignExt16(inst.BD << 2);
+					else
+						destination = address + SignExt16(inst.BD << 2);
+					if (destination != blockstart)
+						follow = hinted = true;
+				}
+			}
 			else if (inst.OPCD == 19 && inst.SUBOP10 == 16 &&
 				(inst.BO & (1 << 4)) && (inst.BO & (1 << 2)) &&
 				returnAddress != 0)
@@ -478,7 +542,9 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			if (numFollows > FUNCTION_FOLLOWING_THRESHOLD)
 				follow = false;
 
-			if (!SConfig::GetInstance().m_LocalCoreStartupParameter.bMergeBlocks) {
+			// Profiled bcx are followed regardless of BlockMerging, which only
+			// enables inlining calls and unconditional branches.
+			if (!hinted && !SConfig::GetInstance().m_LocalCoreStartupParameter.bMergeBlocks) {
 				follow = false;
 			}
 
@@ -538,26 +604,7 @@ u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 		broken_block = true;
 	}
 
-	// Scan for CR0 dependency
-	// assume next block wants CR0 to be safe
-	bool wantsCR0 = true;
-	bool wantsCR1 = true;
-	bool wantsPS1 = true;
-	for (int i = num_inst - 1; i >= 0; i--)
-	{
-		if (code[i].outputCR0)
-			wantsCR0 = false;
-		if (code[i].outputCR1)
-			wantsCR1 = false;
-		if (code[i].outputPS1)
-			wantsPS1 = false;
-		wantsCR0 |= code[i].wantsCR0;
-		wantsCR1 |= code[i].wantsCR1;
-		wantsPS1 |= code[i].wantsPS1;
-		code[i].wantsCR0 = wantsCR0;
-		code[i].wantsCR1 = wantsCR1;
-		code[i].wantsPS1 = wantsPS1;
-	}
+	AnalyzeLiveness(code, num_inst);
 
 	*realsize = num_inst;
 	// ...
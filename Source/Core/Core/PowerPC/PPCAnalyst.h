@@ -31,13 +31,17 @@ struct CodeOp //16B
 	s8 fregOut;
 	s8 fregsIn[3];
 	bool isBranchTarget;
-	bool wantsCR0;
-	bool wantsCR1;
-	bool wantsPS1;
-	bool outputCR0;
-	bool outputCR1;
-	bool outputPS1;
+	bool outputCA;
 	bool skip;  // followed BL-s for example
+	u8 outputCR;  // CR fields written, bit n is crn
+
+	// Liveness, see AnalyzeLiveness. A value is dead if it's overwritten before
+	// anything reads it, and before the block can be left in any way.
+	// Whether XER[CA] and the CR fields might be read after this instruction.
+	bool wantsCA;
+	u8 wantsCR;
+	// GPRs which might be read by this instruction or after it.
+	u32 gprInUse;
 };
 
 struct BlockStats
@@ -94,10 +98,17 @@ public:
 
 };
 
+// Likely direction of profiled conditional branches by their address, true if taken.
+typedef std::map<u32, bool> BranchHints;
+
+// With branch_hints, conditional branches which aren't calls are followed in
+// their likely direction, making superblocks which leave through side exits.
+// With peek, instructions are read without going through the emulated icache.
 u32 Flatten(u32 address, int *realsize, BlockStats *st, BlockRegStats *gpa,
 			BlockRegStats *fpa, bool &broken_block, CodeBuffer *buffer,
 			int blockSize, u32* merged_addresses,
-			int capacity_of_merged_addresses, int& size_of_merged_addresses);
+			int capacity_of_merged_addresses, int& size_of_merged_addresses,
+			const BranchHints *branch_hints = nullptr, bool peek = false);
 void LogFunctionCall(u32 addr);
 void FindFunctions(u32 startAddr, u32 endAddr, PPCSymbolDB *func_db);
 bool AnalyzeFunction(u32 startAddr, Symbol &func, int max_size = 0);
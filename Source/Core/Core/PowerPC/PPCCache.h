@@ -37,6 +37,8 @@ namespace PowerPC
 
 		InstructionCache();
 		u32 ReadInstruction(u32 addr);
+		// Like ReadInstruction, but never loads a block or updates the PLRU bits.
+		u32 PeekInstruction(u32 addr) const;
 		void Invalidate(u32 addr);
 		void Init();
 		void Reset();
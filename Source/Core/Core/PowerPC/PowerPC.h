@@ -25,6 +25,29 @@ enum CoreMode
 	MODE_JIT,
 };
 
+// Software TLB, two way set associative like the Gekko's. Translations are
+// cached per 4 KB page, one TLB for data and one for instruction accesses.
+enum
+{
+	TLB_SIZE = 128,
+	TLB_WAYS = 2,
+	TLB_SETS = TLB_SIZE / TLB_WAYS,
+	NUM_TLBS = 2,
+	TLB_INDEX_DATA = 0,
+	TLB_INDEX_INST = 1,
+	// Tags are page aligned, so this never matches
+	TLB_TAG_INVALID = 1,
+};
+
+struct TLBSet
+{
+	u32 tag[TLB_WAYS];
+	u32 paddr[TLB_WAYS];
+	u32 recent; // the way which was used last
+	u32 padding[3]; // the JIT indexes sets with a shift
+};
+static_assert(sizeof(TLBSet) == 32, "Jit64 depends on the size of TLBSet");
+
 // This contains the entire state of the emulated PowerPC "Gekko" CPU.
 struct GC_ALIGNED64(PowerPCState)
 {
@@ -56,13 +79,7 @@ struct GC_ALIGNED64(PowerPCState)
 	// also for power management, but we don't care about that.
 	u32 spr[1024];
 
-	u32 dtlb_last;
-	u32 dtlb_va[128];
-	u32 dtlb_pa[128];
-
-	u32 itlb_last;
-	u32 itlb_va[128];
-	u32 itlb_pa[128];
+	TLBSet tlb[NUM_TLBS][TLB_SETS];
 
 	u32 pagetable_base;
 	u32 pagetable_hashmask;
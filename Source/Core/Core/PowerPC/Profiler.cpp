@@ -2,7 +2,18 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <cinttypes>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/Profiler.h"
 
 namespace Profiler
 {
@@ -10,9 +21,37 @@ namespace Profiler
 bool g_ProfileBlocks;
 bool g_ProfileInstructions;
 
+#ifdef __linux__
+static File::IOFile s_perf_map_file;
+#endif
+
 void WriteProfileResults(const char *filename)
 {
 	JitInterface::WriteProfileResults(filename);
 }
 
+void RegisterPerfMapBlock(const u8 *start, u32 size, u32 em_address)
+{
+#ifdef __linux__
+	if (!s_perf_map_file)
+	{
+		// Keep the file open for the whole session, perf only reads it when reporting.
+		if (!s_perf_map_file.Open(StringFromFormat("/tmp/perf-%d.map", getpid()), "w"))
+			return;
+	}
+
+	// START SIZE symbolname, see tools/perf/Documentation/jit-interface.txt
+	fprintf(s_perf_map_file.GetHandle(), "%" PRIx64 " %x EmuCode_%08x %s\n",
+	        (u64)(uintptr_t)start, size, em_address, g_symbolDB.GetDescription(em_address));
+	fflush(s_perf_map_file.GetHandle());
+#endif
+}
+
+void ClosePerfMap()
+{
+#ifdef __linux__
+	s_perf_map_file.Close();
+#endif
+}
+
 }  // namespace
@@ -5,9 +5,7 @@
 
 #pragma once
 
-#ifdef _WIN32
-
-#ifdef _M_IX86
+#if defined(_WIN32) && defined(_M_IX86)
 #define PROFILER_QUERY_PERFORMANCE_COUNTER(pt)      \
                     LEA(32, EAX, M(pt)); PUSH(EAX); \
                     CALL(QueryPerformanceCounter)
@@ -27,13 +25,28 @@
 #define PROFILER_VPUSH  PUSH(EAX);PUSH(ECX);PUSH(EDX)
 #define PROFILER_VPOP   POP(EDX);POP(ECX);POP(EAX)
 
-#else
+#elif defined(_M_X64)
 
-#define PROFILER_QUERY_PERFORMANCE_COUNTER(pt)
-#define PROFILER_ADD_DIFF_LARGE_INTEGER(pdt, pt1, pt0)
-#define PROFILER_VPUSH
-#define PROFILER_VPOP
-#endif
+// Counts in RDTSC cycles. The JitBlock array is heap allocated and usually not
+// within RIP range of the code space, so all accesses go through RDX.
+// asm write : (u64) *pt = rdtsc
+#define PROFILER_QUERY_PERFORMANCE_COUNTER(pt)  \
+                    RDTSC();                    \
+                    SHL(64, R(RDX), Imm8(32));  \
+                    OR(64, R(RAX), R(RDX));     \
+                    MOV(64, R(RDX), ImmPtr(pt)); \
+                    MOV(64, MatR(RDX), R(RAX))
+// asm write : (u64) dt += t1-t0
+#define PROFILER_ADD_DIFF_LARGE_INTEGER(pdt, pt1, pt0)  \
+                    MOV(64, R(RDX), ImmPtr(pt1));       \
+                    MOV(64, R(RAX), MatR(RDX));         \
+                    MOV(64, R(RDX), ImmPtr(pt0));       \
+                    SUB(64, R(RAX), MatR(RDX));         \
+                    MOV(64, R(RDX), ImmPtr(pdt));       \
+                    ADD(64, MatR(RDX), R(RAX))
+
+#define PROFILER_VPUSH  PUSH(RAX);PUSH(RDX)
+#define PROFILER_VPOP   POP(RDX);POP(RAX)
 
 #else
 // TODO
@@ -45,12 +58,14 @@
 
 struct BlockStat
 {
-	BlockStat(int bn, u64 c) : blockNum(bn), cost(c) {}
+	BlockStat(int bn, u64 c, u64 tc) : blockNum(bn), cost(c), timeCost(tc) {}
 	int blockNum;
 	u64 cost;
+	u64 timeCost;
 
+	// Hottest first. Measured time wins over the size based estimate.
 	bool operator <(const BlockStat &other) const
-	{ return cost > other.cost; }
+	{ return timeCost > other.timeCost || (timeCost == other.timeCost && cost > other.cost); }
 };
 
 namespace Profiler
@@ -59,4 +74,9 @@ extern bool g_ProfileBlocks;
 extern bool g_ProfileInstructions;
 
 void WriteProfileResults(const char *filename);
+
+// Announces a compiled block to Linux perf through /tmp/perf-<pid>.map,
+// so samples in the code space resolve to guest addresses and symbols.
+void RegisterPerfMapBlock(const u8 *start, u32 size, u32 em_address);
+void ClosePerfMap();
 }
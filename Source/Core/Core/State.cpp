@@ -2,6 +2,9 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <lzo/lzo1x.h>
 
 #include "Common/Common.h"
@@ -12,6 +15,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/DSPEmulator.h"
 #include "Core/Movie.h"
 #include "Core/State.h"
 #include "Core/HW/CPU.h"
@@ -38,12 +42,10 @@ static const u32 IN_LEN = 128 * 1024u;
 
 static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
-static unsigned char __LZO_MMODEL out[OUT_LEN];
-
-#define HEAP_ALLOC(var, size) \
-	lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
-
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+// Compressed states are a sequence of independently compressed IN_LEN sized
+// chunks, each behind its compressed size as a u32. They are compressed and
+// decompressed on all cores, this many chunks per worker thread at a time.
+static const u32 CHUNKS_PER_WORKER = 8;
 
 static std::string g_last_filename;
 
@@ -61,7 +63,7 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::thread g_save_thread;
 
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 22;
+static const u32 STATE_VERSION = 23;
 
 enum
 {
@@ -72,11 +74,47 @@ enum
 
 static bool g_use_compression = true;
 
+// Rewind buffer
+//
+// Every iRewindInterval ms of emulated time, at the end of the next field, the
+// CPU thread serializes the state into s_rewind_capture once CoreTiming is done
+// advancing, and hands it to the rewind thread. That one either keeps it as the
+// new keyframe, or only stores the pages which differ from the current keyframe,
+// so that any entry can be restored from its keyframe and itself. Entries are
+// LZO compressed, and dropped a keyframe group at a time, oldest first, once
+// they take up more than iRewindMemory MB.
+static const u32 REWIND_PAGE_SIZE = 4096;
+// Keyframe groups have to stay small enough for the budget to be able to drop them
+static const u32 REWIND_KEYFRAME_INTERVAL = 30;
+
+static int s_ev_rewind;
+// Only used on the CPU thread: the interval passed, and then a field ended
+static bool s_rewind_capture_due = false;
+static bool s_rewind_capture_ready = false;
+static std::thread s_rewind_thread;
+static std::mutex s_rewind_mutex; // guards everything below
+static std::condition_variable s_rewind_cond;
+static bool s_rewind_running = false;
+// s_rewind_capture belongs to the rewind thread while this is set
+static bool s_rewind_pending = false;
+static bool s_rewind_need_keyframe = true;
+static std::vector<u8> s_rewind_capture;
+static std::vector<u8> s_rewind_keyframe; // only used by the rewind thread
+static u32 s_rewind_deltas = 0;
+static std::deque<RewindEntry> s_rewind_entries;
+static size_t s_rewind_memory = 0;
+
 void EnableCompression(bool compression)
 {
 	g_use_compression = compression;
 }
 
+static int GetRewindInterval()
+{
+	const int interval_ms = std::max(SConfig::GetInstance().m_LocalCoreStartupParameter.iRewindInterval, 1);
+	return (int)std::min<u64>((u64)SystemTimers::GetTicksPerSecond() * interval_ms / 1000, 0x7FFFFFFF);
+}
+
 void DoState(PointerWrap &p)
 {
 	u32 version = STATE_VERSION;
@@ -103,7 +141,7 @@ void DoState(PointerWrap &p)
 	p.DoMarker("video_backend");
 
 	if (Core::g_CoreStartupParameter.bWii)
-		Wiimote::DoState(p.GetPPtr(), p.GetMode());
+		Wiimote::DoState(p);
 	p.DoMarker("Wiimote");
 
 	PowerPC::DoState(p);
@@ -112,6 +150,11 @@ void DoState(PointerWrap &p)
 	p.DoMarker("HW");
 	CoreTiming::DoState(p);
 	p.DoMarker("CoreTiming");
+
+	// Keep capturing after loading a state which was saved without the rewind buffer
+	if (p.GetMode() == PointerWrap::MODE_READ && s_rewind_running && !CoreTiming::IsScheduled(s_ev_rewind))
+		CoreTiming::ScheduleEvent(GetRewindInterval(), s_ev_rewind);
+
 	Movie::DoState(p);
 	p.DoMarker("Movie");
 }
@@ -198,6 +241,82 @@ std::map<double, int> GetSavedStates()
 	return m;
 }
 
+// Compresses src into dst as a sequence of independently compressed IN_LEN
+// sized chunks, each behind its compressed size as a u32.
+static void CompressChunks(const u8* src, size_t size, std::vector<u8>& dst, u32 num_workers)
+{
+	const u32 num_chunks = (u32)((size + IN_LEN - 1) / IN_LEN);
+	const u32 batch_size = num_workers * CHUNKS_PER_WORKER;
+
+	std::vector<std::vector<u8>> work(num_workers, std::vector<u8>(LZO1X_1_MEM_COMPRESS));
+	std::vector<std::vector<u8>> out(std::min(batch_size, num_chunks), std::vector<u8>(OUT_LEN));
+	std::vector<lzo_uint> out_len(out.size());
+
+	dst.clear();
+	for (u32 first = 0; first < num_chunks; first += batch_size)
+	{
+		const u32 count = std::min(batch_size, num_chunks - first);
+		Common::ParallelFor(num_workers, count, [&](u32 j) {
+			const size_t offset = (size_t)(first + j) * IN_LEN;
+			const lzo_uint32 cur_len = (lzo_uint32)std::min<size_t>(IN_LEN, size - offset);
+			if (lzo1x_1_compress(src + offset, cur_len, &out[j][0], &out_len[j], &work[j % num_workers][0]) != LZO_E_OK)
+				PanicAlertT("Internal LZO Error - compression failed");
+		});
+
+		for (u32 j = 0; j < count; j++)
+		{
+			const lzo_uint32 chunk_len = (lzo_uint32)out_len[j];
+			const size_t pos = dst.size();
+			dst.resize(pos + sizeof(chunk_len) + chunk_len);
+			memcpy(&dst[pos], &chunk_len, sizeof(chunk_len));
+			memcpy(&dst[pos + sizeof(chunk_len)], &out[j][0], chunk_len);
+		}
+	}
+	dst.shrink_to_fit();
+}
+
+// Chunk k decompresses to the k-th IN_LEN bytes of dst. Older versions can
+// end with an empty chunk if the size is a multiple of IN_LEN. Returns an LZO
+// error code.
+static int DecompressChunks(const u8* src, size_t src_size, u8* dst, size_t size, u32 num_workers)
+{
+	std::vector<size_t> chunk_offsets;
+	std::vector<lzo_uint32> chunk_lens;
+	for (size_t pos = 0; pos + sizeof(lzo_uint32) <= src_size;)
+	{
+		lzo_uint32 chunk_len;
+		memcpy(&chunk_len, &src[pos], sizeof(chunk_len));
+		pos += sizeof(chunk_len);
+		if (pos + chunk_len > src_size)
+			break;
+
+		chunk_offsets.push_back(pos);
+		chunk_lens.push_back(chunk_len);
+		pos += chunk_len;
+	}
+	if ((size_t)chunk_offsets.size() * IN_LEN < size)
+		return LZO_E_INPUT_OVERRUN;
+
+	std::vector<int> results(chunk_offsets.size(), LZO_E_OK);
+	Common::ParallelFor(num_workers, (u32)chunk_offsets.size(), [&](u32 k) {
+		const size_t offset = (size_t)k * IN_LEN;
+		const size_t expected_len = offset < size ? std::min<size_t>(IN_LEN, size - offset) : 0;
+		u8 empty;
+		lzo_uint new_len = expected_len;
+		results[k] = lzo1x_decompress_safe(&src[chunk_offsets[k]], chunk_lens[k],
+			expected_len ? dst + offset : &empty, &new_len, NULL);
+		if (results[k] == LZO_E_OK && new_len != expected_len)
+			results[k] = LZO_E_ERROR;
+	});
+
+	for (int result : results)
+	{
+		if (result != LZO_E_OK)
+			return result;
+	}
+	return LZO_E_OK;
+}
+
 struct CompressAndDumpState_args
 {
 	std::vector<u8>* buffer_vector;
@@ -219,6 +338,8 @@ void CompressAndDumpState(CompressAndDumpState_args save_args)
 	// For easy debugging
 	Common::SetCurrentThreadName("SaveState thread");
 
+	const u32 start_time = Common::Timer::GetTimeMs();
+
 	// Moving to last overwritten save-state
 	if (File::Exists(filename))
 	{
@@ -256,39 +377,18 @@ void CompressAndDumpState(CompressAndDumpState_args save_args)
 
 	if (header.size != 0) // non-zero header size means the state is compressed
 	{
-		lzo_uint i = 0;
-		while (true)
-		{
-			lzo_uint32 cur_len = 0;
-			lzo_uint out_len = 0;
-
-			if ((i + IN_LEN) >= buffer_size)
-			{
-				cur_len = (lzo_uint32)(buffer_size - i);
-			}
-			else
-			{
-				cur_len = IN_LEN;
-			}
-
-			if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-				PanicAlertT("Internal LZO Error - compression failed");
-
-			// The size of the data to write is 'out_len'
-			f.WriteArray((lzo_uint32*)&out_len, 1);
-			f.WriteBytes(out, out_len);
-
-			if (cur_len != IN_LEN)
-				break;
-
-			i += cur_len;
-		}
+		std::vector<u8> compressed;
+		CompressChunks(buffer_data, buffer_size, compressed, Common::GetNumHardwareThreads());
+		f.WriteBytes(compressed.data(), compressed.size());
 	}
 	else // uncompressed
 	{
 		f.WriteBytes(buffer_data, buffer_size);
 	}
 
+	NOTICE_LOG(COMMON, "Wrote state %s: %u bytes in %u ms", filename.c_str(),
+		(u32)buffer_size, (u32)(Common::Timer::GetTimeMs() - start_time));
+
 	Core::DisplayMessage(StringFromFormat("Saved State to %s",
 		filename.c_str()).c_str(), 2000);
 	g_compressAndDumpStateSyncEvent.Set();
@@ -357,6 +457,7 @@ bool ReadHeader(const std::string filename, StateHeader& header)
 void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
 {
 	Flush();
+	const u32 start_time = Common::Timer::GetTimeMs();
 	File::IOFile f(filename, "rb");
 	if (!f)
 	{
@@ -380,29 +481,31 @@ void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
 	{
 		Core::DisplayMessage("Decompressing State...", 500);
 
-		buffer.resize(header.size);
-
-		lzo_uint i = 0;
-		while (true)
+		std::vector<u8> compressed((size_t)(f.GetSize() - sizeof(StateHeader)));
+		if (!compressed.empty() && !f.ReadBytes(&compressed[0], compressed.size()))
 		{
-			lzo_uint32 cur_len = 0;  // number of bytes to read
-			lzo_uint new_len = 0;  // number of bytes to write
-
-			if (!f.ReadArray(&cur_len, 1))
-				break;
+			PanicAlertT("Failed to read state %s", filename.c_str());
+			return;
+		}
 
-			f.ReadBytes(out, cur_len);
-			const int res = lzo1x_decompress(out, cur_len, &buffer[i], &new_len, NULL);
-			if (res != LZO_E_OK)
-			{
-				// This doesn't seem to happen anymore.
-				PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
-					"Try loading the state again", res, i, new_len);
-				return;
-			}
+		buffer.resize(header.size);
 
-			i += new_len;
+		const int result = DecompressChunks(compressed.data(), compressed.size(), buffer.data(), buffer.size(),
+			Common::GetNumHardwareThreads());
+		if (result == LZO_E_INPUT_OVERRUN)
+		{
+			PanicAlertT("State %s is truncated", filename.c_str());
+			return;
+		}
+		if (result != LZO_E_OK)
+		{
+			PanicAlertT("Internal LZO Error - decompression failed (%d)\n"
+				"Try loading the state again", result);
+			return;
 		}
+
+		NOTICE_LOG(COMMON, "Read state %s: %u bytes in %u ms", filename.c_str(),
+			header.size, (u32)(Common::Timer::GetTimeMs() - start_time));
 	}
 	else // uncompressed
 	{
@@ -529,17 +632,303 @@ void VerifyAt(const std::string& filename)
 	Core::PauseAndLock(false, wasUnpaused);
 }
 
+void MakeRewindEntry(const std::vector<u8>& state, const std::vector<u8>* keyframe, RewindEntry& entry)
+{
+	const size_t size = state.size();
+	entry.state_size = (u32)size;
+	entry.keyframe = !keyframe || keyframe->size() != size;
+	entry.pages.clear();
+
+	std::vector<u8> changed;
+	if (!entry.keyframe)
+	{
+		for (size_t offset = 0; offset < size; offset += REWIND_PAGE_SIZE)
+		{
+			const size_t len = std::min<size_t>(REWIND_PAGE_SIZE, size - offset);
+			if (memcmp(&state[offset], &(*keyframe)[offset], len))
+			{
+				entry.pages.push_back((u32)(offset / REWIND_PAGE_SIZE));
+				changed.insert(changed.end(), state.begin() + offset, state.begin() + offset + len);
+			}
+		}
+
+		// Not worth it anymore, the next deltas would only get bigger
+		if (changed.size() > size / 2)
+		{
+			entry.keyframe = true;
+			entry.pages.clear();
+		}
+	}
+
+	// In the background, so leave the other cores to the emulation
+	if (entry.keyframe)
+		CompressChunks(state.data(), size, entry.data, 1);
+	else
+		CompressChunks(changed.data(), changed.size(), entry.data, 1);
+	entry.pages.shrink_to_fit();
+}
+
+bool RestoreRewindEntry(const std::deque<RewindEntry>& entries, size_t index, std::vector<u8>& buffer)
+{
+	const u32 num_workers = Common::GetNumHardwareThreads();
+	const RewindEntry& entry = entries[index];
+	buffer.resize(entry.state_size);
+
+	size_t keyframe_index = index;
+	while (!entries[keyframe_index].keyframe)
+	{
+		if (keyframe_index == 0)
+			return false;
+		--keyframe_index;
+	}
+	const RewindEntry& keyframe = entries[keyframe_index];
+	if (keyframe.state_size != entry.state_size ||
+	    DecompressChunks(keyframe.data.data(), keyframe.data.size(), buffer.data(), buffer.size(), num_workers) != LZO_E_OK)
+		return false;
+
+	if (entry.keyframe || entry.pages.empty())
+		return true;
+
+	// Only the last page of the state can be partial
+	const size_t last_offset = (size_t)entry.pages.back() * REWIND_PAGE_SIZE;
+	if (last_offset >= buffer.size())
+		return false;
+	std::vector<u8> changed((entry.pages.size() - 1) * REWIND_PAGE_SIZE +
+		std::min<size_t>(REWIND_PAGE_SIZE, buffer.size() - last_offset));
+	if (DecompressChunks(entry.data.data(), entry.data.size(), changed.data(), changed.size(), num_workers) != LZO_E_OK)
+		return false;
+
+	for (size_t i = 0; i < entry.pages.size(); ++i)
+	{
+		const size_t offset = (size_t)entry.pages[i] * REWIND_PAGE_SIZE;
+		const size_t len = std::min<size_t>(REWIND_PAGE_SIZE, buffer.size() - offset);
+		memcpy(&buffer[offset], &changed[i * REWIND_PAGE_SIZE], len);
+	}
+	return true;
+}
+
+static void RewindThread()
+{
+	Common::SetCurrentThreadName("Rewind thread");
+
+	std::unique_lock<std::mutex> lk(s_rewind_mutex);
+	while (true)
+	{
+		s_rewind_cond.wait(lk, []{ return s_rewind_pending || !s_rewind_running; });
+		if (!s_rewind_running)
+			break;
+
+		const bool force_keyframe = s_rewind_need_keyframe || s_rewind_deltas >= REWIND_KEYFRAME_INTERVAL;
+		lk.unlock();
+
+		RewindEntry entry;
+		MakeRewindEntry(s_rewind_capture, force_keyframe ? nullptr : &s_rewind_keyframe, entry);
+
+		lk.lock();
+		if (entry.keyframe)
+		{
+			// The old keyframe's buffer takes the next capture
+			s_rewind_keyframe.swap(s_rewind_capture);
+			s_rewind_need_keyframe = false;
+			s_rewind_deltas = 0;
+		}
+		else
+		{
+			++s_rewind_deltas;
+		}
+
+		s_rewind_memory += entry.GetMemoryUsage();
+		s_rewind_entries.push_back(std::move(entry));
+
+		// Drop the oldest keyframe group, but never the one the new entry belongs to
+		const size_t budget = (size_t)std::max(SConfig::GetInstance().m_LocalCoreStartupParameter.iRewindMemory, 0) * 1024 * 1024;
+		while (s_rewind_memory > budget)
+		{
+			auto next_keyframe = std::find_if(s_rewind_entries.begin() + 1, s_rewind_entries.end(),
+				[](const RewindEntry& e) { return e.keyframe; });
+			if (next_keyframe == s_rewind_entries.end())
+				break;
+
+			for (auto it = s_rewind_entries.begin(); it != next_keyframe; ++it)
+				s_rewind_memory -= it->GetMemoryUsage();
+			s_rewind_entries.erase(s_rewind_entries.begin(), next_keyframe);
+		}
+
+		s_rewind_pending = false;
+		s_rewind_cond.notify_all();
+	}
+}
+
+static void RewindCaptureCallback(u64 userdata, int cyclesLate)
+{
+	if (!s_rewind_running)
+		return;
+
+	// Before capturing, so that the rewound state keeps capturing as well
+	CoreTiming::ScheduleEvent(GetRewindInterval() - cyclesLate, s_ev_rewind);
+	s_rewind_capture_due = true;
+}
+
+void OnFrameEnd()
+{
+	if (s_rewind_capture_due)
+	{
+		s_rewind_capture_due = false;
+		s_rewind_capture_ready = true;
+	}
+}
+
+// Serializes the state into s_rewind_capture, reusing its memory. The state
+// is only measured when it doesn't fit in there anymore.
+static bool CaptureRewindState()
+{
+	s_rewind_capture.resize(std::max<size_t>(s_rewind_capture.capacity(), 1));
+	while (true)
+	{
+		u8* const begin = &s_rewind_capture[0];
+		u8* ptr = begin;
+		PointerWrap p(&ptr, PointerWrap::MODE_WRITE, begin + s_rewind_capture.size());
+		DoState(p);
+
+		const size_t size = ptr - begin;
+		if (p.GetMode() == PointerWrap::MODE_WRITE)
+		{
+			s_rewind_capture.resize(size);
+			return true;
+		}
+		if (size <= s_rewind_capture.size())
+			return false;
+		s_rewind_capture.resize(size);
+	}
+}
+
+// Runs at the end of CoreTiming::Advance, so that the captured downcount and
+// slice length are the ones a normal savestate would contain.
+static void RewindAdvanceCallback(int cyclesExecuted)
+{
+	if (!s_rewind_capture_ready)
+		return;
+	s_rewind_capture_ready = false;
+
+	{
+		// Rather skip a capture than stall the CPU thread if the last one isn't done yet
+		std::lock_guard<std::mutex> lk(s_rewind_mutex);
+		if (s_rewind_pending)
+			return;
+	}
+
+	// Only the threads whose state DoState reads have to stop, unlike for
+	// Core::PauseAndLock the CPU thread is this one and audio isn't saved.
+	DSP::GetDSPEmulator()->PauseAndLock(true, false);
+	g_video_backend->PauseAndLock(true, false);
+	const bool captured = CaptureRewindState();
+	g_video_backend->PauseAndLock(false, true);
+	DSP::GetDSPEmulator()->PauseAndLock(false, true);
+
+	if (captured)
+	{
+		std::lock_guard<std::mutex> lk(s_rewind_mutex);
+		s_rewind_pending = true;
+		s_rewind_cond.notify_all();
+	}
+}
+
+bool Rewind()
+{
+	bool wasUnpaused = Core::PauseAndLock(true);
+
+	bool loaded = false;
+	{
+		std::unique_lock<std::mutex> lk(s_rewind_mutex);
+		s_rewind_cond.wait(lk, []{ return !s_rewind_pending; });
+
+		if (!s_rewind_entries.empty())
+		{
+			std::vector<u8> buffer;
+			if (RestoreRewindEntry(s_rewind_entries, s_rewind_entries.size() - 1, buffer))
+			{
+				u8* ptr = &buffer[0];
+				PointerWrap p(&ptr, PointerWrap::MODE_READ);
+				DoState(p);
+				loaded = (p.GetMode() == PointerWrap::MODE_READ);
+			}
+
+			s_rewind_memory -= s_rewind_entries.back().GetMemoryUsage();
+			s_rewind_entries.pop_back();
+
+			// The keyframe of the next captures may have been dropped
+			s_rewind_need_keyframe = true;
+		}
+	}
+
+	// Captures which were due belong to the timeline rewound from
+	s_rewind_capture_due = false;
+	s_rewind_capture_ready = false;
+
+	if (loaded)
+	{
+		Core::DisplayMessage("Rewound", 1000);
+		if (g_onAfterLoadCb)
+			g_onAfterLoadCb();
+	}
+	else
+	{
+		Core::DisplayMessage("Nothing to rewind", 2000);
+	}
+
+	Core::PauseAndLock(false, wasUnpaused);
+	return loaded;
+}
+
+size_t GetRewindStateCount()
+{
+	std::lock_guard<std::mutex> lk(s_rewind_mutex);
+	return s_rewind_entries.size();
+}
 
 void Init()
 {
 	if (lzo_init() != LZO_E_OK)
 		PanicAlertT("Internal LZO Error - lzo_init() failed");
+
+	s_ev_rewind = CoreTiming::RegisterEvent("RewindCapture", RewindCaptureCallback);
+	if (SConfig::GetInstance().m_LocalCoreStartupParameter.bRewind)
+	{
+		s_rewind_running = true;
+		s_rewind_need_keyframe = true;
+		s_rewind_capture_due = false;
+		s_rewind_capture_ready = false;
+		s_rewind_thread = std::thread(RewindThread);
+		CoreTiming::RegisterAdvanceCallback(RewindAdvanceCallback);
+		CoreTiming::ScheduleEvent(GetRewindInterval(), s_ev_rewind);
+	}
 }
 
 void Shutdown()
 {
 	Flush();
 
+	if (s_rewind_thread.joinable())
+	{
+		CoreTiming::RegisterAdvanceCallback(NULL);
+		{
+			std::lock_guard<std::mutex> lk(s_rewind_mutex);
+			s_rewind_running = false;
+			s_rewind_cond.notify_all();
+		}
+		s_rewind_thread.join();
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(s_rewind_mutex);
+		s_rewind_pending = false;
+		s_rewind_deltas = 0;
+		s_rewind_memory = 0;
+		std::deque<RewindEntry>().swap(s_rewind_entries);
+		std::vector<u8>().swap(s_rewind_capture);
+		std::vector<u8>().swap(s_rewind_keyframe);
+	}
+
 	// swapping with an empty vector, rather than clear()ing
 	// this gives a better guarantee to free the allocated memory right NOW (as opposed to, actually, never)
 	{
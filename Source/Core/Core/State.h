@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -56,6 +57,33 @@ void UndoLoadState();
 // wait until previously scheduled savestate event (if any) is done
 void Flush();
 
+// Rewind buffer, enabled by SCoreStartupParameter::bRewind.
+// Rewind loads the newest state in the buffer and drops it, so that calling it
+// again steps further back. Returns false if the buffer is empty.
+bool Rewind();
+size_t GetRewindStateCount();
+
+// Called by the VI at the end of every field, on the CPU thread.
+void OnFrameEnd();
+
+// An entry of the rewind buffer. Keyframes hold the whole state, the others
+// only the pages which differ from the last keyframe before them.
+struct RewindEntry
+{
+	bool keyframe;
+	u32 state_size;
+	std::vector<u32> pages; // indices of the pages stored in data, for deltas
+	std::vector<u8> data; // LZO chunks, like in state files
+
+	size_t GetMemoryUsage() const { return sizeof(*this) + pages.size() * sizeof(u32) + data.size(); }
+};
+
+// Encodes state as a delta against keyframe, or as a keyframe if there is none
+// or the delta wouldn't be much smaller.
+void MakeRewindEntry(const std::vector<u8>& state, const std::vector<u8>* keyframe, RewindEntry& entry);
+// Decodes entries[index] into buffer, with the help of its keyframe.
+bool RestoreRewindEntry(const std::deque<RewindEntry>& entries, size_t index, std::vector<u8>& buffer);
+
 // for calling back into UI code without introducing a dependency on it in core
 typedef void(*CallbackFunc)(void);
 void SetOnAfterLoadCallback(CallbackFunc callback);
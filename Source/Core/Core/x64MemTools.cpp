@@ -43,6 +43,10 @@ void print_trace(const char * msg)
 
 bool DoFault(u64 bad_address, SContext *ctx)
 {
+	// Writes to pages protected for Memory::TrackWrites can come from any code on any thread.
+	if (Memory::HandleWriteFault((uintptr_t)bad_address))
+		return true;
+
 	if (!JitInterface::IsInCodeSpace((u8*) ctx->CTX_PC))
 	{
 		// Let's not prevent debugging.
@@ -2,6 +2,7 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <string>
@@ -23,33 +24,161 @@ namespace DiscIO
 // Provides caching and split-operation-to-block-operations facilities.
 // Used for compressed blob reading and direct drive reading.
 
+static const u64 NO_READ_AHEAD = (u64)(s64)-1;
+
+u32 SectorReader::s_cache_size = 16 * 1024 * 1024;
+u32 SectorReader::s_read_ahead_blocks = 8;
+
+void SectorReader::SetCacheLimits(u32 cache_size, u32 read_ahead_blocks)
+{
+	s_cache_size = cache_size;
+	s_read_ahead_blocks = read_ahead_blocks;
+}
+
+SectorReader::SectorReader()
+	: m_blocksize(0), m_max_entries(0), m_last_block(NO_READ_AHEAD),
+	  m_read_ahead_blocks(0), m_read_ahead_target(NO_READ_AHEAD), m_read_ahead_exit(false)
+{
+}
+
 void SectorReader::SetSectorSize(int blocksize)
 {
-	for (int i = 0; i < CACHE_SIZE; i++)
+	m_blocksize = blocksize;
+	m_read_ahead_blocks = s_read_ahead_blocks;
+
+	// The read-ahead thread inserts blocks while the reading thread may still hold a
+	// pointer from GetBlockData, keep enough entries around that it is never evicted.
+	m_max_entries = std::max<u32>(s_cache_size / blocksize, 2 * m_read_ahead_blocks + 2);
+}
+
+SectorReader::~SectorReader()
+{
+	StopReadAhead();
+	for (CacheEntry& entry : m_cache)
+		delete [] entry.data;
+}
+
+void SectorReader::EnableReadAhead()
+{
+	if (m_read_ahead_blocks == 0 || m_read_ahead_thread.joinable())
+		return;
+
+	m_read_ahead_exit = false;
+	m_read_ahead_thread = std::thread(&SectorReader::ReadAheadThread, this);
+}
+
+void SectorReader::StopReadAhead()
+{
+	if (!m_read_ahead_thread.joinable())
+		return;
+
 	{
-		cache[i] = new u8[blocksize];
-		cache_tags[i] = (u64)(s64) - 1;
+		std::lock_guard<std::mutex> lk(m_cache_lock);
+		m_read_ahead_exit = true;
 	}
-	m_blocksize = blocksize;
+	m_read_ahead_cond.notify_one();
+	m_read_ahead_thread.join();
 }
 
-SectorReader::~SectorReader() {
-	for (int i = 0; i < CACHE_SIZE; i++)
-		delete [] cache[i];
+u8* SectorReader::FindCachedBlock(u64 block_num)
+{
+	std::lock_guard<std::mutex> lk(m_cache_lock);
+	auto it = m_cache_map.find(block_num);
+	if (it == m_cache_map.end())
+		return nullptr;
+
+	m_cache.splice(m_cache.begin(), m_cache, it->second);
+	return it->second->data;
+}
+
+u8* SectorReader::LoadBlock(u64 block_num)
+{
+	u8* data;
+	{
+		std::lock_guard<std::mutex> lk(m_cache_lock);
+		if (m_cache.size() < m_max_entries)
+		{
+			data = new u8[m_blocksize];
+		}
+		else
+		{
+			data = m_cache.back().data;
+			m_cache_map.erase(m_cache.back().block_num);
+			m_cache.pop_back();
+		}
+	}
+
+	GetBlock(block_num, data);
+
+	std::lock_guard<std::mutex> lk(m_cache_lock);
+	CacheEntry entry = { block_num, data };
+	m_cache.push_front(entry);
+	m_cache_map[block_num] = m_cache.begin();
+	return data;
 }
 
 const u8 *SectorReader::GetBlockData(u64 block_num)
 {
-	// TODO : Expand usage of the cache to more than one block :P
-	if (cache_tags[0] == block_num)
+	u8* data = FindCachedBlock(block_num);
+	if (!data)
+	{
+		std::lock_guard<std::mutex> lk(m_block_lock);
+		// The read-ahead thread may have loaded it while we waited for the lock.
+		data = FindCachedBlock(block_num);
+		if (!data)
+			data = LoadBlock(block_num);
+	}
+
+	if (m_read_ahead_thread.joinable() && block_num == m_last_block + 1)
 	{
-		return cache[0];
+		{
+			std::lock_guard<std::mutex> lk(m_cache_lock);
+			m_read_ahead_target = block_num + 1;
+		}
+		m_read_ahead_cond.notify_one();
 	}
-	else
+	m_last_block = block_num;
+
+	return data;
+}
+
+void SectorReader::ReadAheadThread()
+{
+	Common::SetCurrentThreadName("Disc read-ahead");
+
+	const u64 num_blocks = (GetDataSize() + m_blocksize - 1) / m_blocksize;
+
+	std::unique_lock<std::mutex> lk(m_cache_lock);
+	while (true)
 	{
-		GetBlock(block_num, cache[0]);
-		cache_tags[0] = block_num;
-		return cache[0];
+		while (!m_read_ahead_exit && m_read_ahead_target == NO_READ_AHEAD)
+			m_read_ahead_cond.wait(lk);
+		if (m_read_ahead_exit)
+			break;
+
+		u64 block = m_read_ahead_target;
+		const u64 end = std::min(block + m_read_ahead_blocks, num_blocks);
+		m_read_ahead_target = NO_READ_AHEAD;
+
+		// Stop early when the reader moved on or we are shutting down.
+		for (; block < end && !m_read_ahead_exit && m_read_ahead_target == NO_READ_AHEAD; block++)
+		{
+			if (m_cache_map.count(block))
+				continue;
+
+			lk.unlock();
+			{
+				std::lock_guard<std::mutex> block_lk(m_block_lock);
+				bool cached;
+				{
+					std::lock_guard<std::mutex> cache_lk(m_cache_lock);
+					cached = m_cache_map.count(block) != 0;
+				}
+				if (!cached)
+					LoadBlock(block);
+			}
+			lk.lock();
+		}
 	}
 }
 
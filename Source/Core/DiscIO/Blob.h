@@ -14,7 +14,11 @@
 // detect whether the file is a compressed blob, or just a big hunk of data, or a drive, and
 // automatically do the right thing.
 
+#include <list>
+#include <unordered_map>
+
 #include "Common/CommonTypes.h"
+#include "Common/Thread.h"
 
 namespace DiscIO
 {
@@ -36,19 +40,52 @@ protected:
 
 // Provides caching and split-operation-to-block-operations facilities.
 // Used for compressed blob reading and direct drive reading.
-// Currently only uses a single entry cache.
-// Multi-block reads are not cached.
+// Decoded blocks are kept in an LRU cache whose size is bounded by SetCacheLimits.
+// Subclasses whose GetBlock is expensive can call EnableReadAhead, which starts a
+// thread that decodes the blocks following a sequential stream of reads before
+// they are requested. GetBlock is then called from that thread as well, but never
+// concurrently with itself. Such subclasses must call StopReadAhead in their
+// destructor, before any state GetBlock uses is torn down.
+// Reads going through an overridden ReadMultipleAlignedBlocks are not cached.
 class SectorReader : public IBlobReader
 {
 private:
-	enum { CACHE_SIZE = 32 };
+	struct CacheEntry
+	{
+		u64 block_num;
+		u8* data;
+	};
+	typedef std::list<CacheEntry> CacheList;
+
 	int m_blocksize;
-	u8* cache[CACHE_SIZE];
-	u64 cache_tags[CACHE_SIZE];
-	int cache_age[CACHE_SIZE];
+	u32 m_max_entries;
+	// Most recently used entry first.
+	CacheList m_cache;
+	std::unordered_map<u64, CacheList::iterator> m_cache_map;
+	std::mutex m_cache_lock;
+	// Serializes GetBlock between the reading thread and the read-ahead thread.
+	std::mutex m_block_lock;
+
+	u64 m_last_block;
+	u32 m_read_ahead_blocks;
+	u64 m_read_ahead_target;
+	bool m_read_ahead_exit;
+	std::thread m_read_ahead_thread;
+	std::condition_variable m_read_ahead_cond;
+
+	static u32 s_cache_size;
+	static u32 s_read_ahead_blocks;
+
+	u8* FindCachedBlock(u64 block_num);
+	// Must be called with m_block_lock held.
+	u8* LoadBlock(u64 block_num);
+	void ReadAheadThread();
 
 protected:
+	SectorReader();
 	void SetSectorSize(int blocksize);
+	void EnableReadAhead();
+	void StopReadAhead();
 	virtual void GetBlock(u64 block_num, u8 *out) = 0;
 	// This one is uncached. The default implementation is to simply call GetBlockData multiple times and memcpy.
 	virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8 *out_ptr);
@@ -56,7 +93,13 @@ protected:
 public:
 	virtual ~SectorReader();
 
-	// A pointer returned by GetBlockData is invalidated as soon as GetBlockData, Read, or ReadMultipleAlignedBlocks is called again.
+	// Applies to readers created afterwards. cache_size is the budget in bytes for the
+	// block cache of each reader, read_ahead_blocks how many blocks ahead of a
+	// sequential read are decoded in the background (0 disables read-ahead).
+	static void SetCacheLimits(u32 cache_size, u32 read_ahead_blocks);
+
+	// A pointer returned by GetBlockData stays valid until the block is evicted from the
+	// cache, which won't happen before GetBlockData, Read, or ReadMultipleAlignedBlocks is called again.
 	const u8 *GetBlockData(u64 block_num);
 	virtual bool Read(u64 offset, u64 size, u8 *out_ptr);
 	friend class DriveReader;
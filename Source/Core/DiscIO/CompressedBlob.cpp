@@ -12,11 +12,13 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
 #include <zlib.h>
 
 #include "Common/Common.h"
 #include "Common/FileUtil.h"
 #include "Common/Hash.h"
+#include "Common/Thread.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/CompressedBlob.h"
 #include "DiscIO/DiscScrubber.h"
@@ -25,6 +27,97 @@
 namespace DiscIO
 {
 
+// Blocks in flight per worker thread in the compression and decompression
+// pipelines, which bounds their memory use.
+static const u32 BLOCKS_PER_WORKER = 4;
+
+// Runs read(i, slot) for every block in order on a reader thread, process(i, slot)
+// on num_workers long-lived worker threads, and write(i, slot) in order on the
+// calling thread, so that I/O overlaps with processing. Block i uses slot
+// i % num_slots, and the reader waits for the writer to free a slot before
+// reusing it. Stops early and returns false if write returns false.
+template <typename Read, typename Process, typename Write>
+static bool RunBlockPipeline(u32 num_blocks, u32 num_workers, u32 num_slots,
+                             Read read, Process process, Write write)
+{
+	std::mutex mutex;
+	std::condition_variable read_cond, work_cond, write_cond;
+	std::vector<bool> processed(num_slots, false);
+	u32 num_read = 0, num_claimed = 0, num_written = 0;
+	bool stop = false;
+
+	std::thread reader([&]() {
+		Common::SetCurrentThreadName("Blob reader");
+		for (u32 i = 0; i < num_blocks; i++)
+		{
+			{
+				std::unique_lock<std::mutex> lk(mutex);
+				read_cond.wait(lk, [&]{ return stop || i - num_written < num_slots; });
+				if (stop)
+					return;
+			}
+			read(i, i % num_slots);
+			{
+				std::lock_guard<std::mutex> lk(mutex);
+				num_read = i + 1;
+			}
+			work_cond.notify_one();
+		}
+	});
+
+	std::vector<std::thread> workers;
+	for (u32 t = 0; t < num_workers; t++)
+	{
+		workers.push_back(std::thread([&]() {
+			Common::SetCurrentThreadName("Blob worker");
+			while (true)
+			{
+				u32 i;
+				{
+					std::unique_lock<std::mutex> lk(mutex);
+					work_cond.wait(lk, [&]{ return stop || num_claimed < num_read; });
+					if (stop)
+						return;
+					i = num_claimed++;
+				}
+				process(i, i % num_slots);
+				{
+					std::lock_guard<std::mutex> lk(mutex);
+					processed[i % num_slots] = true;
+				}
+				write_cond.notify_one();
+			}
+		}));
+	}
+
+	bool success = true;
+	for (u32 i = 0; i < num_blocks && success; i++)
+	{
+		{
+			std::unique_lock<std::mutex> lk(mutex);
+			write_cond.wait(lk, [&]{ return processed[i % num_slots]; });
+		}
+		success = write(i, i % num_slots);
+		{
+			std::lock_guard<std::mutex> lk(mutex);
+			processed[i % num_slots] = false;
+			num_written = i + 1;
+		}
+		read_cond.notify_one();
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(mutex);
+		stop = true;
+	}
+	read_cond.notify_all();
+	work_cond.notify_all();
+	reader.join();
+	for (auto& worker : workers)
+		worker.join();
+	return success;
+}
+
 CompressedBlobReader::CompressedBlobReader(const char *filename) : file_name(filename)
 {
 	m_file.Open(filename, "rb");
@@ -48,6 +141,8 @@ CompressedBlobReader::CompressedBlobReader(const char *filename) : file_name(fil
 	zlib_buffer_size = header.block_size + 64;
 	zlib_buffer = new u8[zlib_buffer_size];
 	memset(zlib_buffer, 0, zlib_buffer_size);
+
+	EnableReadAhead();
 }
 
 CompressedBlobReader* CompressedBlobReader::Create(const char* filename)
@@ -60,6 +155,7 @@ CompressedBlobReader* CompressedBlobReader::Create(const char* filename)
 
 CompressedBlobReader::~CompressedBlobReader()
 {
+	StopReadAhead();
 	delete [] zlib_buffer;
 	delete [] block_pointers;
 	delete [] hashes;
@@ -80,7 +176,14 @@ u64 CompressedBlobReader::GetBlockCompressedSize(u64 block_num) const
 
 void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
 {
-	bool uncompressed = false;
+	bool uncompressed;
+	u32 comp_block_size = ReadBlockData(block_num, zlib_buffer, &uncompressed);
+	DecodeBlock(block_num, zlib_buffer, comp_block_size, uncompressed, out_ptr);
+}
+
+u32 CompressedBlobReader::ReadBlockData(u64 block_num, u8 *buffer, bool *uncompressed)
+{
+	*uncompressed = false;
 	u32 comp_block_size = (u32)GetBlockCompressedSize(block_num);
 	u64 offset = block_pointers[block_num] + data_offset;
 
@@ -88,19 +191,20 @@ void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
 	{
 		if (comp_block_size != header.block_size)
 			PanicAlert("Uncompressed block with wrong size");
-		uncompressed = true;
+		*uncompressed = true;
 		offset &= ~(1ULL << 63);
 	}
 
 	// clear unused part of zlib buffer. maybe this can be deleted when it works fully.
-	memset(zlib_buffer + comp_block_size, 0, zlib_buffer_size - comp_block_size);
+	memset(buffer + comp_block_size, 0, zlib_buffer_size - comp_block_size);
 
 	m_file.Seek(offset, SEEK_SET);
-	m_file.ReadBytes(zlib_buffer, comp_block_size);
-
-	u8* source = zlib_buffer;
-	u8* dest = out_ptr;
+	m_file.ReadBytes(buffer, comp_block_size);
+	return comp_block_size;
+}
 
+void CompressedBlobReader::DecodeBlock(u64 block_num, const u8 *source, u32 comp_block_size, bool uncompressed, u8 *dest) const
+{
 	// First, check hash.
 	u32 block_hash = HashAdler32(source, comp_block_size);
 	if (block_hash != hashes[block_num])
@@ -117,7 +221,7 @@ void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
 	{
 		z_stream z;
 		memset(&z, 0, sizeof(z));
-		z.next_in  = source;
+		z.next_in  = const_cast<u8*>(source);
 		z.avail_in = comp_block_size;
 		if (z.avail_in > header.block_size)
 		{
@@ -179,10 +283,17 @@ bool CompressFileToBlob(const char* infile, const char* outfile, u32 sub_type,
 	// round upwards!
 	header.num_blocks = (u32)((header.data_size + (block_size - 1)) / block_size);
 
+	// Blocks are read in order on a reader thread, deflated on the worker
+	// threads, and written in order on this thread.
+	const u32 num_workers = Common::GetNumHardwareThreads();
+	const u32 num_slots = num_workers * BLOCKS_PER_WORKER;
+
 	u64* offsets = new u64[header.num_blocks];
 	u32* hashes = new u32[header.num_blocks];
-	u8* out_buf = new u8[block_size];
-	u8* in_buf = new u8[block_size];
+	std::vector<u8> in_bufs((size_t)num_slots * block_size);
+	std::vector<u8> out_bufs((size_t)num_slots * block_size);
+	// Compressed size of the block in each slot, 0 if it is to be stored as-is, -1 on error.
+	std::vector<int> comp_sizes(num_slots);
 
 	// seek past the header (we will write it at the end)
 	f.Seek(sizeof(CompressedBlobHeader), SEEK_CUR);
@@ -195,50 +306,65 @@ bool CompressFileToBlob(const char* infile, const char* outfile, u32 sub_type,
 	int num_stored = 0;
 	int progress_monitor = max<int>(1, header.num_blocks / 1000);
 
-	for (u32 i = 0; i < header.num_blocks; i++)
-	{
-		if (i % progress_monitor == 0)
-		{
-			const u64 inpos = inf.Tell();
-			int ratio = 0;
-			if (inpos != 0)
-				ratio = (int)(100 * position / inpos);
-			char temp[512];
-			sprintf(temp, "%i of %i blocks. Compression ratio %i%%", i, header.num_blocks, ratio);
-			callback(temp, (float)i / (float)header.num_blocks, arg);
-		}
-
-		offsets[i] = position;
-		// u64 start = i * header.block_size;
-		// u64 size = header.block_size;
+	auto read_block = [&](u32 i, u32 slot) {
+		u8* in_buf = &in_bufs[(size_t)slot * block_size];
 		std::fill(in_buf, in_buf + header.block_size, 0);
 		if (scrubbing)
 			DiscScrubber::GetNextBlock(inf, in_buf);
 		else
 			inf.ReadBytes(in_buf, header.block_size);
+	};
+
+	auto compress_block = [&](u32 i, u32 slot) {
 		z_stream z;
 		memset(&z, 0, sizeof(z));
 		z.zalloc = Z_NULL;
 		z.zfree  = Z_NULL;
 		z.opaque = Z_NULL;
-		z.next_in   = in_buf;
+		z.next_in   = &in_bufs[(size_t)slot * block_size];
 		z.avail_in  = header.block_size;
-		z.next_out  = out_buf;
+		z.next_out  = &out_bufs[(size_t)slot * block_size];
 		z.avail_out = block_size;
-		int retval = deflateInit(&z, 9);
 
-		if (retval != Z_OK)
+		if (deflateInit(&z, 9) != Z_OK)
 		{
-			ERROR_LOG(DISCIO, "Deflate failed");
-			goto cleanup;
+			comp_sizes[slot] = -1;
+			return;
 		}
 
 		int status = deflate(&z, Z_FINISH);
-		int comp_size = block_size - z.avail_out;
 		if ((status != Z_STREAM_END) || (z.avail_out < 10))
+			comp_sizes[slot] = 0; // let's store uncompressed
+		else
+			comp_sizes[slot] = block_size - z.avail_out;
+
+		deflateEnd(&z);
+	};
+
+	auto write_block = [&](u32 i, u32 slot) -> bool {
+		if (i % progress_monitor == 0)
+		{
+			const u64 inpos = (u64)i * block_size;
+			int ratio = 0;
+			if (inpos != 0)
+				ratio = (int)(100 * position / inpos);
+			char temp[512];
+			sprintf(temp, "%i of %i blocks. Compression ratio %i%%", i, header.num_blocks, ratio);
+			callback(temp, (float)i / (float)header.num_blocks, arg);
+		}
+
+		const int comp_size = comp_sizes[slot];
+		if (comp_size < 0)
+		{
+			ERROR_LOG(DISCIO, "Deflate failed");
+			return false;
+		}
+
+		offsets[i] = position;
+		if (comp_size == 0)
 		{
-			//PanicAlert("%i %i Store %i", i*block_size, position, comp_size);
 			// let's store uncompressed
+			const u8* in_buf = &in_bufs[(size_t)slot * block_size];
 			offsets[i] |= 0x8000000000000000ULL;
 			f.WriteBytes(in_buf, block_size);
 			hashes[i] = HashAdler32(in_buf, block_size);
@@ -248,34 +374,36 @@ bool CompressFileToBlob(const char* infile, const char* outfile, u32 sub_type,
 		else
 		{
 			// let's store compressed
-			//PanicAlert("Comp %i to %i", block_size, comp_size);
+			const u8* out_buf = &out_bufs[(size_t)slot * block_size];
 			f.WriteBytes(out_buf, comp_size);
 			hashes[i] = HashAdler32(out_buf, comp_size);
 			position += comp_size;
 			num_compressed++;
 		}
+		return true;
+	};
 
-		deflateEnd(&z);
-	}
+	bool success = RunBlockPipeline(header.num_blocks, num_workers, num_slots,
+	                                read_block, compress_block, write_block);
 
-	header.compressed_data_size = position;
+	if (success)
+	{
+		header.compressed_data_size = position;
 
-	// Okay, go back and fill in headers
-	f.Seek(0, SEEK_SET);
-	f.WriteArray(&header, 1);
-	f.WriteArray(offsets, header.num_blocks);
-	f.WriteArray(hashes, header.num_blocks);
+		// Okay, go back and fill in headers
+		f.Seek(0, SEEK_SET);
+		f.WriteArray(&header, 1);
+		f.WriteArray(offsets, header.num_blocks);
+		f.WriteArray(hashes, header.num_blocks);
+	}
 
-cleanup:
 	// Cleanup
-	delete[] in_buf;
-	delete[] out_buf;
 	delete[] offsets;
 	delete[] hashes;
 
 	DiscScrubber::Cleanup();
 	callback("Done compressing disc image.", 1.0f, arg);
-	return true;
+	return success;
 }
 
 bool DecompressBlobToFile(const char* infile, const char* outfile, CompressCB callback, void* arg)
@@ -298,20 +426,36 @@ bool DecompressBlobToFile(const char* infile, const char* outfile, CompressCB ca
 	}
 
 	const CompressedBlobHeader &header = reader->GetHeader();
-	u8* buffer = new u8[header.block_size];
 	int progress_monitor = max<int>(1, header.num_blocks / 100);
 
-	for (u64 i = 0; i < header.num_blocks; i++)
-	{
-		if (i % progress_monitor == 0)
-		{
-			callback("Unpacking", (float)i / (float)header.num_blocks, arg);
-		}
-		reader->Read(i * header.block_size, header.block_size, buffer);
-		f.WriteBytes(buffer, header.block_size);
-	}
-
-	delete[] buffer;
+	// Compressed blocks are read in order on a reader thread, checked and
+	// inflated on the worker threads, and written in order on this thread.
+	const u32 num_workers = Common::GetNumHardwareThreads();
+	const u32 num_slots = num_workers * BLOCKS_PER_WORKER;
+	const u32 read_buffer_size = reader->GetReadBufferSize();
+	std::vector<u8> in_bufs((size_t)num_slots * read_buffer_size);
+	std::vector<u8> out_bufs((size_t)num_slots * header.block_size);
+	std::vector<u32> comp_sizes(num_slots);
+	std::vector<u8> uncompressed(num_slots); // not vector<bool>, the reader and the workers touch neighbouring slots
+
+	RunBlockPipeline(header.num_blocks, num_workers, num_slots,
+		[&](u32 i, u32 slot) {
+			bool stored;
+			comp_sizes[slot] = reader->ReadBlockData(i, &in_bufs[(size_t)slot * read_buffer_size], &stored);
+			uncompressed[slot] = stored;
+		},
+		[&](u32 i, u32 slot) {
+			reader->DecodeBlock(i, &in_bufs[(size_t)slot * read_buffer_size], comp_sizes[slot],
+			                    uncompressed[slot], &out_bufs[(size_t)slot * header.block_size]);
+		},
+		[&](u32 i, u32 slot) -> bool {
+			if (i % progress_monitor == 0)
+			{
+				callback("Unpacking", (float)i / (float)header.num_blocks, arg);
+			}
+			f.WriteBytes(&out_bufs[(size_t)slot * header.block_size], header.block_size);
+			return true;
+		});
 
 	f.Resize(header.data_size);
 
@@ -53,6 +53,14 @@ public:
 	u64 GetRawSize() const { return file_size; }
 	u64 GetBlockCompressedSize(u64 block_num) const;
 	void GetBlock(u64 block_num, u8 *out_ptr);
+
+	// GetBlock split in two, so blocks can be decoded on several threads.
+	// ReadBlockData reads the stored data of a block into buffer, which must hold
+	// GetReadBufferSize() bytes, and returns its size. DecodeBlock checks the hash
+	// and inflates it, it only touches its arguments and is safe to call concurrently.
+	u32 GetReadBufferSize() const { return zlib_buffer_size; }
+	u32 ReadBlockData(u64 block_num, u8 *buffer, bool *uncompressed);
+	void DecodeBlock(u64 block_num, const u8 *source, u32 comp_block_size, bool uncompressed, u8 *dest) const;
 private:
 	CompressedBlobReader(const char *filename);
 
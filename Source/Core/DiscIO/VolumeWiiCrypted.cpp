@@ -2,6 +2,7 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <string>
@@ -10,6 +11,7 @@
 #include <polarssl/sha1.h>
 
 #include "Common/Common.h"
+#include "Common/Crypto/AES.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/Volume.h"
 #include "DiscIO/VolumeGC.h"
@@ -21,14 +23,19 @@ namespace DiscIO
 CVolumeWiiCrypted::CVolumeWiiCrypted(IBlobReader* _pReader, u64 _VolumeOffset,
 									 const unsigned char* _pVolumeKey)
 	: m_pReader(_pReader),
-	m_pBuffer(0),
 	m_VolumeOffset(_VolumeOffset),
 	dataOffset(0x20000),
-	m_LastDecryptedBlockOffset(-1)
+	m_ClusterCacheCounter(0)
 {
 	m_AES_ctx = new aes_context;
 	aes_setkey_dec(m_AES_ctx, _pVolumeKey, 128);
-	m_pBuffer = new u8[0x8000];
+
+	m_ClusterCache.resize(CACHE_SIZE * CLUSTER_DATA_SIZE);
+	for (int i = 0; i < CACHE_SIZE; i++)
+	{
+		m_ClusterCacheTags[i] = (u64)(s64)-1;
+		m_ClusterCacheAge[i] = 0;
+	}
 }
 
 
@@ -36,8 +43,6 @@ CVolumeWiiCrypted::~CVolumeWiiCrypted()
 {
 	delete m_pReader; // is this really our responsibility?
 	m_pReader = NULL;
-	delete[] m_pBuffer;
-	m_pBuffer = NULL;
 	delete m_AES_ctx;
 	m_AES_ctx = NULL;
 }
@@ -54,6 +59,50 @@ bool CVolumeWiiCrypted::RAWRead( u64 _Offset, u64 _Length, u8* _pBuffer ) const
 	return true;
 }
 
+bool CVolumeWiiCrypted::DecryptClusters(u64 first_cluster, u64 num_clusters, u8* dest) const
+{
+	m_EncryptedBuffer.resize((size_t)num_clusters * CLUSTER_SIZE);
+	if (!m_pReader->Read(m_VolumeOffset + dataOffset + first_cluster * CLUSTER_SIZE,
+	                     num_clusters * CLUSTER_SIZE, m_EncryptedBuffer.data()))
+	{
+		return false;
+	}
+
+	for (u64 i = 0; i < num_clusters; i++)
+	{
+		const u8* cluster = &m_EncryptedBuffer[(size_t)i * CLUSTER_SIZE];
+		u8 IV[16];
+		memcpy(IV, cluster + 0x3d0, 16);
+		AES::DecryptCBC(m_AES_ctx, IV, cluster + 0x400, dest + i * CLUSTER_DATA_SIZE, CLUSTER_DATA_SIZE);
+	}
+	return true;
+}
+
+const u8* CVolumeWiiCrypted::GetDecryptedCluster(u64 cluster) const
+{
+	int slot = 0;
+	for (int i = 0; i < CACHE_SIZE; i++)
+	{
+		if (m_ClusterCacheTags[i] == cluster)
+		{
+			m_ClusterCacheAge[i] = ++m_ClusterCacheCounter;
+			return &m_ClusterCache[i * CLUSTER_DATA_SIZE];
+		}
+		if (m_ClusterCacheAge[i] < m_ClusterCacheAge[slot])
+			slot = i;
+	}
+
+	u8* data = &m_ClusterCache[slot * CLUSTER_DATA_SIZE];
+	if (!DecryptClusters(cluster, 1, data))
+	{
+		m_ClusterCacheTags[slot] = (u64)(s64)-1;
+		return NULL;
+	}
+	m_ClusterCacheTags[slot] = cluster;
+	m_ClusterCacheAge[slot] = ++m_ClusterCacheCounter;
+	return data;
+}
+
 bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer) const
 {
 	if (m_pReader == NULL)
@@ -63,30 +112,36 @@ bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer) const
 
 	while (_Length > 0)
 	{
-		static unsigned char IV[16];
-
 		// math block offset
-		u64 Block  = _ReadOffset / 0x7C00;
-		u64 Offset = _ReadOffset % 0x7C00;
+		u64 Block  = _ReadOffset / CLUSTER_DATA_SIZE;
+		u64 Offset = _ReadOffset % CLUSTER_DATA_SIZE;
 
-		// read current block
-		if (!m_pReader->Read(m_VolumeOffset + dataOffset + Block * 0x8000, 0x8000, m_pBuffer))
+		// Whole clusters are decrypted straight into the output, several at a time.
+		// They are not cached, large reads would only flush the cache.
+		if (Offset == 0 && _Length >= CLUSTER_DATA_SIZE)
 		{
-			return(false);
+			u64 NumBlocks = std::min<u64>(_Length / CLUSTER_DATA_SIZE, MAX_BATCH);
+			if (!DecryptClusters(Block, NumBlocks, _pBuffer))
+			{
+				return(false);
+			}
+
+			_Length     -= NumBlocks * CLUSTER_DATA_SIZE;
+			_pBuffer    += NumBlocks * CLUSTER_DATA_SIZE;
+			_ReadOffset += NumBlocks * CLUSTER_DATA_SIZE;
+			continue;
 		}
 
-		if (m_LastDecryptedBlockOffset != Block)
+		const u8* Decrypted = GetDecryptedCluster(Block);
+		if (!Decrypted)
 		{
-			memcpy(IV, m_pBuffer + 0x3d0, 16);
-			aes_crypt_cbc(m_AES_ctx, AES_DECRYPT, 0x7C00, IV, m_pBuffer + 0x400, m_LastDecryptedBlock);
-
-			m_LastDecryptedBlockOffset = Block;
+			return(false);
 		}
 
-		// copy the encrypted data
-		u64 MaxSizeToCopy = 0x7C00 - Offset;
+		// copy the decrypted data
+		u64 MaxSizeToCopy = CLUSTER_DATA_SIZE - Offset;
 		u64 CopySize = (_Length > MaxSizeToCopy) ? MaxSizeToCopy : _Length;
-		memcpy(_pBuffer, &m_LastDecryptedBlock[Offset], (size_t)CopySize);
+		memcpy(_pBuffer, Decrypted + Offset, (size_t)CopySize);
 
 		// increase buffers
 		_Length -= CopySize;
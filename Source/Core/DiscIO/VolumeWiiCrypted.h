@@ -40,16 +40,32 @@ public:
 	bool CheckIntegrity() const;
 
 private:
+	enum
+	{
+		CLUSTER_SIZE      = 0x8000,
+		CLUSTER_DATA_SIZE = 0x7C00,
+		// Decrypted clusters kept around for reads which don't cover whole clusters
+		CACHE_SIZE        = 16,
+		// Largest run of clusters read from the blob and decrypted in one go
+		MAX_BATCH         = 64,
+	};
+
+	// Reads num_clusters consecutive clusters and decrypts their data into dest.
+	bool DecryptClusters(u64 first_cluster, u64 num_clusters, u8* dest) const;
+	const u8* GetDecryptedCluster(u64 cluster) const;
+
 	IBlobReader* m_pReader;
 
-	u8* m_pBuffer;
 	aes_context* m_AES_ctx;
 
 	u64 m_VolumeOffset;
 	u64 dataOffset;
 
-	mutable u64 m_LastDecryptedBlockOffset;
-	mutable unsigned char m_LastDecryptedBlock[0x8000];
+	mutable std::vector<u8> m_EncryptedBuffer;
+	mutable std::vector<u8> m_ClusterCache;
+	mutable u64 m_ClusterCacheTags[CACHE_SIZE];
+	mutable u32 m_ClusterCacheAge[CACHE_SIZE];
+	mutable u32 m_ClusterCacheCounter;
 };
 
 } // namespace
@@ -254,6 +254,7 @@ EVT_MENU(IDM_PURGECACHE, CFrame::GameListChanged)
 EVT_MENU(IDM_SAVEFIRSTSTATE, CFrame::OnSaveFirstState)
 EVT_MENU(IDM_UNDOLOADSTATE,     CFrame::OnUndoLoadState)
 EVT_MENU(IDM_UNDOSAVESTATE,     CFrame::OnUndoSaveState)
+EVT_MENU(IDM_REWIND,            CFrame::OnRewind)
 EVT_MENU(IDM_LOADSTATEFILE, CFrame::OnLoadStateFromFile)
 EVT_MENU(IDM_SAVESTATEFILE, CFrame::OnSaveStateToFile)
 
@@ -841,6 +842,7 @@ int GetCmdForHotkey(unsigned int key)
 	case HK_SAVE_FIRST_STATE: return IDM_SAVEFIRSTSTATE;
 	case HK_UNDO_LOAD_STATE: return IDM_UNDOLOADSTATE;
 	case HK_UNDO_SAVE_STATE: return IDM_UNDOSAVESTATE;
+	case HK_REWIND: return IDM_REWIND;
 	case HK_LOAD_STATE_FILE: return IDM_LOADSTATEFILE;
 	case HK_SAVE_STATE_FILE: return IDM_SAVESTATEFILE;
 	}
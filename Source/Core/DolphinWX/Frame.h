@@ -298,6 +298,7 @@ private:
 	void OnSaveFirstState(wxCommandEvent& event);
 	void OnUndoLoadState(wxCommandEvent& event);
 	void OnUndoSaveState(wxCommandEvent& event);
+	void OnRewind(wxCommandEvent& event);
 
 	void OnFrameSkip(wxCommandEvent& event);
 	void OnFrameStep(wxCommandEvent& event);
@@ -197,6 +197,7 @@ void CFrame::CreateMenu()
 	loadMenu->Append(IDM_LOADSTATEFILE,  GetMenuLabel(HK_LOAD_STATE_FILE));
 
 	loadMenu->Append(IDM_UNDOLOADSTATE, GetMenuLabel(HK_UNDO_LOAD_STATE));
+	loadMenu->Append(IDM_REWIND, GetMenuLabel(HK_REWIND));
 	loadMenu->AppendSeparator();
 
 	for (unsigned int i = 1; i <= State::NUM_STATES; i++)
@@ -465,6 +466,7 @@ wxString CFrame::GetMenuLabel(int Id)
 		case HK_SAVE_FIRST_STATE: Label = wxString("Save Oldest State"); break;
 		case HK_UNDO_LOAD_STATE: Label = wxString("Undo Load State"); break;
 		case HK_UNDO_SAVE_STATE: Label = wxString("Undo Save State"); break;
+		case HK_REWIND: Label = _("Rewind"); break;
 
 		default:
 			Label = wxString::Format(_("Undefined %i"), Id);
@@ -1568,6 +1570,12 @@ void CFrame::OnUndoSaveState(wxCommandEvent& WXUNUSED (event))
 		State::UndoSaveState();
 }
 
+void CFrame::OnRewind(wxCommandEvent& WXUNUSED (event))
+{
+	if (Core::IsRunningAndStarted())
+		State::Rewind();
+}
+
 
 void CFrame::OnLoadState(wxCommandEvent& event)
 {
@@ -1828,6 +1836,9 @@ void CFrame::GameListChanged(wxCommandEvent& event)
 		SConfig::GetInstance().m_ListDrives = event.IsChecked();
 		break;
 	case IDM_PURGECACHE:
+		// The game list cache is mapped, the next scan opens it again
+		GameListItem::CloseCache();
+
 		CFileSearch::XStringVector Directories;
 		Directories.push_back(File::GetUserPath(D_CACHE_IDX).c_str());
 		CFileSearch::XStringVector Extensions;
@@ -157,6 +157,8 @@ bool cInterfaceEGL::Create(void *&window_handle)
 		exit(1);
 	}
 
+	m_config = config;
+
 	if (s_opengl_mode == MODE_OPENGL)
 		eglBindAPI(EGL_OPENGL_API);
 	else
@@ -203,6 +205,61 @@ bool cInterfaceEGL::MakeCurrent()
 {
 	return eglMakeCurrent(GLWin.egl_dpy, GLWin.egl_surf, GLWin.egl_surf, GLWin.egl_ctx);
 }
+
+bool cInterfaceEGL::ClearCurrent()
+{
+	return eglMakeCurrent(GLWin.egl_dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+struct EGLSharedContext
+{
+	EGLContext ctx;
+	EGLSurface surf;
+};
+
+void* cInterfaceEGL::CreateSharedContext()
+{
+	EGLint ctx_attribs[] = {
+		EGL_CONTEXT_CLIENT_VERSION, s_opengl_mode == MODE_OPENGLES3 ? 3 : 2,
+		EGL_NONE
+	};
+	if (s_opengl_mode == MODE_OPENGL)
+		ctx_attribs[0] = EGL_NONE;
+
+	EGLContext ctx = eglCreateContext(GLWin.egl_dpy, m_config, GLWin.egl_ctx, ctx_attribs);
+	if (ctx == EGL_NO_CONTEXT)
+	{
+		INFO_LOG(VIDEO, "Error: eglCreateContext failed for shared context\n");
+		return NULL;
+	}
+
+	// The shared context never draws, a tiny pbuffer is enough to make it current.
+	// Without pbuffer support in the chosen config, rely on surfaceless contexts.
+	EGLint surf_attribs[] = {
+		EGL_WIDTH, 1,
+		EGL_HEIGHT, 1,
+		EGL_NONE
+	};
+	EGLSharedContext* shared = new EGLSharedContext;
+	shared->ctx = ctx;
+	shared->surf = eglCreatePbufferSurface(GLWin.egl_dpy, m_config, surf_attribs);
+	return shared;
+}
+
+bool cInterfaceEGL::MakeSharedContextCurrent(void* context)
+{
+	EGLSharedContext* shared = (EGLSharedContext*)context;
+	return eglMakeCurrent(GLWin.egl_dpy, shared->surf, shared->surf, shared->ctx);
+}
+
+void cInterfaceEGL::DestroySharedContext(void* context)
+{
+	EGLSharedContext* shared = (EGLSharedContext*)context;
+	if (shared->surf != EGL_NO_SURFACE)
+		eglDestroySurface(GLWin.egl_dpy, shared->surf);
+	eglDestroyContext(GLWin.egl_dpy, shared->ctx);
+	delete shared;
+}
 // Close backend
 void cInterfaceEGL::Shutdown()
 {
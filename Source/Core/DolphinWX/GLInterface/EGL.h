@@ -35,6 +35,7 @@ class cInterfaceEGL : public cInterfaceBase
 {
 private:
 	cPlatform Platform;
+	EGLConfig m_config;
 	void DetectMode();
 public:
 	friend class cPlatform;
@@ -45,5 +46,10 @@ public:
 	void* GetFuncAddress(std::string name);
 	bool Create(void *&window_handle);
 	bool MakeCurrent();
+	bool ClearCurrent();
 	void Shutdown();
+
+	void* CreateSharedContext();
+	bool MakeSharedContextCurrent(void* context);
+	void DestroySharedContext(void* context);
 };
@@ -139,6 +139,25 @@ bool cInterfaceGLX::ClearCurrent()
 	return glXMakeCurrent(GLWin.dpy, None, NULL);
 }
 
+void* cInterfaceGLX::CreateSharedContext()
+{
+	GLXContext ctx = glXCreateContext(GLWin.dpy, GLWin.vi, GLWin.ctx, GL_TRUE);
+	if (!ctx)
+		ERROR_LOG(VIDEO, "Unable to create shared GLX context.");
+	return ctx;
+}
+
+bool cInterfaceGLX::MakeSharedContextCurrent(void* context)
+{
+	// Shared contexts never draw, so they can bind the render window as well.
+	return glXMakeCurrent(GLWin.dpy, GLWin.win, (GLXContext)context);
+}
+
+void cInterfaceGLX::DestroySharedContext(void* context)
+{
+	glXDestroyContext(GLWin.dpy, (GLXContext)context);
+}
+
 
 // Close backend
 void cInterfaceGLX::Shutdown()
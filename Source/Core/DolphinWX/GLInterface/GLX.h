@@ -21,4 +21,8 @@ public:
 	bool MakeCurrent();
 	bool ClearCurrent();
 	void Shutdown();
+
+	void* CreateSharedContext();
+	bool MakeSharedContextCurrent(void* context);
+	void DestroySharedContext(void* context);
 };
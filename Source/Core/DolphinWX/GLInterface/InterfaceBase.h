@@ -38,4 +38,11 @@ public:
 	virtual void SetBackBufferDimensions(u32 W, u32 H) {s_backbuffer_width = W; s_backbuffer_height = H; }
 	virtual void Update() { }
 	virtual bool PeekMessages() { return false; }
+
+	// Additional contexts sharing objects with the main one, so other threads
+	// can create GL objects (e.g. compile shaders) for the video thread.
+	// Backends without support return NULL and callers stay single threaded.
+	virtual void* CreateSharedContext() { return NULL; }
+	virtual bool MakeSharedContextCurrent(void* context) { return false; }
+	virtual void DestroySharedContext(void* context) {}
 };
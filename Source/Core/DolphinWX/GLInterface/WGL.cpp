@@ -144,6 +144,35 @@ bool cInterfaceWGL::ClearCurrent()
 	return wglMakeCurrent(hDC, NULL) ? true : false;
 }
 
+void* cInterfaceWGL::CreateSharedContext()
+{
+	HGLRC shared_rc = wglCreateContext(hDC);
+	if (!shared_rc)
+	{
+		ERROR_LOG(VIDEO, "Can't create a shared OpenGL rendering context.");
+		return NULL;
+	}
+
+	// Must happen before the new context owns any objects.
+	if (!wglShareLists(hRC, shared_rc))
+	{
+		ERROR_LOG(VIDEO, "Can't share objects with the main OpenGL rendering context.");
+		wglDeleteContext(shared_rc);
+		return NULL;
+	}
+	return shared_rc;
+}
+
+bool cInterfaceWGL::MakeSharedContextCurrent(void* context)
+{
+	return wglMakeCurrent(hDC, (HGLRC)context) ? true : false;
+}
+
+void cInterfaceWGL::DestroySharedContext(void* context)
+{
+	wglDeleteContext((HGLRC)context);
+}
+
 // Update window width, size and etc. Called from Render.cpp
 void cInterfaceWGL::Update()
 {
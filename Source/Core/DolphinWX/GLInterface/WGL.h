@@ -18,6 +18,10 @@ public:
 	bool ClearCurrent();
 	void Shutdown();
 
+	void* CreateSharedContext();
+	bool MakeSharedContextCurrent(void* context);
+	void DestroySharedContext(void* context);
+
 	void Update();
 	bool PeekMessages();
 };
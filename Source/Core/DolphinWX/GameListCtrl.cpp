@@ -3,12 +3,14 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <wx/app.h>
 #include <wx/bitmap.h>
@@ -46,6 +48,7 @@
 #include "Common/MathUtil.h"
 #include "Common/StringUtil.h"
 #include "Common/SysConf.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreParameter.h"
@@ -565,19 +568,44 @@ void CGameListCtrl::ScanForISOs()
 			wxPD_SMOOTH // - makes updates as small as possible (down to 1px)
 			);
 
-		for (u32 i = 0; i < rFilenames.size(); i++)
+		// Opening the volumes is mostly waiting for the disk, so do it on a pool
+		// of threads while this one keeps the dialog going.
+		GameListItem::OpenCache();
+		const u32 num_files = (u32)rFilenames.size();
+		std::vector<std::unique_ptr<GameListItem>> iso_files(num_files);
+		std::atomic<u32> num_scanned(0);
+		std::atomic<bool> cancelled(false);
+		std::thread scanner([&]() {
+			Common::ParallelFor(Common::GetNumHardwareThreads() * 2, num_files, [&](u32 i) {
+				if (!cancelled)
+					iso_files[i].reset(new GameListItem(rFilenames[i]));
+				num_scanned++;
+			});
+		});
+
+		u32 scanned;
+		while ((scanned = num_scanned) < num_files)
 		{
 			std::string FileName;
-			SplitPath(rFilenames[i], NULL, &FileName, NULL);
+			SplitPath(rFilenames[scanned], NULL, &FileName, NULL);
 
-			// Update with the progress (i) and the message
-			dialog.Update(i, wxString::Format(_("Scanning %s"),
+			// Update with the progress and the message
+			dialog.Update(scanned, wxString::Format(_("Scanning %s"),
 				StrToWxStr(FileName)));
 			if (dialog.WasCancelled())
-				break;
+				cancelled = true;
+
+			Common::SleepCurrentThread(20);
+		}
+		scanner.join();
+
+		for (auto& iso_file : iso_files)
+		{
+			if (!iso_file)
+				continue;
 
-			std::unique_ptr<GameListItem> iso_file(new GameListItem(rFilenames[i]));
 			const GameListItem& ISOFile = *iso_file;
+			iso_file->SaveToCache();
 
 			if (ISOFile.IsValid())
 			{
@@ -634,6 +662,8 @@ void CGameListCtrl::ScanForISOs()
 					m_ISOFiles.push_back(iso_file.release());
 			}
 		}
+
+		GameListItem::SyncCache();
 	}
 
 	if (SConfig::GetInstance().m_ListDrives)
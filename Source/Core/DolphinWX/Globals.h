@@ -27,6 +27,7 @@ enum
 	IDM_SAVEFIRSTSTATE,
 	IDM_UNDOLOADSTATE,
 	IDM_UNDOSAVESTATE,
+	IDM_REWIND,
 	IDM_LOADSTATEFILE,
 	IDM_SAVESTATEFILE,
 	IDM_SAVESLOT1,
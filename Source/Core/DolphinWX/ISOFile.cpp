@@ -18,6 +18,7 @@
 #include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
 #include "Common/Hash.h"
+#include "Common/IndexedDiskCache.h"
 #include "Common/IniFile.h"
 #include "Common/StringUtil.h"
 
@@ -34,11 +35,19 @@
 #include "DolphinWX/ISOFile.h"
 #include "DolphinWX/WxUtils.h"
 
-static const u32 CACHE_REVISION = 0x115;
+static const u32 CACHE_REVISION = 0x117;
 
 #define DVD_BANNER_WIDTH 96
 #define DVD_BANNER_HEIGHT 32
 
+// Keyed by a hash of the path, the path itself is stored in the entry.
+static IndexedDiskCache<u64, u8> s_cache;
+
+static u64 GetCacheKey(const std::string& filename)
+{
+	return GetMurmurHash3((const u8*)filename.c_str(), (int)filename.size(), 0);
+}
+
 GameListItem::GameListItem(const std::string& _rFileName)
 	: m_FileName(_rFileName)
 	, m_emu_state(0)
@@ -48,10 +57,22 @@ GameListItem::GameListItem(const std::string& _rFileName)
 	, m_BlobCompressed(false)
 	, m_ImageWidth(0)
 	, m_ImageHeight(0)
+	, m_StatSize(0)
+	, m_StatTime(0)
+	, m_FromCache(false)
 {
+	// Drives and other things without a size are never cached
+	if (File::Exists(_rFileName) && !File::IsDirectory(_rFileName))
+	{
+		m_StatSize = File::GetSize(_rFileName);
+		if (m_StatSize)
+			m_StatTime = File::GetModificationTime(_rFileName);
+	}
+
 	if (LoadFromCache())
 	{
 		m_Valid = true;
+		m_FromCache = true;
 	}
 	else
 	{
@@ -114,11 +135,6 @@ GameListItem::GameListItem(const std::string& _rFileName)
 			delete pVolume;
 
 			m_Valid = true;
-
-			// Create a cache file only if we have an image.
-			// Wii isos create their images after you have generated the first savegame
-			if (!m_pImage.empty())
-				SaveToCache();
 		}
 	}
 
@@ -130,10 +146,21 @@ GameListItem::GameListItem(const std::string& _rFileName)
 		ini.Get("EmuState", "EmulationStateId", &m_emu_state);
 		ini.Get("EmuState", "EmulationIssues", &m_issues);
 	}
+}
+
+GameListItem::~GameListItem()
+{
+}
+
+const wxBitmap& GameListItem::GetBitmap() const
+{
+	if (m_Bitmap.IsOk())
+		return m_Bitmap;
 
 	if (!m_pImage.empty())
 	{
-		wxImage Image(m_ImageWidth, m_ImageHeight, &m_pImage[0], true);
+		// wxImage doesn't take a const pointer, but doesn't write to static data either
+		wxImage Image(m_ImageWidth, m_ImageHeight, const_cast<u8*>(&m_pImage[0]), true);
 		double Scale = WxUtils::GetCurrentBitmapLogicalScale();
 		// Note: This uses nearest neighbor, which subjectively looks a lot
 		// better for GC banners than smooths caling.
@@ -149,25 +176,96 @@ GameListItem::GameListItem(const std::string& _rFileName)
 		// default banner
 		m_Bitmap.LoadFile(StrToWxStr(File::GetThemeDir(SConfig::GetInstance().m_LocalCoreStartupParameter.theme_name)) + "nobanner.png", wxBITMAP_TYPE_PNG);
 	}
+	return m_Bitmap;
 }
 
-GameListItem::~GameListItem()
+void GameListItem::OpenCache()
 {
+	if (s_cache.IsOpen())
+		return;
+
+	if (!File::IsDirectory(File::GetUserPath(D_CACHE_IDX)))
+		File::CreateDir(File::GetUserPath(D_CACHE_IDX));
+
+	u32 num_entries = s_cache.Open(File::GetUserPath(D_CACHE_IDX) + "gamelist.cache");
+	INFO_LOG(COMMON, "Game list cache holds %u entries", num_entries);
+}
+
+void GameListItem::SyncCache()
+{
+	s_cache.Sync();
+}
+
+void GameListItem::CloseCache()
+{
+	s_cache.Close();
 }
 
 bool GameListItem::LoadFromCache()
 {
-	return CChunkFileReader::Load<GameListItem>(CreateCacheFilename(), CACHE_REVISION, *this);
+	const u8* data;
+	u32 size;
+	if (!m_StatSize || !s_cache.IsOpen() || !s_cache.Lookup(GetCacheKey(m_FileName), data, size))
+		return false;
+
+	// PointerWrap doesn't check for the end of the data, so only parse
+	// entries which are byte for byte what SaveToCache wrote.
+	u32 checksum;
+	if (size < sizeof(checksum))
+		return false;
+	memcpy(&checksum, data, sizeof(checksum));
+	if (checksum != HashAdler32(data + sizeof(checksum), size - sizeof(checksum)))
+		return false;
+
+	// PointerWrap only reads in MODE_READ
+	u8* ptr = const_cast<u8*>(data) + sizeof(checksum);
+	PointerWrap p(&ptr, PointerWrap::MODE_READ);
+	u32 revision;
+	std::string filename;
+	u64 stat_size, stat_time;
+	p.Do(revision);
+	p.Do(filename);
+	p.Do(stat_size);
+	p.Do(stat_time);
+	if (revision != CACHE_REVISION || filename != m_FileName || stat_size != m_StatSize || stat_time != m_StatTime)
+		return false;
+
+	DoState(p);
+	return true;
 }
 
 void GameListItem::SaveToCache()
 {
-	if (!File::IsDirectory(File::GetUserPath(D_CACHE_IDX)))
-	{
-		File::CreateDir(File::GetUserPath(D_CACHE_IDX));
-	}
-
-	CChunkFileReader::Save<GameListItem>(CreateCacheFilename(), CACHE_REVISION, *this);
+	// Only cache items with an image.
+	// Wii isos create their images after you have generated the first savegame
+	if (m_FromCache || !m_Valid || !m_StatSize || m_pImage.empty() || !s_cache.IsOpen())
+		return;
+
+	u32 revision = CACHE_REVISION;
+	u32 checksum = 0;
+	u8* ptr = NULL;
+	PointerWrap p_measure(&ptr, PointerWrap::MODE_MEASURE);
+	p_measure.Do(checksum);
+	p_measure.Do(revision);
+	p_measure.Do(m_FileName);
+	p_measure.Do(m_StatSize);
+	p_measure.Do(m_StatTime);
+	DoState(p_measure);
+
+	std::vector<u8> data((size_t)ptr);
+	ptr = &data[0];
+	PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+	p.Do(checksum);
+	p.Do(revision);
+	p.Do(m_FileName);
+	p.Do(m_StatSize);
+	p.Do(m_StatTime);
+	DoState(p);
+
+	checksum = HashAdler32(&data[sizeof(checksum)], data.size() - sizeof(checksum));
+	memcpy(&data[0], &checksum, sizeof(checksum));
+	s_cache.Append(GetCacheKey(m_FileName), &data[0], (u32)data.size());
+	m_FromCache = true;
 }
 
 void GameListItem::DoState(PointerWrap &p)
@@ -189,24 +287,6 @@ void GameListItem::DoState(PointerWrap &p)
 	p.Do(m_Revision);
 }
 
-std::string GameListItem::CreateCacheFilename()
-{
-	std::string Filename, LegalPathname, extension;
-	SplitPath(m_FileName, &LegalPathname, &Filename, &extension);
-
-	if (Filename.empty()) return Filename; // Disc Drive
-
-	// Filename.extension_HashOfFolderPath_Size.cache
-	// Append hash to prevent ISO name-clashing in different folders.
-	Filename.append(StringFromFormat("%s_%x_%" PRIx64 ".cache",
-		extension.c_str(), HashFletcher((const u8 *)LegalPathname.c_str(), LegalPathname.size()),
-		File::GetSize(m_FileName)));
-
-	std::string fullname(File::GetUserPath(D_CACHE_IDX));
-	fullname += Filename;
-	return fullname;
-}
-
 std::string GameListItem::GetCompany() const
 {
 	if (m_company.empty())
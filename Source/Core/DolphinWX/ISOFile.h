@@ -18,9 +18,19 @@ class PointerWrap;
 class GameListItem : NonCopyable
 {
 public:
+	// Reads the metadata from the game list cache if the file's size and modification
+	// time still match, otherwise from the volume. Items may be constructed on several
+	// threads at once, as long as nothing is added to the cache meanwhile.
 	GameListItem(const std::string& _rFileName);
 	~GameListItem();
 
+	// The cache is one file for all items, keyed by path.
+	static void OpenCache();
+	static void SyncCache();
+	static void CloseCache();
+	// Adds the item to the cache if it was read from the volume. Not thread safe.
+	void SaveToCache();
+
 	bool IsValid() const {return m_Valid;}
 	const std::string& GetFileName() const {return m_FileName;}
 	std::string GetBannerName(int index) const;
@@ -40,7 +50,8 @@ public:
 	u64 GetVolumeSize() const {return m_VolumeSize;}
 	bool IsDiscTwo() const {return m_IsDiscTwo;}
 #if defined(HAVE_WX) && HAVE_WX
-	const wxBitmap& GetBitmap() const {return m_Bitmap;}
+	// Created on first use, as it can only be done on the GUI thread
+	const wxBitmap& GetBitmap() const;
 #endif
 
 	void DoState(PointerWrap &p);
@@ -77,7 +88,7 @@ private:
 	int m_Revision;
 
 #if defined(HAVE_WX) && HAVE_WX
-	wxBitmap m_Bitmap;
+	mutable wxBitmap m_Bitmap;
 #endif
 	bool m_Valid;
 	bool m_BlobCompressed;
@@ -85,8 +96,10 @@ private:
 	int m_ImageWidth, m_ImageHeight;
 	bool m_IsDiscTwo;
 
-	bool LoadFromCache();
-	void SaveToCache();
+	// What the cache entry is checked against
+	u64 m_StatSize;
+	u64 m_StatTime;
+	bool m_FromCache;
 
-	std::string CreateCacheFilename();
+	bool LoadFromCache();
 };
@@ -3,7 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "Common/FileUtil.h"
-#include "Common/LinearDiskCache.h"
+#include "Common/IndexedDiskCache.h"
 
 #include "Core/ConfigManager.h"
 
@@ -29,7 +29,7 @@ const PixelShaderCache::PSCacheEntry* PixelShaderCache::last_entry;
 PixelShaderUid PixelShaderCache::last_uid;
 UidChecker<PixelShaderUid,PixelShaderCode> PixelShaderCache::pixel_uid_checker;
 
-LinearDiskCache<PixelShaderUid, u8> g_ps_disk_cache;
+IndexedDiskCache<PixelShaderUid, u8> g_ps_disk_cache;
 
 ID3D11PixelShader* s_ColorMatrixProgram[2] = {NULL};
 ID3D11PixelShader* s_ColorCopyProgram[2] = {NULL};
@@ -350,16 +350,6 @@ ID3D11Buffer* &PixelShaderCache::GetConstantBuffer()
 	return pscbuf;
 }
 
-// this class will load the precompiled shaders into our cache
-class PixelShaderCacheInserter : public LinearDiskCacheReader<PixelShaderUid, u8>
-{
-public:
-	void Read(const PixelShaderUid &key, const u8 *value, u32 value_size)
-	{
-		PixelShaderCache::InsertByteCode(key, value, value_size);
-	}
-};
-
 void PixelShaderCache::Init()
 {
 	unsigned int cbsize = ((sizeof(PixelShaderConstants))&(~0xf))+0x10; // must be a multiple of 16
@@ -399,11 +389,7 @@ void PixelShaderCache::Init()
 	char cache_filename[MAX_PATH];
 	sprintf(cache_filename, "%sdx11-%s-ps.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
 			SConfig::GetInstance().m_LocalCoreStartupParameter.m_strUniqueID.c_str());
-	PixelShaderCacheInserter inserter;
-	g_ps_disk_cache.OpenAndRead(cache_filename, inserter);
-
-	if (g_Config.bEnableShaderDebugging)
-		Clear();
+	g_ps_disk_cache.Open(cache_filename);
 
 	last_entry = NULL;
 }
@@ -444,7 +430,6 @@ void PixelShaderCache::Shutdown()
 	}
 
 	Clear();
-	g_ps_disk_cache.Sync();
 	g_ps_disk_cache.Close();
 }
 
@@ -483,6 +468,20 @@ bool PixelShaderCache::SetShader(DSTALPHA_MODE dstAlphaMode, u32 components)
 		return (entry.shader != NULL);
 	}
 
+	// Shaders compiled in earlier sessions are only loaded once they are needed.
+	// When debugging shaders, always compile them to have their code around.
+	const u8* cached_bytecode;
+	u32 cached_size;
+	if (!g_ActiveConfig.bEnableShaderDebugging && g_ps_disk_cache.Lookup(uid, cached_bytecode, cached_size))
+	{
+		if (InsertByteCode(uid, cached_bytecode, cached_size))
+		{
+			GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
+			return true;
+		}
+		g_ps_disk_cache.Erase(uid);
+	}
+
 	// Need to compile a new shader
 	PixelShaderCode code;
 	GeneratePixelShaderCode(code, dstAlphaMode, API_D3D, components);
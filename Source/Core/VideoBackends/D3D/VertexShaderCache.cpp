@@ -3,7 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "Common/FileUtil.h"
-#include "Common/LinearDiskCache.h"
+#include "Common/IndexedDiskCache.h"
 
 #include "Core/ConfigManager.h"
 
@@ -28,7 +28,7 @@ static ID3D11VertexShader* ClearVertexShader = NULL;
 static ID3D11InputLayout* SimpleLayout = NULL;
 static ID3D11InputLayout* ClearLayout = NULL;
 
-LinearDiskCache<VertexShaderUid, u8> g_vs_disk_cache;
+IndexedDiskCache<VertexShaderUid, u8> g_vs_disk_cache;
 
 ID3D11VertexShader* VertexShaderCache::GetSimpleVertexShader() { return SimpleVertexShader; }
 ID3D11VertexShader* VertexShaderCache::GetClearVertexShader() { return ClearVertexShader; }
@@ -53,19 +53,6 @@ ID3D11Buffer* &VertexShaderCache::GetConstantBuffer()
 	return vscbuf;
 }
 
-// this class will load the precompiled shaders into our cache
-class VertexShaderCacheInserter : public LinearDiskCacheReader<VertexShaderUid, u8>
-{
-public:
-	void Read(const VertexShaderUid &key, const u8 *value, u32 value_size)
-	{
-		D3DBlob* blob = new D3DBlob(value_size, value);
-		VertexShaderCache::InsertByteCode(key, blob);
-		blob->Release();
-
-	}
-};
-
 const char simple_shader_code[] = {
 	"struct VSOUTPUT\n"
 	"{\n"
@@ -146,11 +133,7 @@ void VertexShaderCache::Init()
 	char cache_filename[MAX_PATH];
 	sprintf(cache_filename, "%sdx11-%s-vs.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
 			SConfig::GetInstance().m_LocalCoreStartupParameter.m_strUniqueID.c_str());
-	VertexShaderCacheInserter inserter;
-	g_vs_disk_cache.OpenAndRead(cache_filename, inserter);
-
-	if (g_Config.bEnableShaderDebugging)
-		Clear();
+	g_vs_disk_cache.Open(cache_filename);
 
 	last_entry = NULL;
 }
@@ -176,7 +159,6 @@ void VertexShaderCache::Shutdown()
 	SAFE_RELEASE(ClearLayout);
 
 	Clear();
-	g_vs_disk_cache.Sync();
 	g_vs_disk_cache.Close();
 }
 
@@ -212,6 +194,23 @@ bool VertexShaderCache::SetShader(u32 components)
 		return (entry.shader != NULL);
 	}
 
+	// Shaders compiled in earlier sessions are only loaded once they are needed.
+	// When debugging shaders, always compile them to have their code around.
+	const u8* cached_bytecode;
+	u32 cached_size;
+	if (!g_ActiveConfig.bEnableShaderDebugging && g_vs_disk_cache.Lookup(uid, cached_bytecode, cached_size))
+	{
+		D3DBlob* blob = new D3DBlob(cached_size, cached_bytecode);
+		bool success = InsertByteCode(uid, blob);
+		blob->Release();
+		if (success)
+		{
+			GFX_DEBUGGER_PAUSE_AT(NEXT_VERTEX_SHADER_CHANGE, true);
+			return true;
+		}
+		g_vs_disk_cache.Erase(uid);
+	}
+
 	VertexShaderCode code;
 	GenerateVertexShaderCode(code, components, API_D3D);
 
@@ -2,7 +2,16 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Common/CPUDetect.h"
 #include "Common/MathUtil.h"
+#include "Common/Thread.h"
 
 #include "VideoBackends/OGL/ProgramShaderCache.h"
 #include "VideoBackends/OGL/Render.h"
@@ -24,9 +33,9 @@ u32 ProgramShaderCache::s_ubo_buffer_size;
 s32 ProgramShaderCache::s_ubo_align;
 
 static StreamBuffer *s_buffer;
-static int num_failures = 0;
+static std::atomic<int> num_failures(0);
 
-LinearDiskCache<SHADERUID, u8> g_program_disk_cache;
+IndexedDiskCache<SHADERUID, u8> g_program_disk_cache;
 static GLuint CurrentProgram = 0;
 ProgramShaderCache::PCache ProgramShaderCache::pshaders;
 ProgramShaderCache::PCacheEntry* ProgramShaderCache::last_entry;
@@ -36,6 +45,34 @@ UidChecker<VertexShaderUid,VertexShaderCode> ProgramShaderCache::vertex_uid_chec
 
 static char s_glsl_header[1024] = "";
 
+// Asynchronous compilation: the video thread queues programs it hasn't seen
+// yet, compiler threads owning shared contexts link them and hand back the
+// program names, which are finished up on the video thread.
+struct CompileJob
+{
+	SHADERUID uid;
+	std::string vcode, pcode;
+};
+
+struct CompileResult
+{
+	SHADERUID uid;
+	GLuint glprogid; // 0 on failure
+};
+
+static const int MAX_COMPILE_THREADS = 4;
+
+static std::vector<std::thread> s_compile_threads;
+static std::vector<void*> s_compile_contexts;
+static std::mutex s_compile_lock;
+static std::condition_variable s_compile_cond;
+static std::deque<CompileJob> s_compile_jobs;
+static std::vector<CompileResult> s_compile_results;
+static bool s_compile_quit;
+static bool s_compile_thread_ok;
+static Common::Event s_compile_thread_started;
+static int s_num_pending;
+
 void SHADER::SetProgramVariables()
 {
 	// glsl shader must be bind to set samplers
@@ -140,11 +177,17 @@ SHADER* ProgramShaderCache::SetShader ( DSTALPHA_MODE dstAlphaMode, u32 componen
 	SHADERUID uid;
 	GetShaderId(&uid, dstAlphaMode, components);
 
+	if (s_num_pending)
+		ProcessCompiledPrograms();
+
 	// Check if the shader is already set
 	if (last_entry)
 	{
 		if (uid == last_uid)
 		{
+			if (last_entry->pending)
+				return NULL;
+
 			GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
 			last_entry->shader.Bind();
 			return &last_entry->shader;
@@ -159,6 +202,8 @@ SHADER* ProgramShaderCache::SetShader ( DSTALPHA_MODE dstAlphaMode, u32 componen
 	{
 		PCacheEntry *entry = &iter->second;
 		last_entry = entry;
+		if (last_entry->pending)
+			return NULL;
 
 		GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
 		last_entry->shader.Bind();
@@ -169,6 +214,17 @@ SHADER* ProgramShaderCache::SetShader ( DSTALPHA_MODE dstAlphaMode, u32 componen
 	PCacheEntry& newentry = pshaders[uid];
 	last_entry = &newentry;
 	newentry.in_cache = 0;
+	newentry.pending = false;
+
+	if (g_program_disk_cache.IsOpen() && LoadFromDiskCache(uid, newentry.shader))
+	{
+		newentry.in_cache = 1;
+		SETSTAT(stats.numPixelShadersAlive, pshaders.size());
+		GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
+
+		last_entry->shader.Bind();
+		return &last_entry->shader;
+	}
 
 	VertexShaderCode vcode;
 	PixelShaderCode pcode;
@@ -192,6 +248,24 @@ SHADER* ProgramShaderCache::SetShader ( DSTALPHA_MODE dstAlphaMode, u32 componen
 	}
 #endif
 
+	if (!s_compile_threads.empty())
+	{
+		CompileJob job;
+		job.uid = uid;
+		job.vcode = vcode.GetBuffer();
+		job.pcode = pcode.GetBuffer();
+		{
+			std::lock_guard<std::mutex> lk(s_compile_lock);
+			s_compile_jobs.push_back(std::move(job));
+		}
+		s_compile_cond.notify_one();
+
+		newentry.pending = true;
+		s_num_pending++;
+		SETSTAT(stats.numShaderProgramsPending, s_num_pending);
+		return NULL;
+	}
+
 	if (!CompileShader(newentry.shader, vcode.GetBuffer(), pcode.GetBuffer())) {
 		GFX_DEBUGGER_PAUSE_AT(NEXT_ERROR, true);
 		return NULL;
@@ -206,6 +280,16 @@ SHADER* ProgramShaderCache::SetShader ( DSTALPHA_MODE dstAlphaMode, u32 componen
 }
 
 bool ProgramShaderCache::CompileShader ( SHADER& shader, const char* vcode, const char* pcode )
+{
+	if (!LinkProgram(shader, vcode, pcode))
+		return false;
+
+	shader.SetProgramVariables();
+
+	return true;
+}
+
+bool ProgramShaderCache::LinkProgram ( SHADER& shader, const char* vcode, const char* pcode )
 {
 	GLuint vsid = CompileSingleShader(GL_VERTEX_SHADER, vcode);
 	GLuint psid = CompileSingleShader(GL_FRAGMENT_SHADER, pcode);
@@ -270,8 +354,6 @@ bool ProgramShaderCache::CompileShader ( SHADER& shader, const char* vcode, cons
 		return false;
 	}
 
-	shader.SetProgramVariables();
-
 	return true;
 }
 
@@ -354,6 +436,159 @@ ProgramShaderCache::PCacheEntry ProgramShaderCache::GetShaderProgram(void)
 	return *last_entry;
 }
 
+bool ProgramShaderCache::LoadFromDiskCache(const SHADERUID& uid, SHADER& shader)
+{
+	const u8* value;
+	u32 value_size;
+	if (!g_program_disk_cache.Lookup(uid, value, value_size) || value_size < sizeof(GLenum))
+		return false;
+
+	GLenum prog_format;
+	memcpy(&prog_format, value, sizeof(GLenum));
+	const u8 *binary = value + sizeof(GLenum);
+	GLint binary_size = value_size - sizeof(GLenum);
+
+	shader.glprogid = glCreateProgram();
+	glProgramBinary(shader.glprogid, prog_format, binary, binary_size);
+
+	GLint success;
+	glGetProgramiv(shader.glprogid, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		// Most likely a driver update, compile it again.
+		glDeleteProgram(shader.glprogid);
+		shader.glprogid = 0;
+		g_program_disk_cache.Erase(uid);
+		return false;
+	}
+
+	shader.SetProgramVariables();
+	return true;
+}
+
+void ProgramShaderCache::ProcessCompiledPrograms()
+{
+	std::vector<CompileResult> results;
+	{
+		std::lock_guard<std::mutex> lk(s_compile_lock);
+		results.swap(s_compile_results);
+	}
+
+	for (const CompileResult& result : results)
+	{
+		PCacheEntry& entry = pshaders[result.uid];
+		entry.pending = false;
+		entry.shader.glprogid = result.glprogid;
+		s_num_pending--;
+
+		if (!result.glprogid)
+		{
+			GFX_DEBUGGER_PAUSE_AT(NEXT_ERROR, true);
+			continue;
+		}
+
+		// Uniform and sampler setup needs the program bound, so it can't
+		// happen on the compiler thread without racing CurrentProgram.
+		entry.shader.SetProgramVariables();
+
+		INCSTAT(stats.numPixelShadersCreated);
+		INCSTAT(stats.numShaderProgramsCompiledAsync);
+	}
+
+	SETSTAT(stats.numShaderProgramsPending, s_num_pending);
+	SETSTAT(stats.numPixelShadersAlive, pshaders.size());
+}
+
+void ProgramShaderCache::CompileThread(void* context)
+{
+	Common::SetCurrentThreadName("Shader compiler");
+
+	s_compile_thread_ok = GLInterface->MakeSharedContextCurrent(context);
+	s_compile_thread_started.Set();
+	if (!s_compile_thread_ok)
+		return;
+
+	while (true)
+	{
+		CompileJob job;
+		{
+			std::unique_lock<std::mutex> lk(s_compile_lock);
+			s_compile_cond.wait(lk, []{ return s_compile_quit || !s_compile_jobs.empty(); });
+			if (s_compile_quit)
+				break;
+			job = std::move(s_compile_jobs.front());
+			s_compile_jobs.pop_front();
+		}
+
+		SHADER shader;
+		CompileResult result;
+		result.uid = job.uid;
+		result.glprogid = LinkProgram(shader, job.vcode.c_str(), job.pcode.c_str()) ? shader.glprogid : 0;
+
+		// The program has to be complete before the video thread's context may use it.
+		glFinish();
+
+		std::lock_guard<std::mutex> lk(s_compile_lock);
+		s_compile_results.push_back(result);
+	}
+
+	GLInterface->ClearCurrent();
+}
+
+void ProgramShaderCache::StartCompileThreads()
+{
+	s_compile_quit = false;
+	s_num_pending = 0;
+
+	// Leave a core for the CPU and video threads each.
+	int num_threads = std::max(1, std::min(cpu_info.num_cores - 2, MAX_COMPILE_THREADS));
+	for (int i = 0; i < num_threads; ++i)
+	{
+		void* context = GLInterface->CreateSharedContext();
+		if (!context)
+			break;
+
+		s_compile_threads.push_back(std::thread(CompileThread, context));
+		s_compile_thread_started.Wait();
+		if (!s_compile_thread_ok)
+		{
+			s_compile_threads.back().join();
+			s_compile_threads.pop_back();
+			GLInterface->DestroySharedContext(context);
+			break;
+		}
+		s_compile_contexts.push_back(context);
+	}
+
+	if (s_compile_threads.empty())
+		WARN_LOG(VIDEO, "Shared contexts are not available, compiling shaders synchronously.");
+	else
+		INFO_LOG(VIDEO, "Compiling shaders on %d threads.", (int)s_compile_threads.size());
+}
+
+void ProgramShaderCache::StopCompileThreads()
+{
+	{
+		std::lock_guard<std::mutex> lk(s_compile_lock);
+		s_compile_quit = true;
+	}
+	s_compile_cond.notify_all();
+
+	for (std::thread& thread : s_compile_threads)
+		thread.join();
+	s_compile_threads.clear();
+
+	for (void* context : s_compile_contexts)
+		GLInterface->DestroySharedContext(context);
+	s_compile_contexts.clear();
+
+	// Whatever finished is destroyed along with the rest of the cache,
+	// jobs which never started stay pending with no program.
+	ProcessCompiledPrograms();
+	s_compile_jobs.clear();
+	s_num_pending = 0;
+}
+
 void ProgramShaderCache::Init(void)
 {
 	// We have to get the UBO alignment here because
@@ -387,27 +622,31 @@ void ProgramShaderCache::Init(void)
 			sprintf(cache_filename, "%sogl-%s-shaders.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
 				SConfig::GetInstance().m_LocalCoreStartupParameter.m_strUniqueID.c_str());
 
-			ProgramShaderCacheInserter inserter;
-			g_program_disk_cache.OpenAndRead(cache_filename, inserter);
+			// Programs are only loaded once they are needed, see LoadFromDiskCache.
+			g_program_disk_cache.Open(cache_filename);
 		}
-		SETSTAT(stats.numPixelShadersAlive, pshaders.size());
 	}
 
 	CreateHeader();
 
 	CurrentProgram = 0;
 	last_entry = NULL;
+
+	if (g_Config.bAsyncShaderCompilation)
+		StartCompileThreads();
 }
 
 void ProgramShaderCache::Shutdown(void)
 {
+	StopCompileThreads();
+
 	// store all shaders in cache on disk
-	if (g_ogl_config.bSupportsGLSLCache && !g_Config.bEnableShaderDebugging)
+	if (g_program_disk_cache.IsOpen())
 	{
 		PCache::iterator iter = pshaders.begin();
 		for (; iter != pshaders.end(); ++iter)
 		{
-			if(iter->second.in_cache) continue;
+			if(iter->second.in_cache || !iter->second.shader.glprogid) continue;
 
 			GLint binary_size;
 			glGetProgramiv(iter->second.shader.glprogid, GL_PROGRAM_BINARY_LENGTH, &binary_size);
@@ -422,7 +661,6 @@ void ProgramShaderCache::Shutdown(void)
 			delete [] data;
 		}
 
-		g_program_disk_cache.Sync();
 		g_program_disk_cache.Close();
 	}
 
@@ -487,28 +725,4 @@ void ProgramShaderCache::CreateHeader ( void )
 }
 
 
-void ProgramShaderCache::ProgramShaderCacheInserter::Read ( const SHADERUID& key, const u8* value, u32 value_size )
-{
-	const u8 *binary = value+sizeof(GLenum);
-	GLenum *prog_format = (GLenum*)value;
-	GLint binary_size = value_size-sizeof(GLenum);
-
-	PCacheEntry entry;
-	entry.in_cache = 1;
-	entry.shader.glprogid = glCreateProgram();
-	glProgramBinary(entry.shader.glprogid, *prog_format, binary, binary_size);
-
-	GLint success;
-	glGetProgramiv(entry.shader.glprogid, GL_LINK_STATUS, &success);
-
-	if (success)
-	{
-		pshaders[key] = entry;
-		entry.shader.SetProgramVariables();
-	}
-	else
-		glDeleteProgram(entry.shader.glprogid);
-}
-
-
 } // namespace OGL
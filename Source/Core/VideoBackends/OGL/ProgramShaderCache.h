@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include "Common/LinearDiskCache.h"
+#include "Common/IndexedDiskCache.h"
 #include "Core/ConfigManager.h"
 #include "VideoBackends/OGL/GLUtil.h"
 #include "VideoCommon/PixelShaderGen.h"
@@ -66,8 +66,11 @@ public:
 
 	struct PCacheEntry
 	{
+		PCacheEntry() : in_cache(false), pending(false) {}
+
 		SHADER shader;
 		bool in_cache;
+		bool pending; // queued on a compiler thread, not usable yet
 
 		void Destroy()
 		{
@@ -79,6 +82,8 @@ public:
 
 	static PCacheEntry GetShaderProgram(void);
 	static GLuint GetCurrentProgram(void);
+	// Returns NULL if the program failed to compile or is still being
+	// compiled asynchronously, the draw should be skipped in that case.
 	static SHADER* SetShader(DSTALPHA_MODE dstAlphaMode, u32 components);
 	static void GetShaderId(SHADERUID *uid, DSTALPHA_MODE dstAlphaMode, u32 components);
 
@@ -91,11 +96,18 @@ public:
 	static void CreateHeader(void);
 
 private:
-	class ProgramShaderCacheInserter : public LinearDiskCacheReader<SHADERUID, u8>
-	{
-	public:
-		void Read(const SHADERUID &key, const u8 *value, u32 value_size) override;
-	};
+	// Looks up a program binary stored by an earlier session. Binaries the
+	// driver rejects are dropped from the disk cache.
+	static bool LoadFromDiskCache(const SHADERUID& uid, SHADER& shader);
+
+	// Compiles and links without touching any GL state of the calling context,
+	// so it can run on a compiler thread.
+	static bool LinkProgram(SHADER &shader, const char* vcode, const char* pcode);
+
+	static void StartCompileThreads();
+	static void StopCompileThreads();
+	static void CompileThread(void* context);
+	static void ProcessCompiledPrograms();
 
 	static PCache pshaders;
 	static PCacheEntry* last_entry;
@@ -222,6 +222,8 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			SetCpControlRegister();
 			if (!IsOnThread())
 				RunGpu();
+			else
+				WakeGpuLoop();
 		})
 	);
 
@@ -233,6 +235,8 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			SetCpClearRegister();
 			if (!IsOnThread())
 				RunGpu();
+			else
+				WakeGpuLoop();
 		})
 	);
 
@@ -313,6 +317,7 @@ void STACKALIGN GatherPipeBursted()
 			if((ProcessorInterface::Fifo_CPUEnd == fifo.CPEnd) && (ProcessorInterface::Fifo_CPUBase == fifo.CPBase)
 				 && fifo.CPReadWriteDistance > 0)
 			{
+				WakeGpuLoop();
 				ProcessFifoAllDistance();
 			}
 		}
@@ -332,6 +337,8 @@ void STACKALIGN GatherPipeBursted()
 
 	if (!IsOnThread())
 		RunGpu();
+	else
+		WakeGpuLoop();
 
 	_assert_msg_(COMMANDPROCESSOR, fifo.CPReadWriteDistance <= fifo.CPEnd - fifo.CPBase,
 	"FIFO is overflowed by GatherPipe !\nCPU thread is too fast!");
@@ -357,6 +364,8 @@ void UpdateInterrupts(u64 userdata)
 		ProcessorInterface::SetInterrupt(INT_CAUSE_CP, false);
 	}
 	interruptWaiting = false;
+	if (IsOnThread())
+		WakeGpuLoop();
 }
 
 void UpdateInterruptsFromVideoBackend(u64 userdata)
@@ -2,6 +2,10 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
 #include "Common/Atomic.h"
 #include "Common/ChunkFile.h"
 #include "Common/FPURoundMode.h"
@@ -29,6 +33,21 @@ static std::mutex m_csHWVidOccupied;
 // STATE_TO_SAVE
 static u8 *videoBuffer;
 static int size = 0;
+
+// Set while RunGpuLoop decodes straight out of guest memory, see DecodeFifoData.
+static u8 *directDataEnd = nullptr;
+
+// RunGpuLoop sleeps on this while it has nothing to do, WakeGpuLoop ends the
+// sleep. The flags are only touched with the lock held when actually
+// sleeping, so waking a busy GPU thread costs two atomic operations.
+static std::mutex s_gpu_idle_lock;
+static std::condition_variable s_gpu_idle_cond;
+static std::atomic<bool> s_gpu_idle(false);
+static std::atomic<bool> s_gpu_wakeup(false);
+
+// Upper bound for one batch of the GPU loop, keeps any incomplete command
+// at the end of a batch well within the video buffer.
+static const u32 MAX_BATCH_SIZE = FIFO_SIZE / 2;
 }  // namespace
 
 void Fifo_DoState(PointerWrap &p)
@@ -79,7 +98,7 @@ u8* GetVideoBufferStartPtr()
 
 u8* GetVideoBufferEndPtr()
 {
-	return &videoBuffer[size];
+	return directDataEnd ? directDataEnd : &videoBuffer[size];
 }
 
 void Fifo_SetRendering(bool enabled)
@@ -98,11 +117,41 @@ void ExitGpuLoop()
 	// Terminate GPU thread loop
 	GpuRunningState = false;
 	EmuRunningState = true;
+	WakeGpuLoop();
 }
 
 void EmulatorState(bool running)
 {
 	EmuRunningState = running;
+	WakeGpuLoop();
+}
+
+void WakeGpuLoop()
+{
+	s_gpu_wakeup = true;
+	if (s_gpu_idle)
+	{
+		std::lock_guard<std::mutex> lk(s_gpu_idle_lock);
+		s_gpu_idle_cond.notify_one();
+	}
+}
+
+static bool GpuHasWork()
+{
+	SCPFifoStruct &fifo = CommandProcessor::fifo;
+	return !CommandProcessor::interruptWaiting && fifo.bFF_GPReadEnable && fifo.CPReadWriteDistance && !AtBreakpoint();
+}
+
+// Blocks until WakeGpuLoop is called or a millisecond passed. The timeout
+// keeps window messages flowing and covers state changes nobody signals.
+static void WaitForGpuWork()
+{
+	std::unique_lock<std::mutex> lk(s_gpu_idle_lock);
+	s_gpu_idle = true;
+	if (!s_gpu_wakeup && !GpuHasWork())
+		s_gpu_idle_cond.wait_for(lk, std::chrono::milliseconds(1), []{ return s_gpu_wakeup.load(); });
+	s_gpu_idle = false;
+	s_gpu_wakeup = false;
 }
 
 
@@ -131,6 +180,47 @@ void ResetVideoBuffer()
 	size = 0;
 }
 
+// Bytes RunGpuLoop can take from the read pointer in one go: everything the
+// CPU has written, but neither past the end of the FIFO nor the breakpoint.
+static u32 GetReadableSpan(const SCPFifoStruct &fifo)
+{
+	u32 readPtr = fifo.CPReadPointer;
+	u32 len = Common::AtomicLoad(fifo.CPReadWriteDistance);
+
+	if (readPtr <= fifo.CPEnd)
+		len = std::min(len, fifo.CPEnd - readPtr + 32);
+	else
+		len = 32;
+
+	if (fifo.bFF_BPEnable && fifo.CPBreakpoint > readPtr && fifo.CPBreakpoint - readPtr < len)
+		len = fifo.CPBreakpoint - readPtr;
+
+	return std::min(len, MAX_BATCH_SIZE);
+}
+
+// Decodes len bytes of FIFO data. Unless an incomplete command is left over
+// from the previous call, the data is decoded where it is and only the
+// incomplete command at its end, if any, gets copied to the video buffer.
+static u32 DecodeFifoData(u8* data, u32 len)
+{
+	if (g_pVideoData != GetVideoBufferEndPtr())
+	{
+		ReadDataFromFifo(data, len);
+		return OpcodeDecoder_Run(g_bSkipCurrentFrame);
+	}
+
+	g_pVideoData = data;
+	directDataEnd = data + len;
+	u32 cycles = OpcodeDecoder_Run(g_bSkipCurrentFrame);
+	u32 remaining = (u32)(directDataEnd - g_pVideoData);
+	directDataEnd = nullptr;
+
+	memmove(videoBuffer, g_pVideoData, remaining);
+	g_pVideoData = videoBuffer;
+	size = remaining;
+	return cycles;
+}
+
 
 // Description: Main FIFO update loop
 // Purpose: Keep the Core HW updated about the CPU-GPU distance
@@ -162,23 +252,30 @@ void RunGpuLoop()
 				u32 readPtr = fifo.CPReadPointer;
 				u8 *uData = Memory::GetPointer(readPtr);
 
-				if (readPtr == fifo.CPEnd)
+				// SyncGPU meters VITicks per block, otherwise take all there is.
+				u32 len = Core::g_CoreStartupParameter.bSyncGPU ? 32 : GetReadableSpan(fifo);
+
+				// An incomplete command from the last batch has to be copied
+				// together with the new data, which must fit the video buffer.
+				u32 pending = (u32)(GetVideoBufferEndPtr() - g_pVideoData);
+				if (pending && pending + len > FIFO_SIZE)
+					len = std::max<u32>(32, (FIFO_SIZE - pending) & ~31);
+
+				if (readPtr + len - 32 == fifo.CPEnd)
 					readPtr = fifo.CPBase;
 				else
-					readPtr += 32;
-
-				_assert_msg_(COMMANDPROCESSOR, (s32)fifo.CPReadWriteDistance - 32 >= 0 ,
-					"Negative fifo.CPReadWriteDistance = %i in FIFO Loop !\nThat can produce instability in the game. Please report it.", fifo.CPReadWriteDistance - 32);
+					readPtr += len;
 
-				ReadDataFromFifo(uData, 32);
+				_assert_msg_(COMMANDPROCESSOR, (s32)fifo.CPReadWriteDistance - (s32)len >= 0 ,
+					"Negative fifo.CPReadWriteDistance = %i in FIFO Loop !\nThat can produce instability in the game. Please report it.", fifo.CPReadWriteDistance - len);
 
-				cyclesExecuted = OpcodeDecoder_Run(g_bSkipCurrentFrame);
+				cyclesExecuted = DecodeFifoData(uData, len);
 
 				if (Core::g_CoreStartupParameter.bSyncGPU && Common::AtomicLoad(CommandProcessor::VITicks) > cyclesExecuted)
 					Common::AtomicAdd(CommandProcessor::VITicks, -(s32)cyclesExecuted);
 
 				Common::AtomicStore(fifo.CPReadPointer, readPtr);
-				Common::AtomicAdd(fifo.CPReadWriteDistance, -32);
+				Common::AtomicAdd(fifo.CPReadWriteDistance, -(s32)len);
 				if((GetVideoBufferEndPtr() - g_pVideoData) == 0)
 					Common::AtomicStore(fifo.SafeCPReadPointer, fifo.CPReadPointer);
 			}
@@ -196,12 +293,12 @@ void RunGpuLoop()
 
 		if (EmuRunningState)
 		{
-			// NOTE(jsd): Calling SwitchToThread() on Windows 7 x64 is a hot spot, according to profiler.
+			// Sleep instead of spinning until the CPU thread hands over more work.
+			// Yielding was tried before, but SwitchToThread() on Windows 7 x64 is a hot spot, according to profiler.
 			// See https://docs.google.com/spreadsheet/ccc?key=0Ah4nh0yGtjrgdFpDeF9pS3V6RUotRVE3S3J4TGM1NlE#gid=0
 			// for benchmark details.
-#if 0
-			Common::YieldCPU();
-#endif
+			if (GpuRunningState && EmuRunningState)
+				WaitForGpuWork();
 		}
 		else
 		{
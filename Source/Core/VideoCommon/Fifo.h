@@ -26,6 +26,8 @@ void RunGpu();
 void RunGpuLoop();
 void ExitGpuLoop();
 void EmulatorState(bool running);
+// Wakes RunGpuLoop up if it is waiting for work. Call after handing it some.
+void WakeGpuLoop();
 bool AtBreakpoint();
 void ResetVideoBuffer();
 void Fifo_SetRendering(bool bEnabled);
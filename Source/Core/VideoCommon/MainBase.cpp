@@ -116,6 +116,7 @@ void VideoBackendHardware::Video_EndField()
 	if (s_BackendInitialized)
 	{
 		Common::AtomicStoreRelease(s_swapRequested, true);
+		WakeGpuLoop();
 	}
 }
 
@@ -159,6 +160,7 @@ u32 VideoBackendHardware::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32
 
 		if (SConfig::GetInstance().m_LocalCoreStartupParameter.bCPUThread)
 		{
+			WakeGpuLoop();
 			while (Common::AtomicLoadAcquire(s_efbAccessRequested) && !s_FifoShuttingDown)
 				//Common::SleepCurrentThread(1);
 				Common::YieldCPU();
@@ -205,6 +207,7 @@ u32 VideoBackendHardware::Video_GetQueryResult(PerfQueryType type)
 		if (SConfig::GetInstance().m_LocalCoreStartupParameter.bCPUThread)
 		{
 			s_perf_query_requested = true;
+			WakeGpuLoop();
 			std::unique_lock<std::mutex> lk(s_perf_query_lock);
 			s_perf_query_cond.wait(lk, QueryResultIsReady);
 		}
@@ -12,8 +12,12 @@
 // while interpreting them, and hope that the vertex format doesn't change, though, if you do it right
 // when they are called. The reason is that the vertex format affects the sizes of the vertices.
 
+#include <unordered_map>
+#include <vector>
+
 #include "Common/Common.h"
 #include "Common/CPUDetect.h"
+#include "Common/Hash.h"
 #include "Core/Core.h"
 #include "Core/Host.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
@@ -25,6 +29,7 @@
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoader.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -79,6 +84,196 @@ extern u8* GetVideoBufferEndPtr();
 
 static void Decode();
 
+// Display list cache, see bDisplayListCache.
+// Display lists which are called again with the same data and vertex format are replayed
+// from the commands recorded on an earlier call: the NOP padding is skipped and primitives
+// go straight to the vertex loader they used back then. The vertex format is part of the
+// check because it determines the vertex sizes, and so where the commands start.
+// With bTextureWriteTracking, the data is only hashed again once its pages were written.
+struct DisplayListCommand
+{
+	u32 offset; // of the command byte
+	u8 cmd_byte;
+	u16 num_vertices;
+	VertexLoader* loader; // NULL for anything but primitives
+};
+
+struct CachedDisplayList
+{
+	CachedDisplayList() : num_calls(0), recorded(false), uncacheable(false), hash(0), hash_misses(0), skip_calls(0), tracked(false) {}
+
+	u32 num_calls;
+	bool recorded;
+	bool uncacheable; // calls other display lists or has illegal commands
+	u64 hash;
+	u32 hash_misses; // changes of the data in a row
+	u32 skip_calls; // calls left which bypass the cache, after too many changes
+	// Memory::TrackWrites state of the data, if it could be tracked
+	bool tracked;
+	u64 write_generation;
+	u64 write_count;
+	// Vertex format it was recorded with
+	u64 vtx_desc;
+	u32 vtx_attr[8][3];
+	std::vector<DisplayListCommand> commands;
+};
+
+enum
+{
+	MAX_CACHED_DISPLAY_LISTS = 4096,
+	// Lists which are rewritten before every call would be hashed, write protected and
+	// recorded each time for nothing, so they bypass the cache for a while instead.
+	MAX_HASH_MISSES = 4,
+	HASH_MISS_SKIP_CALLS = 64,
+};
+
+static std::unordered_map<u64, CachedDisplayList> s_display_list_cache;
+static CachedDisplayList* s_recording_list = NULL;
+static const u8* s_recording_start;
+
+static bool MatchesVertexFormat(const CachedDisplayList& list)
+{
+	if (list.vtx_desc != g_VtxDesc.Hex)
+		return false;
+	for (int i = 0; i < 8; ++i)
+	{
+		if (list.vtx_attr[i][0] != g_VtxAttr[i].g0.Hex ||
+			list.vtx_attr[i][1] != g_VtxAttr[i].g1.Hex ||
+			list.vtx_attr[i][2] != g_VtxAttr[i].g2.Hex)
+			return false;
+	}
+	return true;
+}
+
+// Returns the entry to replay the list from if it has recorded commands, or to record
+// them into otherwise. Returns NULL if the list shouldn't be cached (yet).
+static CachedDisplayList* GetCachedDisplayList(u32 address, u32 size, const u8* data)
+{
+	if (s_display_list_cache.size() >= MAX_CACHED_DISPLAY_LISTS)
+		s_display_list_cache.clear();
+
+	// Lists which are only called once aren't worth hashing and write protecting
+	CachedDisplayList& list = s_display_list_cache[((u64)address << 32) | size];
+	if (++list.num_calls < 2)
+		return NULL;
+
+	if (list.skip_calls)
+	{
+		list.skip_calls--;
+		return NULL;
+	}
+
+	// Write tracking is shared with the texture cache and follows its setting
+	const bool track_writes = g_ActiveConfig.bTextureWriteTracking;
+	bool unchanged;
+	if (track_writes && list.tracked && !Memory::HasBeenWritten(address, size, &list.write_generation, list.write_count))
+	{
+		unchanged = true;
+	}
+	else
+	{
+		// Protect the pages before hashing, so writes which happen during the hash are noticed next time
+		list.tracked = track_writes && Memory::TrackWrites(address, size, &list.write_generation, &list.write_count);
+		u64 hash = GetHash64(data, size, 0);
+		unchanged = list.num_calls > 2 && hash == list.hash;
+		list.hash = hash;
+
+		if (list.num_calls > 2 && !unchanged && ++list.hash_misses >= MAX_HASH_MISSES)
+		{
+			list.hash_misses = 0;
+			list.skip_calls = HASH_MISS_SKIP_CALLS;
+			list.recorded = false;
+			list.commands.clear();
+			return NULL;
+		}
+	}
+	if (unchanged)
+		list.hash_misses = 0;
+
+	if (unchanged && list.uncacheable)
+		return NULL;
+	if (unchanged && list.recorded && MatchesVertexFormat(list))
+		return &list;
+
+	list.recorded = false;
+	list.uncacheable = false;
+	list.commands.clear();
+	list.vtx_desc = g_VtxDesc.Hex;
+	for (int i = 0; i < 8; ++i)
+	{
+		list.vtx_attr[i][0] = g_VtxAttr[i].g0.Hex;
+		list.vtx_attr[i][1] = g_VtxAttr[i].g1.Hex;
+		list.vtx_attr[i][2] = g_VtxAttr[i].g2.Hex;
+	}
+	return &list;
+}
+
+// Called by Decode for every command of a list which is being recorded
+static void RecordCommand(const u8* opcodeStart, int cmd_byte)
+{
+	DisplayListCommand command;
+	command.offset = (u32)(opcodeStart - s_recording_start);
+	command.cmd_byte = cmd_byte;
+	command.num_vertices = 0;
+	command.loader = NULL;
+
+	switch (cmd_byte)
+	{
+	case GX_NOP:
+	case GX_CMD_UNKNOWN_METRICS:
+	case GX_CMD_INVL_VC:
+		// Nothing to replay
+		return;
+
+	case GX_LOAD_CP_REG:
+	case GX_LOAD_XF_REG:
+	case GX_LOAD_INDX_A:
+	case GX_LOAD_INDX_B:
+	case GX_LOAD_INDX_C:
+	case GX_LOAD_INDX_D:
+	case GX_LOAD_BP_REG:
+		break;
+
+	default:
+		if (cmd_byte & 0x80)
+		{
+			command.num_vertices = Common::swap16(opcodeStart + 1);
+			if (!command.num_vertices)
+				return;
+			command.loader = VertexLoaderManager::GetVertexLoader(cmd_byte & GX_VAT_MASK);
+		}
+		else
+		{
+			// Including GX_CMD_CALL_DL, the called list's commands can change the vertex format
+			s_recording_list->uncacheable = true;
+			return;
+		}
+		break;
+	}
+
+	s_recording_list->commands.push_back(command);
+}
+
+static void ReplayDisplayList(u8* startAddress, const CachedDisplayList& list)
+{
+	for (const DisplayListCommand& command : list.commands)
+	{
+		g_pVideoData = startAddress + command.offset;
+		if (command.loader)
+		{
+			DataSkip(3);
+			command.loader->RunVertices(
+				command.cmd_byte & GX_VAT_MASK,
+				(command.cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT,
+				command.num_vertices);
+		}
+		else
+		{
+			Decode();
+		}
+	}
+}
+
 void InterpretDisplayList(u32 address, u32 size)
 {
 	u8* old_pVideoData = g_pVideoData;
@@ -92,10 +287,37 @@ void InterpretDisplayList(u32 address, u32 size)
 		// temporarily swap dl and non-dl (small "hack" for the stats)
 		Statistics::SwapDL();
 
-		u8 *end = g_pVideoData + size;
-		while (g_pVideoData < end)
+		// Lists called from a list which is being recorded are never cached
+		CachedDisplayList* cached = NULL;
+		if (g_ActiveConfig.bDisplayListCache && !g_bRecordFifoData && !s_recording_list)
+			cached = GetCachedDisplayList(address, size, startAddress);
+
+		if (cached && cached->recorded)
 		{
-			Decode();
+			ReplayDisplayList(startAddress, *cached);
+			INCSTAT(stats.thisFrame.numDListsReplayed);
+		}
+		else
+		{
+			if (cached)
+			{
+				s_recording_list = cached;
+				s_recording_start = startAddress;
+			}
+
+			u8 *end = g_pVideoData + size;
+			while (g_pVideoData < end)
+			{
+				Decode();
+			}
+
+			if (cached)
+			{
+				cached->recorded = !cached->uncacheable;
+				if (!cached->recorded)
+					cached->commands.clear();
+				s_recording_list = NULL;
+			}
 		}
 		INCSTAT(stats.numDListsCalled);
 		INCSTAT(stats.thisFrame.numDListsCalled);
@@ -367,6 +589,9 @@ static void Decode()
 	// Display lists get added directly into the FIFO stream
 	if (g_bRecordFifoData && cmd_byte != GX_CMD_CALL_DL)
 		FifoRecorder::GetInstance().WriteGPCommand(opcodeStart, u32(g_pVideoData - opcodeStart));
+
+	if (s_recording_list)
+		RecordCommand(opcodeStart, cmd_byte);
 }
 
 static void DecodeSemiNop()
@@ -455,6 +680,7 @@ static void DecodeSemiNop()
 void OpcodeDecoder_Init()
 {
 	g_pVideoData = GetVideoBufferStartPtr();
+	s_display_list_cache.clear();
 
 #if _M_SSE >= 0x301
 	if (cpu_info.bSSSE3)
@@ -468,6 +694,8 @@ void OpcodeDecoder_Init()
 
 void OpcodeDecoder_Shutdown()
 {
+	// The vertex loaders of the recorded commands are gone with the backend
+	s_display_list_cache.clear();
 }
 
 u32 OpcodeDecoder_Run(bool skipped_frame)
@@ -33,13 +33,19 @@ char *Statistics::ToString(char *ptr)
 	ptr+=sprintf(ptr,"pshaders (unique, delete cache first): %i\n",stats.numUniquePixelShaders);
 	ptr+=sprintf(ptr,"vshaders created: %i\n",stats.numVertexShadersCreated);
 	ptr+=sprintf(ptr,"vshaders alive: %i\n",stats.numVertexShadersAlive);
+	ptr+=sprintf(ptr,"programs pending: %i\n",stats.numShaderProgramsPending);
+	ptr+=sprintf(ptr,"programs compiled (async): %i\n",stats.numShaderProgramsCompiledAsync);
 	ptr+=sprintf(ptr,"dlists called:    %i\n",stats.numDListsCalled);
 	ptr+=sprintf(ptr,"dlists called(f): %i\n",stats.thisFrame.numDListsCalled);
+	ptr+=sprintf(ptr,"dlists replayed(f): %i\n",stats.thisFrame.numDListsReplayed);
 	ptr+=sprintf(ptr,"dlists alive:     %i\n",stats.numDListsAlive);
 	ptr+=sprintf(ptr,"Primitive joins: %i\n",stats.thisFrame.numPrimitiveJoins);
 	ptr+=sprintf(ptr,"Draw calls:       %i\n",stats.thisFrame.numDrawCalls);
 	ptr+=sprintf(ptr,"Indexed draw calls: %i\n",stats.thisFrame.numIndexedDrawCalls);
 	ptr+=sprintf(ptr,"Buffer splits:    %i\n",stats.thisFrame.numBufferSplits);
+	ptr+=sprintf(ptr,"Skipped draw calls: %i\n",stats.thisFrame.numSkippedDrawCalls);
+	ptr+=sprintf(ptr,"Texture hashes skipped: %i\n",stats.thisFrame.numTextureHashSkips);
+	ptr+=sprintf(ptr,"Texture rehashes: %i\n",stats.thisFrame.numTextureRehashes);
 	ptr+=sprintf(ptr,"Primitives: %i\n",stats.thisFrame.numPrims);
 	ptr+=sprintf(ptr,"Primitives (DL): %i\n",stats.thisFrame.numDLPrims);
 	ptr+=sprintf(ptr,"XF loads: %i\n",stats.thisFrame.numXFLoads);
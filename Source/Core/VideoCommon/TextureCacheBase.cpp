@@ -370,8 +370,6 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	else
 		src_data = Memory::GetPointer(address);
 
-	// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)
-	tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
 	if (isPaletteTexture)
 	{
 		const u32 palette_size = TexDecoder_GetPaletteSize(texformat);
@@ -387,17 +385,49 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 		//
 		// TODO: Because texID isn't always the same as the address now, CopyRenderTargetToTexture might be broken now
 		texID ^= ((u32)tlut_hash) ^(u32)(tlut_hash >> 32);
-		tex_hash ^= tlut_hash;
 	}
 
+	TCacheEntryBase *entry = textures[texID];
+
+	// With write tracking, RAM textures only need to be hashed again if the guest wrote to their pages since the last hash
+	u64 write_generation = 0, write_count = 0;
+	bool data_tracked = false;
+	const bool track_writes = g_ActiveConfig.bTextureWriteTracking && !from_tmem;
+	if (track_writes && entry && entry->data_tracked && entry->addr == address && entry->size_in_bytes == texture_size &&
+		!Memory::HasBeenWritten(address, texture_size, &entry->write_generation, entry->write_count))
+	{
+		tex_hash = entry->data_hash;
+		write_generation = entry->write_generation;
+		write_count = entry->write_count;
+		data_tracked = true;
+		INCSTAT(stats.thisFrame.numTextureHashSkips);
+	}
+	else
+	{
+		// Protect the pages before hashing, so writes which happen during the hash are noticed next time
+		if (track_writes)
+			data_tracked = Memory::TrackWrites(address, texture_size, &write_generation, &write_count);
+
+		// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)
+		tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+		INCSTAT(stats.thisFrame.numTextureRehashes);
+	}
+
+	const u64 data_hash = tex_hash;
+	if (isPaletteTexture)
+		tex_hash ^= tlut_hash;
+
 	// D3D doesn't like when the specified mipmap count would require more than one 1x1-sized LOD in the mipmap chain
 	// e.g. 64x64 with 7 LODs would have the mipmap chain 64x64,32x32,16x16,8x8,4x4,2x2,1x1,1x1, so we limit the mipmap count to 6 there
 	while (g_ActiveConfig.backend_info.bUseMinimalMipCount && max(expandedWidth, expandedHeight) >> maxlevel == 0)
 		--maxlevel;
 
-	TCacheEntryBase *entry = textures[texID];
 	if (entry)
 	{
+		// The entry is either returned below or reset further down, so it can take the new tracking state right away
+		if (entry->addr == address && entry->size_in_bytes == texture_size)
+			entry->SetDataHash(data_hash, data_tracked, write_generation, write_count);
+
 		// 1. Calculate reference hash:
 		// calculated from RAM texture data for normal textures. Hashes for paletted textures are modified by tlut_hash. 0 for virtual EFB copies.
 		if (g_ActiveConfig.bCopyEFBToTexture && entry->IsEfbCopy())
@@ -510,6 +540,7 @@ TextureCache::TCacheEntryBase* TextureCache::Load(unsigned int const stage,
 	entry->SetGeneralParameters(address, texture_size, full_format, entry->num_mipmaps);
 	entry->SetDimensions(nativeW, nativeH, width, height);
 	entry->hash = tex_hash;
+	entry->SetDataHash(data_hash, data_tracked, write_generation, write_count);
 
 	if (entry->IsEfbCopy() && !g_ActiveConfig.bCopyEFBToTexture)
 		entry->type = TCET_EC_DYNAMIC;
@@ -45,6 +45,13 @@ public:
 		// used to delete textures which haven't been used for TEXTURE_KILL_THRESHOLD frames
 		int frameCount;
 
+		// RAM data hash (without the tlut) and its Memory::TrackWrites state, see bTextureWriteTracking
+		u64 data_hash;
+		u64 write_generation, write_count;
+		bool data_tracked;
+
+		TCacheEntryBase() : data_tracked(false) {}
+
 
 		void SetGeneralParameters(u32 _addr, u32 _size, u32 _format, unsigned int _num_mipmaps)
 		{
@@ -62,9 +69,18 @@ public:
 			virtual_height = _virtual_height;
 		}
 
+		void SetDataHash(u64 _data_hash, bool _tracked, u64 _write_generation, u64 _write_count)
+		{
+			data_hash = _data_hash;
+			data_tracked = _tracked;
+			write_generation = _write_generation;
+			write_count = _write_count;
+		}
+
 		void SetHashes(u64 _hash/*, u32 _pal_hash*/)
 		{
 			hash = _hash;
+			data_tracked = false;
 			//pal_hash = _pal_hash;
 		}
 
@@ -89,6 +89,18 @@ static const float fractionTable[32] = {
 
 using namespace Gen;
 
+#if defined(USE_JIT) && defined(_M_X64)
+// Registers used by the compiled loop. All of them are callee saved, so they
+// survive the calls to the component functions.
+static const X64Reg SRC_REG = R12;
+static const X64Reg DST_REG = R13;
+static const X64Reg COUNT_REG = R14;
+
+static const int s_component_sizes[5] = {1, 1, 2, 2, 4};
+// Normals are fixed point numbers with 6, 7, 14 or 15 fraction bits.
+static const int s_normal_frac[4] = {7, 6, 15, 14};
+#endif
+
 void LOADERDECL PosMtx_ReadDirect_UByte()
 {
 	s_curposmtx = DataReadU8() & 0x3f;
@@ -467,9 +479,17 @@ void LOADERDECL TexMtx_Write_Float4()
 	DataWrite(0.f);
 }
 
-VertexLoader::VertexLoader(const TVtxDesc &vtx_desc, const VAT &vtx_attr)
+VertexLoader::VertexLoader(const TVtxDesc &vtx_desc, const VAT &vtx_attr, bool inline_components)
 {
 	m_compiledCode = NULL;
+#if defined(USE_JIT) && defined(_M_X64)
+	m_inline = inline_components;
+#else
+	m_inline = false;
+#endif
+	m_pointers_loaded = false;
+	m_src_offset = 0;
+	m_dst_offset = 0;
 	m_numLoadedVertices = 0;
 	m_VertexSize = 0;
 	m_numPipelineStages = 0;
@@ -512,12 +532,20 @@ void VertexLoader::CompileVertexTranslator()
 	m_compiledCode = GetCodePtr();
 	ABI_PushAllCalleeSavedRegsAndAdjustStack();
 
+#ifdef _M_X64
+	MOV(64, R(RAX), Imm64((u64)&loop_counter));
+	MOV(32, R(COUNT_REG), MatR(RAX));
+	if (m_inline)
+		LoadPointers();
+#endif
+
 	// Start loop here
 	const u8 *loop_start = GetCodePtr();
 
 	// Reset component counters if present in vertex format only.
-	if (m_VtxDesc.Tex0Coord || m_VtxDesc.Tex1Coord || m_VtxDesc.Tex2Coord || m_VtxDesc.Tex3Coord ||
-		m_VtxDesc.Tex4Coord || m_VtxDesc.Tex5Coord || m_VtxDesc.Tex6Coord || m_VtxDesc.Tex7Coord)
+	// Inline texture coordinates don't need tcIndex.
+	if (!m_inline && (m_VtxDesc.Tex0Coord || m_VtxDesc.Tex1Coord || m_VtxDesc.Tex2Coord || m_VtxDesc.Tex3Coord ||
+		m_VtxDesc.Tex4Coord || m_VtxDesc.Tex5Coord || m_VtxDesc.Tex6Coord || m_VtxDesc.Tex7Coord))
 	{
 		WriteSetVariable(32, &tcIndex, Imm32(0));
 	}
@@ -556,7 +584,8 @@ void VertexLoader::CompileVertexTranslator()
 	// Position Matrix Index
 	if (m_VtxDesc.PosMatIdx)
 	{
-		WriteCall(PosMtx_ReadDirect_UByte);
+		if (!WriteInlinePosMtxRead())
+			WriteCall(PosMtx_ReadDirect_UByte);
 		components |= VB_HAS_POSMTXIDX;
 		m_VertexSize += 1;
 	}
@@ -577,7 +606,7 @@ void VertexLoader::CompileVertexTranslator()
 		WriteCall(VertexLoader_Position::GetFunction(m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements));
 		WriteCall(UpdateBoundingBox);
 	}
-	else
+	else if (!WriteInlinePosition())
 	{
 		WriteCall(VertexLoader_Position::GetFunction(m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements));
 	}
@@ -605,7 +634,8 @@ void VertexLoader::CompileVertexTranslator()
 				m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 
 				m_VtxAttr.NormalElements, m_VtxAttr.NormalIndex3).c_str());
 		}
-		WriteCall(pFunc);
+		if (!WriteInlineNormal())
+			WriteCall(pFunc);
 
 		for (int i = 0; i < (vtx_attr.NormalElements ? 3 : 1); i++)
 		{
@@ -629,6 +659,7 @@ void VertexLoader::CompileVertexTranslator()
 		vtx_decl.colors[i].components = 4;
 		vtx_decl.colors[i].type = VAR_UNSIGNED_BYTE;
 		vtx_decl.colors[i].integer = false;
+		TPipelineFunction pFunc = NULL;
 		switch (col[i])
 		{
 		case NOT_PRESENT:
@@ -636,12 +667,12 @@ void VertexLoader::CompileVertexTranslator()
 		case DIRECT:
 			switch (m_VtxAttr.color[i].Comp)
 			{
-			case FORMAT_16B_565:  m_VertexSize += 2; WriteCall(Color_ReadDirect_16b_565); break;
-			case FORMAT_24B_888:  m_VertexSize += 3; WriteCall(Color_ReadDirect_24b_888); break;
-			case FORMAT_32B_888x: m_VertexSize += 4; WriteCall(Color_ReadDirect_32b_888x); break;
-			case FORMAT_16B_4444: m_VertexSize += 2; WriteCall(Color_ReadDirect_16b_4444); break;
-			case FORMAT_24B_6666: m_VertexSize += 3; WriteCall(Color_ReadDirect_24b_6666); break;
-			case FORMAT_32B_8888: m_VertexSize += 4; WriteCall(Color_ReadDirect_32b_8888); break;
+			case FORMAT_16B_565:  m_VertexSize += 2; pFunc = Color_ReadDirect_16b_565; break;
+			case FORMAT_24B_888:  m_VertexSize += 3; pFunc = Color_ReadDirect_24b_888; break;
+			case FORMAT_32B_888x: m_VertexSize += 4; pFunc = Color_ReadDirect_32b_888x; break;
+			case FORMAT_16B_4444: m_VertexSize += 2; pFunc = Color_ReadDirect_16b_4444; break;
+			case FORMAT_24B_6666: m_VertexSize += 3; pFunc = Color_ReadDirect_24b_6666; break;
+			case FORMAT_32B_8888: m_VertexSize += 4; pFunc = Color_ReadDirect_32b_8888; break;
 			default: _assert_(0); break;
 			}
 			break;
@@ -649,12 +680,12 @@ void VertexLoader::CompileVertexTranslator()
 			m_VertexSize += 1;
 			switch (m_VtxAttr.color[i].Comp)
 			{
-			case FORMAT_16B_565:  WriteCall(Color_ReadIndex8_16b_565); break;
-			case FORMAT_24B_888:  WriteCall(Color_ReadIndex8_24b_888); break;
-			case FORMAT_32B_888x: WriteCall(Color_ReadIndex8_32b_888x); break;
-			case FORMAT_16B_4444: WriteCall(Color_ReadIndex8_16b_4444); break;
-			case FORMAT_24B_6666: WriteCall(Color_ReadIndex8_24b_6666); break;
-			case FORMAT_32B_8888: WriteCall(Color_ReadIndex8_32b_8888); break;
+			case FORMAT_16B_565:  pFunc = Color_ReadIndex8_16b_565; break;
+			case FORMAT_24B_888:  pFunc = Color_ReadIndex8_24b_888; break;
+			case FORMAT_32B_888x: pFunc = Color_ReadIndex8_32b_888x; break;
+			case FORMAT_16B_4444: pFunc = Color_ReadIndex8_16b_4444; break;
+			case FORMAT_24B_6666: pFunc = Color_ReadIndex8_24b_6666; break;
+			case FORMAT_32B_8888: pFunc = Color_ReadIndex8_32b_8888; break;
 			default: _assert_(0); break;
 			}
 			break;
@@ -662,12 +693,12 @@ void VertexLoader::CompileVertexTranslator()
 			m_VertexSize += 2;
 			switch (m_VtxAttr.color[i].Comp)
 			{
-			case FORMAT_16B_565:  WriteCall(Color_ReadIndex16_16b_565); break;
-			case FORMAT_24B_888:  WriteCall(Color_ReadIndex16_24b_888); break;
-			case FORMAT_32B_888x: WriteCall(Color_ReadIndex16_32b_888x); break;
-			case FORMAT_16B_4444: WriteCall(Color_ReadIndex16_16b_4444); break;
-			case FORMAT_24B_6666: WriteCall(Color_ReadIndex16_24b_6666); break;
-			case FORMAT_32B_8888: WriteCall(Color_ReadIndex16_32b_8888); break;
+			case FORMAT_16B_565:  pFunc = Color_ReadIndex16_16b_565; break;
+			case FORMAT_24B_888:  pFunc = Color_ReadIndex16_24b_888; break;
+			case FORMAT_32B_888x: pFunc = Color_ReadIndex16_32b_888x; break;
+			case FORMAT_16B_4444: pFunc = Color_ReadIndex16_16b_4444; break;
+			case FORMAT_24B_6666: pFunc = Color_ReadIndex16_24b_6666; break;
+			case FORMAT_32B_8888: pFunc = Color_ReadIndex16_32b_8888; break;
 			default: _assert_(0); break;
 			}
 			break;
@@ -675,6 +706,10 @@ void VertexLoader::CompileVertexTranslator()
 		// Common for the three bottom cases
 		if (col[i] != NOT_PRESENT)
 		{
+			// Indexed by the number of colors before this one, like colIndex
+			if (!WriteInlineColor(i, (components & VB_HAS_COL0) ? 1 : 0))
+				WriteCall(pFunc);
+
 			components |= VB_HAS_COL0 << i;
 			vtx_decl.colors[i].offset = nat_offset;
 			vtx_decl.colors[i].enable = true;
@@ -703,7 +738,8 @@ void VertexLoader::CompileVertexTranslator()
 			_assert_msg_(VIDEO, 0 <= elements && elements <= 1, "Invalid number of texture coordinates elements!\n(elements = %d)", elements);
 
 			components |= VB_HAS_UV0 << i;
-			WriteCall(VertexLoader_TextCoord::GetFunction(tc[i], format, elements));
+			if (!WriteInlineTexCoord(i, tc[i]))
+				WriteCall(VertexLoader_TextCoord::GetFunction(tc[i], format, elements));
 			m_VertexSize += VertexLoader_TextCoord::GetSize(tc[i], format, elements);
 		}
 
@@ -743,7 +779,8 @@ void VertexLoader::CompileVertexTranslator()
 			{
 				if (tc[j] != NOT_PRESENT)
 				{
-					WriteCall(VertexLoader_TextCoord::GetDummyFunction()); // important to get indices right!
+					if (!m_inline)
+						WriteCall(VertexLoader_TextCoord::GetDummyFunction()); // important to get indices right!
 					break;
 				}
 			}
@@ -758,7 +795,8 @@ void VertexLoader::CompileVertexTranslator()
 
 	if (m_VtxDesc.PosMatIdx)
 	{
-		WriteCall(PosMtx_Write);
+		if (!WriteInlinePosMtxWrite())
+			WriteCall(PosMtx_Write);
 		vtx_decl.posmtx.components = 4;
 		vtx_decl.posmtx.enable = true;
 		vtx_decl.posmtx.offset = nat_offset;
@@ -773,13 +811,31 @@ void VertexLoader::CompileVertexTranslator()
 #ifdef USE_JIT
 	// End loop here
 #ifdef _M_X64
-	MOV(64, R(RAX), Imm64((u64)&loop_counter));
-	SUB(32, MatR(RAX), Imm8(1));
+	if (m_inline)
+	{
+		// The pointer registers have to be current at the start of the loop.
+		if (m_pointers_loaded)
+		{
+			if (m_src_offset)
+				ADD(64, R(SRC_REG), Imm32(m_src_offset));
+			if (m_dst_offset)
+				ADD(64, R(DST_REG), Imm32(m_dst_offset));
+			m_src_offset = 0;
+			m_dst_offset = 0;
+		}
+		else
+		{
+			LoadPointers();
+		}
+	}
+	SUB(32, R(COUNT_REG), Imm8(1));
+	J_CC(CC_NZ, loop_start, true);
+	StorePointers();
 #else
 	SUB(32, M(&loop_counter), Imm8(1));
+	J_CC(CC_NZ, loop_start, true);
 #endif
 
-	J_CC(CC_NZ, loop_start, true);
 	ABI_PopAllCalleeSavedRegsAndAdjustStack();
 	RET();
 #endif
@@ -792,6 +848,7 @@ void VertexLoader::WriteCall(TPipelineFunction func)
 {
 #ifdef USE_JIT
 #ifdef _M_X64
+	StorePointers();
 	MOV(64, R(RAX), Imm64((u64)func));
 	CALLptr(R(RAX));
 #else
@@ -828,6 +885,293 @@ void VertexLoader::WriteSetVariable(int bits, void *address, OpArg value)
 }
 #endif
 
+#if defined(USE_JIT) && defined(_M_X64)
+void VertexLoader::LoadPointers()
+{
+	if (m_pointers_loaded)
+		return;
+
+	MOV(64, R(RAX), Imm64((u64)&g_pVideoData));
+	MOV(64, R(SRC_REG), MatR(RAX));
+	MOV(64, R(RAX), Imm64((u64)&VertexManager::s_pCurBufferPointer));
+	MOV(64, R(DST_REG), MatR(RAX));
+	m_pointers_loaded = true;
+	m_src_offset = 0;
+	m_dst_offset = 0;
+}
+
+void VertexLoader::StorePointers()
+{
+	if (!m_pointers_loaded)
+		return;
+
+	if (m_src_offset)
+		ADD(64, R(SRC_REG), Imm32(m_src_offset));
+	if (m_dst_offset)
+		ADD(64, R(DST_REG), Imm32(m_dst_offset));
+	MOV(64, R(RAX), Imm64((u64)&g_pVideoData));
+	MOV(64, MatR(RAX), R(SRC_REG));
+	MOV(64, R(RAX), Imm64((u64)&VertexManager::s_pCurBufferPointer));
+	MOV(64, MatR(RAX), R(DST_REG));
+	m_pointers_loaded = false;
+}
+
+// Reads an index from the vertex and leaves the address of the array element in RCX.
+void VertexLoader::WriteIndexedAddress(int index_size, int array)
+{
+	if (index_size == 1)
+	{
+		MOVZX(32, 8, ECX, MDisp(SRC_REG, m_src_offset));
+	}
+	else
+	{
+		MOVZX(32, 16, ECX, MDisp(SRC_REG, m_src_offset));
+		ROL(16, R(ECX), Imm8(8));
+	}
+	m_src_offset += index_size;
+
+	MOV(64, R(RAX), Imm64((u64)&arraystrides[array]));
+	IMUL(32, ECX, MatR(RAX));
+	MOV(64, R(RAX), Imm64((u64)&cached_arraybases[array]));
+	ADD(64, R(RCX), MatR(RAX));
+}
+
+// Converts count big endian components at src + src_offset to floats, up to four at a time.
+// Integer components are multiplied by *scale, which is read when the code runs.
+void VertexLoader::WriteToFloats(X64Reg src, int src_offset, int format, int count, const float *scale)
+{
+	if (format == FORMAT_FLOAT)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			MOV(32, R(EAX), MDisp(src, src_offset + i * 4));
+			BSWAP(32, EAX);
+			MOV(32, MDisp(DST_REG, m_dst_offset + i * 4), R(EAX));
+		}
+		m_dst_offset += count * 4;
+		return;
+	}
+
+	const int size = s_component_sizes[format];
+	const bool is_signed = format == FORMAT_BYTE || format == FORMAT_SHORT;
+	for (int first = 0; first < count; first += 4)
+	{
+		const int n = std::min(count - first, 4);
+
+		// Gather the components as 16 bit words
+		for (int i = 0; i < n; i++)
+		{
+			OpArg component = MDisp(src, src_offset + (first + i) * size);
+			if (size == 2)
+			{
+				PINSRW(XMM0, component, i);
+			}
+			else
+			{
+				if (is_signed)
+					MOVSX(32, 8, EAX, component);
+				else
+					MOVZX(32, 8, EAX, component);
+				PINSRW(XMM0, R(EAX), i);
+			}
+		}
+		if (size == 2)
+		{
+			MOVAPS(XMM1, R(XMM0));
+			PSRLW(XMM0, 8);
+			PSLLW(XMM1, 8);
+			POR(XMM0, R(XMM1));
+		}
+
+		// Widen to 32 bit, convert and scale
+		PUNPCKLWD(XMM0, R(XMM0));
+		if (is_signed)
+			PSRAD(XMM0, 16);
+		else
+			PSRLD(XMM0, 16);
+		CVTDQ2PS(XMM0, R(XMM0));
+		MOV(64, R(RAX), Imm64((u64)scale));
+		MOVSS(XMM1, MatR(RAX));
+		SHUFPS(XMM1, R(XMM1), 0);
+		MULPS(XMM0, R(XMM1));
+
+		const OpArg dst = MDisp(DST_REG, m_dst_offset);
+		switch (n)
+		{
+		case 1:
+			MOVSS(dst, XMM0);
+			break;
+		case 2:
+			MOVQ_xmm(dst, XMM0);
+			break;
+		case 3:
+			MOVQ_xmm(dst, XMM0);
+			SHUFPS(XMM0, R(XMM0), 2);
+			MOVSS(MDisp(DST_REG, m_dst_offset + 8), XMM0);
+			break;
+		case 4:
+			MOVUPS(dst, XMM0);
+			break;
+		}
+		m_dst_offset += n * 4;
+	}
+}
+
+bool VertexLoader::WriteInlinePosition()
+{
+	const int format = m_VtxAttr.PosFormat;
+	const int count = m_VtxAttr.PosElements ? 3 : 2;
+	if (!m_inline || m_VtxDesc.Position == NOT_PRESENT || format > FORMAT_FLOAT)
+		return false;
+
+	LoadPointers();
+	if (m_VtxDesc.Position == DIRECT)
+	{
+		WriteToFloats(SRC_REG, m_src_offset, format, count, &posScale);
+		m_src_offset += count * s_component_sizes[format];
+	}
+	else
+	{
+		WriteIndexedAddress(m_VtxDesc.Position == INDEX8 ? 1 : 2, ARRAY_POSITION);
+		WriteToFloats(RCX, 0, format, count, &posScale);
+	}
+
+	if (count == 2)
+	{
+		MOV(32, MDisp(DST_REG, m_dst_offset), Imm32(0));
+		m_dst_offset += 4;
+	}
+	return true;
+}
+
+bool VertexLoader::WriteInlineNormal()
+{
+	const int format = m_VtxAttr.NormalFormat;
+	const int count = m_VtxAttr.NormalElements ? 9 : 3;
+	if (!m_inline || format > FORMAT_FLOAT)
+		return false;
+
+	const float *scale = format == FORMAT_FLOAT ? NULL : &fractionTable[s_normal_frac[format]];
+	LoadPointers();
+	if (m_VtxDesc.Normal == DIRECT)
+	{
+		WriteToFloats(SRC_REG, m_src_offset, format, count, scale);
+		m_src_offset += count * s_component_sizes[format];
+	}
+	else if (m_VtxAttr.NormalElements && m_VtxAttr.NormalIndex3)
+	{
+		// One index for each of the normal, binormal and tangent
+		for (int i = 0; i < 3; i++)
+		{
+			WriteIndexedAddress(m_VtxDesc.Normal == INDEX8 ? 1 : 2, ARRAY_NORMAL);
+			WriteToFloats(RCX, i * 3 * s_component_sizes[format], format, 3, scale);
+		}
+	}
+	else
+	{
+		WriteIndexedAddress(m_VtxDesc.Normal == INDEX8 ? 1 : 2, ARRAY_NORMAL);
+		WriteToFloats(RCX, 0, format, count, scale);
+	}
+	return true;
+}
+
+bool VertexLoader::WriteInlineColor(int i, int color_index)
+{
+	const u32 type = i ? m_VtxDesc.Color1 : m_VtxDesc.Color0;
+	const int format = m_VtxAttr.color[i].Comp;
+	if (!m_inline || (format != FORMAT_24B_888 && format != FORMAT_32B_888x && format != FORMAT_32B_8888))
+		return false;
+
+	LoadPointers();
+	if (type == DIRECT)
+	{
+		// Like Color_ReadDirect_24b_888, this reads one byte past the color
+		MOV(32, R(EAX), MDisp(SRC_REG, m_src_offset));
+		m_src_offset += format == FORMAT_24B_888 ? 3 : 4;
+	}
+	else
+	{
+		WriteIndexedAddress(type == INDEX8 ? 1 : 2, ARRAY_COLOR + color_index);
+		MOV(32, R(EAX), MatR(RCX));
+	}
+
+	// Only direct RGBA8 colors keep their alpha, and only with colElements set
+	if (format != FORMAT_32B_8888 || (type == DIRECT && !m_VtxAttr.color[color_index].Elements))
+		OR(32, R(EAX), Imm32(0xFF000000));
+	MOV(32, MDisp(DST_REG, m_dst_offset), R(EAX));
+	m_dst_offset += 4;
+
+	// A second color may still be read by a component function
+	if (i == 0 && m_VtxDesc.Color1 != NOT_PRESENT)
+	{
+		MOV(64, R(RAX), Imm64((u64)&colIndex));
+		ADD(32, MatR(RAX), Imm8(1));
+	}
+	return true;
+}
+
+bool VertexLoader::WriteInlineTexCoord(int i, int type)
+{
+	const int format = m_VtxAttr.texCoord[i].Format;
+	const int count = m_VtxAttr.texCoord[i].Elements ? 2 : 1;
+	if (!m_inline || format > FORMAT_FLOAT)
+		return false;
+
+	LoadPointers();
+	if (type == DIRECT)
+	{
+		WriteToFloats(SRC_REG, m_src_offset, format, count, &tcScale[i]);
+		m_src_offset += count * s_component_sizes[format];
+	}
+	else
+	{
+		WriteIndexedAddress(type == INDEX8 ? 1 : 2, ARRAY_TEXCOORD0 + i);
+		WriteToFloats(RCX, 0, format, count, &tcScale[i]);
+	}
+	return true;
+}
+
+bool VertexLoader::WriteInlinePosMtxRead()
+{
+	if (!m_inline)
+		return false;
+
+	LoadPointers();
+	MOVZX(32, 8, ECX, MDisp(SRC_REG, m_src_offset));
+	m_src_offset += 1;
+	AND(32, R(ECX), Imm8(0x3f));
+	MOV(64, R(RAX), Imm64((u64)&s_curposmtx));
+	MOV(8, MatR(RAX), R(ECX));
+	return true;
+}
+
+bool VertexLoader::WriteInlinePosMtxWrite()
+{
+	if (!m_inline)
+		return false;
+
+	LoadPointers();
+	MOV(64, R(RAX), Imm64((u64)&s_curposmtx));
+	MOVZX(32, 8, ECX, MatR(RAX));
+	MOV(32, MDisp(DST_REG, m_dst_offset), R(ECX));
+	m_dst_offset += 4;
+
+	// Back to the default matrix, see PosMtx_Write
+	MOV(64, R(RCX), Imm64((u64)&MatrixIndexA));
+	MOV(32, R(ECX), MatR(RCX));
+	AND(32, R(ECX), Imm8(0x3f));
+	MOV(8, MatR(RAX), R(ECX));
+	return true;
+}
+#else
+bool VertexLoader::WriteInlinePosition() { return false; }
+bool VertexLoader::WriteInlineNormal() { return false; }
+bool VertexLoader::WriteInlineColor(int i, int color_index) { return false; }
+bool VertexLoader::WriteInlineTexCoord(int i, int type) { return false; }
+bool VertexLoader::WriteInlinePosMtxRead() { return false; }
+bool VertexLoader::WriteInlinePosMtxWrite() { return false; }
+#endif
+
 void VertexLoader::SetupRunVertices(int vtx_attr_group, int primitive, int const count)
 {
 	m_numLoadedVertices += count;
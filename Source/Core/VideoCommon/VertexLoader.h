@@ -89,13 +89,19 @@ class VertexLoader
 #endif
 {
 public:
-	VertexLoader(const TVtxDesc &vtx_desc, const VAT &vtx_attr);
+	// Without inline_components, the compiled code calls the component functions
+	// for every vertex. Only meant for comparing the two in tests.
+	VertexLoader(const TVtxDesc &vtx_desc, const VAT &vtx_attr, bool inline_components = true);
 	~VertexLoader();
 
 	int GetVertexSize() const {return m_VertexSize;}
+	int GetNativeVertexSize() const {return native_stride;}
 
 	void SetupRunVertices(int vtx_attr_group, int primitive, int const count);
 	void RunVertices(int vtx_attr_group, int primitive, int count);
+	// Converts count vertices from g_pVideoData to VertexManager::s_pCurBufferPointer,
+	// SetupRunVertices must have been called before.
+	void ConvertVertices(int count);
 
 	// For debugging / profiling
 	void AppendToString(std::string *dest) const;
@@ -130,7 +136,6 @@ private:
 	void SetVAT(u32 _group0, u32 _group1, u32 _group2);
 
 	void CompileVertexTranslator();
-	void ConvertVertices(int count);
 
 	void WriteCall(TPipelineFunction);
 
@@ -138,4 +143,26 @@ private:
 	void WriteGetVariable(int bits, Gen::OpArg dest, void *address);
 	void WriteSetVariable(int bits, void *address, Gen::OpArg dest);
 #endif
+
+	// Inline conversions of the common components, x64 only. The read and write
+	// pointers live in registers while inline code runs and are written back
+	// before calling out to a component function.
+	bool m_inline;
+	bool m_pointers_loaded;
+	int m_src_offset;
+	int m_dst_offset;
+
+#ifdef _M_X64
+	void LoadPointers();
+	void StorePointers();
+	void WriteIndexedAddress(int index_size, int array);
+	void WriteToFloats(Gen::X64Reg src, int src_offset, int format, int count, const float *scale);
+#endif
+	// These return false if the component needs a call to its function instead
+	bool WriteInlinePosition();
+	bool WriteInlineNormal();
+	bool WriteInlineColor(int i, int color_index);
+	bool WriteInlineTexCoord(int i, int type);
+	bool WriteInlinePosMtxRead();
+	bool WriteInlinePosMtxWrite();
 };
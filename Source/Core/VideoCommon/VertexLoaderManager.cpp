@@ -139,6 +139,11 @@ int GetVertexSize(int vtx_attr_group)
 	return RefreshLoader(vtx_attr_group)->GetVertexSize();
 }
 
+VertexLoader* GetVertexLoader(int vtx_attr_group)
+{
+	return RefreshLoader(vtx_attr_group);
+}
+
 }  // namespace
 
 void LoadCPReg(u32 sub_cmd, u32 value)
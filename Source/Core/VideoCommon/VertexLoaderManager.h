@@ -8,6 +8,8 @@
 
 #include "Common/Common.h"
 
+class VertexLoader;
+
 namespace VertexLoaderManager
 {
 	void Init();
@@ -17,6 +19,8 @@ namespace VertexLoaderManager
 
 	int GetVertexSize(int vtx_attr_group);
 	void RunVertices(int vtx_attr_group, int primitive, int count);
+	// The loader RunVertices uses for the current vertex format
+	VertexLoader* GetVertexLoader(int vtx_attr_group);
 
 	// For debugging
 	void AppendListToString(std::string *dest);
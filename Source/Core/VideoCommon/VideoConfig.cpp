@@ -81,6 +81,9 @@ void VideoConfig::Load(const char *ini_file)
 	iniFile.Get("Settings", "DisableFog", &bDisableFog, 0);
 
 	iniFile.Get("Settings", "OMPDecoder", &bOMPDecoder, false);
+	iniFile.Get("Settings", "AsyncShaderCompilation", &bAsyncShaderCompilation, false);
+	iniFile.Get("Settings", "TextureWriteTracking", &bTextureWriteTracking, false);
+	iniFile.Get("Settings", "DisplayListCache", &bDisplayListCache, false);
 
 	iniFile.Get("Settings", "EnableShaderDebugging", &bEnableShaderDebugging, false);
 
@@ -181,6 +184,9 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Settings", "DstAlphaPass", bDstAlphaPass);
 	CHECK_SETTING("Video_Settings", "DisableFog", bDisableFog);
 	CHECK_SETTING("Video_Settings", "OMPDecoder", bOMPDecoder);
+	CHECK_SETTING("Video_Settings", "AsyncShaderCompilation", bAsyncShaderCompilation);
+	CHECK_SETTING("Video_Settings", "TextureWriteTracking", bTextureWriteTracking);
+	CHECK_SETTING("Video_Settings", "DisplayListCache", bDisplayListCache);
 
 	CHECK_SETTING("Video_Enhancements", "ForceFiltering", bForceFiltering);
 	CHECK_SETTING("Video_Enhancements", "MaxAnisotropy", iMaxAnisotropy);  // NOTE - this is x in (1 << x)
@@ -257,6 +263,9 @@ void VideoConfig::Save(const char *ini_file)
 	iniFile.Set("Settings", "DisableFog", bDisableFog);
 
 	iniFile.Set("Settings", "OMPDecoder", bOMPDecoder);
+	iniFile.Set("Settings", "AsyncShaderCompilation", bAsyncShaderCompilation);
+	iniFile.Set("Settings", "TextureWriteTracking", bTextureWriteTracking);
+	iniFile.Set("Settings", "DisplayListCache", bDisplayListCache);
 
 	iniFile.Set("Settings", "EnableShaderDebugging", bEnableShaderDebugging);
 
@@ -120,6 +120,9 @@ struct VideoConfig
 	bool bUseBBox;
 	bool bEnablePixelLighting;
 	bool bFastDepthCalc;
+	bool bAsyncShaderCompilation; // OGL only: skip draws until their program is ready
+	bool bTextureWriteTracking; // only rehash textures whose RAM pages were written
+	bool bDisplayListCache; // replay display lists which were called before without parsing them again
 	int iLog; // CONF_ bits
 	int iSaveTargetId; // TODO: Should be dropped
 
@@ -0,0 +1,88 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// Checks that the SIMD versions of the AX mixing primitives give the same
+// results as the plain C++ ones.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Common/Common.h"
+#include "Common/CPUDetect.h"
+#include "Core/HW/DSPHLE/UCodes/UCode_AX_Mix.h"
+
+extern int fail_count;
+
+// Random 32-bit sample, biased towards the edge cases.
+static int RandomSample()
+{
+	int v = rand() ^ (rand() << 16);
+	switch (rand() % 4)
+	{
+	case 0: return v;
+	case 1: return v >> 12;
+	case 2: return (rand() & 1) ? 0x7FFFFFFF : (int)0x80000000;
+	default: return (s16)v;
+	}
+}
+
+void AudioMixTests()
+{
+	enum { MAX_COUNT = 5 * 32 + 7 };
+	const bool has_sse2 = cpu_info.bSSE2;
+
+	for (int test = 0; test < 50000; ++test)
+	{
+		u32 count = rand() % (MAX_COUNT + 1);
+		int op = test % 5;
+		bool ramp = (rand() & 1) != 0;
+
+		s16 input[MAX_COUNT];
+		int src[MAX_COUNT];
+		u16 volume[MAX_COUNT];
+		for (u32 i = 0; i < MAX_COUNT; ++i)
+		{
+			input[i] = (rand() % 8) ? (s16)rand() : ((rand() & 1) ? 32767 : -32768);
+			src[i] = RandomSample();
+			volume[i] = (rand() % 8) ? (u16)rand() : 0xFFFF;
+		}
+
+		int dst[2][MAX_COUNT];
+		s16 out[2][2 * MAX_COUNT];
+		u16 pvol[2][2];
+		s16 dpop[2] = { 0, 0 };
+		for (u32 i = 0; i < MAX_COUNT; ++i)
+			dst[0][i] = dst[1][i] = RandomSample();
+		memset(out, 0, sizeof (out));
+		pvol[0][0] = pvol[1][0] = (u16)rand();
+		pvol[0][1] = pvol[1][1] = (u16)rand();
+
+		// Run the plain version first, then the one picked for this CPU.
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			cpu_info.bSSE2 = pass ? has_sse2 : false;
+			AXMix::Init();
+
+			switch (op)
+			{
+			case 0: AXMix::MixAdd(dst[pass], input, count, pvol[pass], &dpop[pass], ramp); break;
+			case 1: AXMix::CopySwapped(dst[pass], src, count); break;
+			case 2: AXMix::AddSwapped(dst[pass], src, count); break;
+			case 3: AXMix::AddSwappedWithVolume(dst[pass], src, volume, count); break;
+			case 4: AXMix::OutputLR(out[pass], src, dst[pass], count); break;
+			}
+		}
+
+		if (memcmp(dst[0], dst[1], sizeof (dst[0])) || memcmp(out[0], out[1], sizeof (out[0])) ||
+		    pvol[0][0] != pvol[1][0] || dpop[0] != dpop[1])
+		{
+			printf("FAIL (%s): primitive %d differs from the C++ version, count %u\n", __FUNCTION__, op, count);
+			fail_count++;
+		}
+	}
+
+	cpu_info.bSSE2 = has_sse2;
+	AXMix::Init();
+}
@@ -0,0 +1,167 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// Checks the ordering guarantees of the CoreTiming event queue and measures
+// how many events per second it can schedule and run.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/Common.h"
+#include "Core/CoreTiming.h"
+#include "UnitTests.h"
+
+static std::vector<u64> s_fired;
+static int s_bench_type;
+static int s_oneshot_type;
+static int s_bench_count;
+
+static void RecordCallback(u64 userdata, int cyclesLate)
+{
+	s_fired.push_back(userdata);
+}
+
+static void PeriodicCallback(u64 userdata, int cyclesLate)
+{
+	s_bench_count++;
+	CoreTiming::ScheduleEvent((int)userdata - cyclesLate, s_bench_type, userdata);
+
+	// Like a device which restarts its timeout on every access
+	CoreTiming::RemoveEvent(s_oneshot_type);
+	CoreTiming::ScheduleEvent((int)userdata * 4, s_oneshot_type);
+}
+
+static void OneshotCallback(u64 userdata, int cyclesLate)
+{
+	s_bench_count++;
+}
+
+// Pretends the CPU ran through whole slices until at least cycles have passed.
+static void RunFor(s64 cycles)
+{
+	const u64 end = CoreTiming::GetTicks() + cycles;
+	while (CoreTiming::GetTicks() < end)
+	{
+		CoreTiming::downcount = 0;
+		CoreTiming::Advance();
+	}
+}
+
+static void OrderingTests(int record_type, int other_type)
+{
+	// Events fire by time, and in scheduling order for the same time.
+	std::vector<std::pair<int, u64>> expected;
+	s_fired.clear();
+	for (u64 i = 0; i < 1000; ++i)
+	{
+		int cycles = (rand() % 50) * 100;
+		CoreTiming::ScheduleEvent(cycles, record_type, i);
+		expected.push_back(std::make_pair(cycles, i));
+	}
+	std::stable_sort(expected.begin(), expected.end(),
+		[](const std::pair<int, u64>& a, const std::pair<int, u64>& b) { return a.first < b.first; });
+	RunFor(5000);
+
+	bool ordered = s_fired.size() == expected.size();
+	for (size_t i = 0; ordered && i < expected.size(); ++i)
+		ordered = s_fired[i] == expected[i].second;
+	EXPECT_TRUE(ordered);
+
+	// Removal only drops events of the given type.
+	s_fired.clear();
+	CoreTiming::ScheduleEvent(100, other_type, 1);
+	CoreTiming::ScheduleEvent(200, record_type, 2);
+	CoreTiming::ScheduleEvent(300, other_type, 3);
+	EXPECT_TRUE(CoreTiming::IsScheduled(other_type));
+	CoreTiming::RemoveEvent(other_type);
+	EXPECT_FALSE(CoreTiming::IsScheduled(other_type));
+	EXPECT_TRUE(CoreTiming::IsScheduled(record_type));
+	CoreTiming::ScheduleEvent(400, other_type, 4);
+	RunFor(500);
+	EXPECT_TRUE(s_fired.size() == 2 && s_fired[0] == 2 && s_fired[1] == 4);
+	EXPECT_TRUE(!CoreTiming::IsScheduled(other_type) && !CoreTiming::IsScheduled(record_type));
+
+	// Events from other threads keep their order as well.
+	s_fired.clear();
+	std::thread thread([record_type]{
+		for (u64 i = 0; i < 1000; ++i)
+			CoreTiming::ScheduleEvent_Threadsafe(0, record_type, i);
+	});
+	thread.join();
+	RunFor(100);
+	ordered = s_fired.size() == 1000;
+	for (u64 i = 0; ordered && i < 1000; ++i)
+		ordered = s_fired[i] == i;
+	EXPECT_TRUE(ordered);
+
+	// A savestate round trip keeps the pending events and their order.
+	s_fired.clear();
+	for (u64 i = 0; i < 100; ++i)
+		CoreTiming::ScheduleEvent((int)(i % 7) * 10, record_type, i);
+	CoreTiming::ScheduleEvent(5, other_type, 1000);
+	CoreTiming::RemoveEvent(other_type);
+
+	u8* ptr = NULL;
+	PointerWrap p_measure(&ptr, PointerWrap::MODE_MEASURE);
+	CoreTiming::DoState(p_measure);
+	std::vector<u8> state((size_t)ptr);
+	ptr = state.data();
+	PointerWrap p_write(&ptr, PointerWrap::MODE_WRITE);
+	CoreTiming::DoState(p_write);
+
+	RunFor(100);
+	std::vector<u64> before;
+	before.swap(s_fired);
+
+	ptr = state.data();
+	PointerWrap p_read(&ptr, PointerWrap::MODE_READ);
+	CoreTiming::DoState(p_read);
+	RunFor(100);
+	EXPECT_TRUE(before.size() == 100 && s_fired == before);
+}
+
+static void Benchmark()
+{
+	enum { NUM_PENDING = 64, NUM_EVENTS = 2000000 };
+
+	// A handful of periodic events like the VI, DSP, audio and SI timers, with
+	// a bunch of one shot events being scheduled and removed in between.
+	for (int i = 0; i < NUM_PENDING; ++i)
+		CoreTiming::ScheduleEvent(i, s_bench_type, 100 + rand() % 10000);
+
+	s_bench_count = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	while (s_bench_count < NUM_EVENTS)
+	{
+		CoreTiming::downcount = 0;
+		CoreTiming::Advance();
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	CoreTiming::RemoveEvent(s_bench_type);
+	CoreTiming::RemoveEvent(s_oneshot_type);
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	printf("CoreTiming: %d events with %d pending in %.3f s (%.2f M events/s)\n",
+		s_bench_count, (int)NUM_PENDING, seconds, s_bench_count / seconds / 1e6);
+}
+
+void CoreTimingTests()
+{
+	CoreTiming::Init();
+	int record_type = CoreTiming::RegisterEvent("TestRecord", RecordCallback);
+	int other_type = CoreTiming::RegisterEvent("TestOther", RecordCallback);
+	s_bench_type = CoreTiming::RegisterEvent("TestPeriodic", PeriodicCallback);
+	s_oneshot_type = CoreTiming::RegisterEvent("TestOneshot", OneshotCallback);
+
+	OrderingTests(record_type, other_type);
+	Benchmark();
+
+	CoreTiming::Shutdown();
+}
@@ -0,0 +1,186 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// Checks that IndexedDiskCache keeps its entries across reopening, compaction
+// and crashes, and that damaged files don't give out values outside of them.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/FileUtil.h"
+#include "Common/IndexedDiskCache.h"
+#include "UnitTests.h"
+
+static const char* const CACHE_FILENAME = "IndexedDiskCacheTest.cache";
+static const char* const CRASHED_FILENAME = "IndexedDiskCacheTest.crashed.cache";
+
+typedef IndexedDiskCache<u32, u8> TestCache;
+
+static std::vector<u8> MakeValue(u32 key, u32 size)
+{
+	std::vector<u8> value(size);
+	for (u32 i = 0; i < size; ++i)
+		value[i] = (u8)(key * 31 + i);
+	return value;
+}
+
+// Whether key maps to the value MakeValue(value_key, size).
+static bool HasValue(const TestCache& cache, u32 key, u32 value_key, u32 size)
+{
+	const u8* value;
+	u32 value_size;
+	if (!cache.Lookup(key, value, value_size))
+		return false;
+	return value_size == size && !memcmp(value, MakeValue(value_key, size).data(), size);
+}
+
+static void InsertAndReopenTests()
+{
+	TestCache cache;
+	EXPECT_EQ(cache.Open(CACHE_FILENAME), 0);
+	for (u32 key = 0; key < 100; ++key)
+		cache.Append(key, MakeValue(key, key).data(), key);
+	EXPECT_EQ(cache.GetNumEntries(), 100);
+	EXPECT_TRUE(HasValue(cache, 42, 42, 42));
+
+	cache.Sync();
+	cache.Erase(7);
+	cache.Append(8, MakeValue(1008, 16).data(), 16);
+	cache.Close();
+
+	EXPECT_EQ(cache.Open(CACHE_FILENAME), 99);
+	bool all_found = true;
+	for (u32 key = 0; key < 100; ++key)
+	{
+		if (key != 7 && key != 8)
+			all_found &= HasValue(cache, key, key, key);
+	}
+	EXPECT_TRUE(all_found);
+	EXPECT_FALSE(HasValue(cache, 7, 7, 7));
+	EXPECT_TRUE(HasValue(cache, 8, 1008, 16));
+	cache.Close();
+}
+
+static void CompactionTests()
+{
+	enum { NUM_ENTRIES = 40, VALUE_SIZE = 64 * 1024 };
+
+	File::Delete(CACHE_FILENAME);
+	TestCache cache;
+	cache.Open(CACHE_FILENAME);
+	for (u32 key = 0; key < NUM_ENTRIES; ++key)
+		cache.Append(key, MakeValue(key, VALUE_SIZE).data(), VALUE_SIZE);
+	cache.Sync();
+	const u64 full_size = File::GetSize(CACHE_FILENAME);
+
+	// Replacing every value leaves more dead records than live ones.
+	for (u32 key = 0; key < NUM_ENTRIES; ++key)
+		cache.Append(key, MakeValue(key + 1, VALUE_SIZE).data(), VALUE_SIZE);
+	cache.Sync();
+	EXPECT_TRUE(File::GetSize(CACHE_FILENAME) < full_size * 3 / 2);
+	EXPECT_FALSE(File::Exists(std::string(CACHE_FILENAME) + ".tmp"));
+	cache.Close();
+
+	EXPECT_EQ(cache.Open(CACHE_FILENAME), NUM_ENTRIES);
+	bool all_found = true;
+	for (u32 key = 0; key < NUM_ENTRIES; ++key)
+		all_found &= HasValue(cache, key, key + 1, VALUE_SIZE);
+	EXPECT_TRUE(all_found);
+	cache.Close();
+}
+
+static void TruncatedFileTests()
+{
+	enum { NUM_ENTRIES = 50, VALUE_SIZE = 100 };
+
+	File::Delete(CACHE_FILENAME);
+	TestCache cache;
+	cache.Open(CACHE_FILENAME);
+	for (u32 key = 0; key < NUM_ENTRIES; ++key)
+		cache.Append(key, MakeValue(key, VALUE_SIZE).data(), VALUE_SIZE);
+	cache.Close();
+
+	std::string data;
+	File::ReadFileToString(CACHE_FILENAME, data);
+
+	// Cutting off the end loses the footer, which makes the cache start over.
+	File::WriteStringToFile(data.substr(0, data.size() / 2), CACHE_FILENAME);
+	EXPECT_EQ(cache.Open(CACHE_FILENAME), 0);
+	EXPECT_FALSE(HasValue(cache, 0, 0, VALUE_SIZE));
+	cache.Close();
+
+	// Cutting records out from under a still valid index and footer must only
+	// drop the entries which pointed into them.
+	const size_t footer_size = sizeof(u64) + 2 * sizeof(u32);
+	const size_t index_size = NUM_ENTRIES * (sizeof(u32) + sizeof(u64) + sizeof(u32));
+	const size_t index_offset = data.size() - footer_size - index_size;
+	const size_t removed = 10 * (sizeof(u32) + sizeof(u32) + VALUE_SIZE) + 1;
+	std::string damaged = data.substr(0, index_offset - removed) + data.substr(index_offset);
+	u64 damaged_index_offset = index_offset - removed;
+	memcpy(&damaged[damaged.size() - footer_size], &damaged_index_offset, sizeof(damaged_index_offset));
+	File::WriteStringToFile(damaged, CACHE_FILENAME);
+
+	u32 num_entries = cache.Open(CACHE_FILENAME);
+	EXPECT_EQ(num_entries, NUM_ENTRIES - 11);
+	u32 found = 0;
+	for (u32 key = 0; key < NUM_ENTRIES; ++key)
+		found += HasValue(cache, key, key, VALUE_SIZE);
+	EXPECT_EQ(found, num_entries);
+	cache.Close();
+}
+
+static void JournalTests()
+{
+	enum { VALUE_SIZE = 16 };
+	const std::string journal = std::string(CACHE_FILENAME) + ".journal";
+	const std::string crashed_journal = std::string(CRASHED_FILENAME) + ".journal";
+
+	File::Delete(CACHE_FILENAME);
+	TestCache cache;
+	cache.Open(CACHE_FILENAME);
+	cache.Append(1, MakeValue(1, VALUE_SIZE).data(), VALUE_SIZE);
+	cache.Sync();
+	EXPECT_FALSE(File::Exists(journal));
+	cache.Append(2, MakeValue(2, VALUE_SIZE).data(), VALUE_SIZE);
+	cache.Append(1, MakeValue(1001, VALUE_SIZE).data(), VALUE_SIZE);
+
+	// The files as a crash would leave them.
+	File::Copy(CACHE_FILENAME, CRASHED_FILENAME);
+	File::Copy(journal, crashed_journal);
+	cache.Close();
+	EXPECT_FALSE(File::Exists(journal));
+
+	EXPECT_EQ(cache.Open(CRASHED_FILENAME), 2);
+	EXPECT_TRUE(HasValue(cache, 1, 1001, VALUE_SIZE) && HasValue(cache, 2, 2, VALUE_SIZE));
+	EXPECT_FALSE(File::Exists(crashed_journal));
+
+	// A record which the crash cut short is left out.
+	File::Copy(CRASHED_FILENAME, CACHE_FILENAME);
+	cache.Append(3, MakeValue(3, VALUE_SIZE).data(), VALUE_SIZE);
+	cache.Append(4, MakeValue(4, VALUE_SIZE).data(), VALUE_SIZE);
+	std::string data;
+	File::ReadFileToString(crashed_journal.c_str(), data);
+	cache.Close();
+	File::WriteStringToFile(data.substr(0, data.size() - 1), journal.c_str());
+
+	EXPECT_EQ(cache.Open(CACHE_FILENAME), 3);
+	EXPECT_TRUE(HasValue(cache, 3, 3, VALUE_SIZE) && !HasValue(cache, 4, 4, VALUE_SIZE));
+	cache.Close();
+}
+
+void IndexedDiskCacheTests()
+{
+	File::Delete(CACHE_FILENAME);
+
+	InsertAndReopenTests();
+	CompactionTests();
+	TruncatedFileTests();
+	JournalTests();
+
+	File::Delete(CACHE_FILENAME);
+	File::Delete(CRASHED_FILENAME);
+}
@@ -0,0 +1,192 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// Checks that the JIT block cache links exits to the blocks they jump to,
+// unlinks them when a block is invalidated and relinks them when it is
+// recompiled, also for superblocks made of several ranges. On request, measures how fast it invalidates and recompiles blocks.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "UnitTests.h"
+
+// Enough for every block the cache can hold.
+static const int NUM_CODE_SLOTS = 65536 * 2;
+static const int NUM_EXIT_SLOTS = NUM_CODE_SLOTS * 4;
+
+// Stands in for the emitted code: the entry of block n is s_code[n], and
+// exit jumps are bytes of s_exits. Writes to them are only recorded.
+static std::vector<u8> s_code(NUM_CODE_SLOTS);
+static std::vector<u8> s_exits(NUM_EXIT_SLOTS);
+static std::vector<const u8*> s_link_targets(NUM_EXIT_SLOTS);
+static std::vector<int> s_destroyed;
+
+class TestBlockCache : public JitBaseBlockCache
+{
+private:
+	void WriteLinkBlock(u8* location, const u8* address) override
+	{
+		s_link_targets[location - s_exits.data()] = address;
+	}
+	void WriteDestroyBlock(const u8* location, u32 address) override
+	{
+		s_destroyed.push_back((int)(location - s_code.data()));
+	}
+};
+
+// Compiles a block of num_instructions at address whose exits jump to
+// exit_addresses, using the exit slots starting at first_exit. Blocks which
+// followed branches pass the ranges they cover.
+static int AddBlock(TestBlockCache& cache, u32 address, u32 num_instructions,
+                    const std::vector<u32>& exit_addresses, int first_exit,
+                    const std::vector<std::pair<u32, u32>>& ranges = std::vector<std::pair<u32, u32>>())
+{
+	int block_num = cache.AllocateBlock(address);
+	JitBlock* b = cache.GetBlock(block_num);
+	b->checkedEntry = &s_code[block_num];
+	b->normalEntry = &s_code[block_num];
+	b->codeSize = 1;
+	b->originalSize = num_instructions;
+	b->physicalRanges = ranges;
+	for (size_t i = 0; i < exit_addresses.size(); ++i)
+	{
+		JitBlock::LinkData link;
+		link.exitPtrs = &s_exits[first_exit + i];
+		link.exitAddress = exit_addresses[i];
+		link.linkStatus = false;
+		s_link_targets[first_exit + i] = nullptr;
+		cache.AddLinkData(b, link);
+	}
+	cache.FinalizeBlock(block_num, true, b->checkedEntry);
+	return block_num;
+}
+
+static bool IsLinkedTo(int exit, int block_num)
+{
+	return s_link_targets[exit] == &s_code[block_num];
+}
+
+static void LinkTests(TestBlockCache& cache)
+{
+	const u32 a_addr = 0x80001000, b_addr = 0x80002000, c_addr = 0x80003000;
+	enum { A_EXIT, C_EXIT, C_EXIT_2, OTHER_EXIT };
+
+	// Exits to code which isn't compiled yet get linked once it is.
+	int a = AddBlock(cache, a_addr, 8, std::vector<u32>(1, b_addr), A_EXIT);
+	EXPECT_TRUE(s_link_targets[A_EXIT] == nullptr);
+	int b = AddBlock(cache, b_addr, 8, std::vector<u32>(), OTHER_EXIT);
+	EXPECT_TRUE(IsLinkedTo(A_EXIT, b));
+	EXPECT_EQ(cache.GetBlockNumberFromStartAddress(b_addr), b);
+
+	// Exits to compiled code are linked right away.
+	std::vector<u32> c_exits;
+	c_exits.push_back(b_addr);
+	c_exits.push_back(a_addr);
+	int c = AddBlock(cache, c_addr, 8, c_exits, C_EXIT);
+	EXPECT_TRUE(IsLinkedTo(C_EXIT, b) && IsLinkedTo(C_EXIT_2, a));
+
+	// Invalidating a block sends its callers back to the dispatcher, and
+	// recompiling it links them again.
+	s_destroyed.clear();
+	cache.InvalidateICache(b_addr + 4, 32);
+	EXPECT_TRUE(s_destroyed.size() == 1 && s_destroyed[0] == b);
+	EXPECT_EQ(cache.GetBlockNumberFromStartAddress(b_addr), -1);
+	s_link_targets[A_EXIT] = s_link_targets[C_EXIT] = nullptr;
+	int b2 = AddBlock(cache, b_addr, 8, std::vector<u32>(), OTHER_EXIT);
+	EXPECT_TRUE(IsLinkedTo(A_EXIT, b2) && IsLinkedTo(C_EXIT, b2));
+
+	// Only the blocks covering the invalidated code are destroyed.
+	s_destroyed.clear();
+	cache.InvalidateICache(0x80005000, 0x1000);
+	cache.InvalidateICache(a_addr + 8 * 4, 32);
+	EXPECT_TRUE(s_destroyed.empty());
+
+	// The exits of destroyed blocks are no longer relinked.
+	s_destroyed.clear();
+	cache.InvalidateICache(c_addr, 8 * 4);
+	EXPECT_TRUE(s_destroyed.size() == 1 && s_destroyed[0] == c);
+	s_link_targets[C_EXIT] = nullptr;
+	cache.InvalidateICache(b_addr, 32);
+	int b3 = AddBlock(cache, b_addr, 8, std::vector<u32>(), OTHER_EXIT);
+	EXPECT_TRUE(IsLinkedTo(A_EXIT, b3) && s_link_targets[C_EXIT] == nullptr);
+}
+
+// Superblocks are destroyed by writes to any of the code they were made from.
+static void MergedRangeTests(TestBlockCache& cache)
+{
+	const u32 a_addr = 0x80001000, d_addr = 0x80004000;
+	enum { D_EXIT, OTHER_EXIT };
+
+	int a = AddBlock(cache, a_addr, 8, std::vector<u32>(), OTHER_EXIT);
+	std::vector<std::pair<u32, u32>> ranges;
+	ranges.push_back(std::make_pair(d_addr & 0x1FFFFFFF, (d_addr & 0x1FFFFFFF) + 4 * 4 - 1));
+	ranges.push_back(std::make_pair(0x00100000, 0x00100000 + 4 * 4 - 1));
+	int d = AddBlock(cache, d_addr, 8, std::vector<u32>(1, a_addr), D_EXIT, ranges);
+	EXPECT_TRUE(IsLinkedTo(D_EXIT, a));
+
+	// The instructions after the first range aren't part of the block.
+	s_destroyed.clear();
+	cache.InvalidateICache(d_addr + 4 * 4, 16);
+	EXPECT_TRUE(s_destroyed.empty());
+	cache.InvalidateICache(0x80100008, 32);
+	EXPECT_TRUE(s_destroyed.size() == 1 && s_destroyed[0] == d);
+}
+
+static void Benchmark(TestBlockCache& cache)
+{
+	enum { NUM_BLOCKS = 16384, NUM_HUBS = 64, NUM_CYCLES = 100000, BLOCK_SIZE = 0x40 };
+	const u32 base = 0x80100000;
+
+	// A chain of blocks which each jump to the next one and to one of a few
+	// hub blocks, like the callers of a handful of common functions.
+	for (int i = 0; i < NUM_BLOCKS; ++i)
+	{
+		std::vector<u32> exits;
+		exits.push_back(base + (i + 1) % NUM_BLOCKS * BLOCK_SIZE);
+		exits.push_back(base + (i % NUM_HUBS) * BLOCK_SIZE);
+		AddBlock(cache, base + i * BLOCK_SIZE, BLOCK_SIZE / 4, exits, i * 2);
+	}
+
+	// Code being overwritten and recompiled, which unlinks and relinks the
+	// exits jumping to it.
+	int next_exit = NUM_BLOCKS * 2;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int cycle = 0; cycle < NUM_CYCLES; ++cycle)
+	{
+		int i = rand() % NUM_BLOCKS;
+		const u32 address = base + i * BLOCK_SIZE;
+		cache.InvalidateICache(address, 32);
+
+		std::vector<u32> exits;
+		exits.push_back(base + (i + 1) % NUM_BLOCKS * BLOCK_SIZE);
+		exits.push_back(base + (i % NUM_HUBS) * BLOCK_SIZE);
+		AddBlock(cache, address, BLOCK_SIZE / 4, exits, next_exit);
+		next_exit += 2;
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	printf("JitCache: %d invalidations and recompiles with %d blocks in %.3f s (%.2f M/s)\n",
+		(int)NUM_CYCLES, (int)NUM_BLOCKS, seconds, NUM_CYCLES / seconds / 1e6);
+}
+
+void JitCacheTests(bool benchmark)
+{
+	TestBlockCache cache;
+	cache.Init();
+	LinkTests(cache);
+	cache.Clear();
+	MergedRangeTests(cache);
+	if (benchmark)
+	{
+		cache.Clear();
+		Benchmark(cache);
+	}
+	cache.Shutdown();
+}
@@ -0,0 +1,110 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// Checks that rewind buffer entries, keyframes as well as deltas, restore the
+// states they were made from, and that bounded PointerWraps report the size
+// they would have needed.
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/Common.h"
+#include "Core/State.h"
+#include "UnitTests.h"
+
+static std::vector<u8> MakeState(size_t size)
+{
+	std::vector<u8> state(size);
+	for (size_t i = 0; i < size; ++i)
+		state[i] = (u8)(rand() % 7); // compressible, but not entirely
+	return state;
+}
+
+static bool Restores(const std::deque<State::RewindEntry>& entries, size_t index, const std::vector<u8>& state)
+{
+	std::vector<u8> buffer;
+	return State::RestoreRewindEntry(entries, index, buffer) && buffer == state;
+}
+
+static void RoundTripTests()
+{
+	// Not a multiple of the page size, so that the last page is partial
+	const size_t size = 100 * 4096 + 123;
+	std::vector<std::vector<u8>> states;
+	std::deque<State::RewindEntry> entries;
+
+	states.push_back(MakeState(size));
+	entries.push_back(State::RewindEntry());
+	State::MakeRewindEntry(states[0], nullptr, entries.back());
+	EXPECT_TRUE(entries.back().keyframe);
+	EXPECT_TRUE(Restores(entries, 0, states[0]));
+
+	// A few bytes in three pages, one of them the partial last one
+	states.push_back(states[0]);
+	states[1][10] ^= 1;
+	states[1][50 * 4096 + 7] ^= 1;
+	states[1][size - 1] ^= 1;
+	entries.push_back(State::RewindEntry());
+	State::MakeRewindEntry(states[1], &states[0], entries.back());
+	EXPECT_TRUE(!entries.back().keyframe && entries.back().pages.size() == 3);
+	EXPECT_TRUE(Restores(entries, 1, states[1]));
+
+	// Deltas are against the keyframe, not the previous entry
+	states.push_back(states[1]);
+	states[2][20 * 4096] ^= 1;
+	entries.push_back(State::RewindEntry());
+	State::MakeRewindEntry(states[2], &states[0], entries.back());
+	EXPECT_TRUE(!entries.back().keyframe && entries.back().pages.size() == 4);
+	EXPECT_TRUE(Restores(entries, 2, states[2]));
+
+	// Changing most of the state makes a keyframe
+	states.push_back(MakeState(size));
+	entries.push_back(State::RewindEntry());
+	State::MakeRewindEntry(states[3], &states[0], entries.back());
+	EXPECT_TRUE(entries.back().keyframe);
+
+	// A differently sized state can't be a delta
+	states.push_back(MakeState(size + 4096));
+	entries.push_back(State::RewindEntry());
+	State::MakeRewindEntry(states[4], &states[3], entries.back());
+	EXPECT_TRUE(entries.back().keyframe);
+
+	states.push_back(states[4]);
+	states[5][0] ^= 1;
+	entries.push_back(State::RewindEntry());
+	State::MakeRewindEntry(states[5], &states[4], entries.back());
+
+	bool all_restored = true;
+	for (size_t i = 0; i < entries.size(); ++i)
+		all_restored &= Restores(entries, i, states[i]);
+	EXPECT_TRUE(all_restored);
+
+	// Without its keyframe a delta can't be restored
+	entries.erase(entries.begin(), entries.begin() + 5);
+	std::vector<u8> buffer;
+	EXPECT_TRUE(!entries.front().keyframe && !State::RestoreRewindEntry(entries, 0, buffer));
+}
+
+static void BoundedWriteTests()
+{
+	u8 buffer[8];
+	u8* ptr = buffer;
+	PointerWrap p(&ptr, PointerWrap::MODE_WRITE, buffer + sizeof(buffer));
+	u32 a = 1, b = 2, c = 3;
+	p.Do(a);
+	p.Do(b);
+	EXPECT_TRUE(p.GetMode() == PointerWrap::MODE_WRITE);
+	p.Do(c);
+	EXPECT_TRUE(p.GetMode() == PointerWrap::MODE_MEASURE);
+	EXPECT_TRUE(ptr == buffer + 3 * sizeof(u32));
+}
+
+void RewindTests()
+{
+	RoundTripTests();
+	BoundedWriteTests();
+}
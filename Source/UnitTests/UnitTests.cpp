@@ -15,40 +15,29 @@
 // Official SVN repository and contact information can be found at
 // http://code.google.com/p/dolphin-emu/
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "StringUtil.h"
 #include "MathUtil.h"
 #include "PowerPC/PowerPC.h"
 #include "HW/SI_DeviceGCController.h"
+#include "UnitTests.h"
 
 void AudioJitTests();
+void AudioMixTests();
+void CoreTimingTests();
+void IndexedDiskCacheTests();
+void JitCacheTests(bool benchmark);
+void RewindTests();
+void VertexLoaderTests(const std::vector<std::string> &dff_files);
 
 using namespace std;
 int fail_count = 0;
 
-#define EXPECT_TRUE(a) \
-	if (!a) { \
-		cout << "FAIL (" << __FUNCTION__ << "): " << #a << " is false" << endl; \
-		cout << "Value: " << a << endl << "Expected: true" << endl; \
-		fail_count++; \
-	}
-
-#define EXPECT_FALSE(a) \
-	if (a) { \
-		cout << "FAIL (" << __FUNCTION__ << "): " << #a << " is true" << endl; \
-		cout << "Value: " << a << endl << "Expected: false" << endl; \
-		fail_count++; \
-	}
-
-#define EXPECT_EQ(a, b) \
-	if ((a) != (b)) { \
-		cout << "FAIL (" << __FUNCTION__ << "): " << #a << " is not equal to " << #b << endl; \
-		cout << "Actual: " << a << endl << "Expected: " << b << endl; \
-		fail_count++; \
-	}
-
 void CoreTests()
 {
 }
@@ -132,11 +121,27 @@ void StringTests()
 
 int main(int argc, char* argv[])
 {
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+	// --jit-cache-benchmark times block invalidation and recompilation
+	auto jit_cache_benchmark = std::find(args.begin(), args.end(), "--jit-cache-benchmark");
+	bool benchmark_jit_cache = jit_cache_benchmark != args.end();
+	if (benchmark_jit_cache)
+		args.erase(jit_cache_benchmark);
+
 	AudioJitTests();
+	AudioMixTests();
+	CoreTimingTests();
+	IndexedDiskCacheTests();
+	JitCacheTests(benchmark_jit_cache);
+	RewindTests();
 
 	CoreTests();
 	MathTests();
 	StringTests();
+
+	// FifoPlayer recordings given on the command line benchmark the vertex loaders
+	VertexLoaderTests(args);
 	if (fail_count == 0)
 	{
 		printf("All tests passed.\n");
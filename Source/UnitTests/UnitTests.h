@@ -0,0 +1,31 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <iostream>
+
+// Failed expectations of all tests, see main in UnitTests.cpp.
+extern int fail_count;
+
+#define EXPECT_TRUE(a) \
+	if (!(a)) { \
+		std::cout << "FAIL (" << __FUNCTION__ << "): " << #a << " is false" << std::endl; \
+		std::cout << "Value: " << (a) << std::endl << "Expected: true" << std::endl; \
+		fail_count++; \
+	}
+
+#define EXPECT_FALSE(a) \
+	if (a) { \
+		std::cout << "FAIL (" << __FUNCTION__ << "): " << #a << " is true" << std::endl; \
+		std::cout << "Value: " << (a) << std::endl << "Expected: false" << std::endl; \
+		fail_count++; \
+	}
+
+#define EXPECT_EQ(a, b) \
+	if ((a) != (b)) { \
+		std::cout << "FAIL (" << __FUNCTION__ << "): " << #a << " is not equal to " << #b << std::endl; \
+		std::cout << "Actual: " << (a) << std::endl << "Expected: " << (b) << std::endl; \
+		fail_count++; \
+	}
@@ -0,0 +1,313 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+// Checks that vertex loaders with inline component conversions write the same
+// vertices as the ones calling the component functions, and compares the speed
+// of both on the vertex streams of the FifoPlayer recordings given to the tester.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Core/FifoPlayer/FifoAnalyzer.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VertexLoader.h"
+#include "VideoCommon/VertexManagerBase.h"
+#include "UnitTests.h"
+
+extern int fail_count;
+extern NativeVertexFormat *g_nativeVertexFmt;
+
+namespace
+{
+
+class TestNativeVertexFormat : public NativeVertexFormat
+{
+public:
+	void Initialize(const PortableVertexDeclaration &vtx_decl) override {}
+	void SetupVertexPointers() override {}
+};
+
+class TestVertexManager : public VertexManager
+{
+public:
+	NativeVertexFormat* CreateNativeVertexFormat() override { return new TestNativeVertexFormat; }
+
+protected:
+	void ResetBuffer(u32 stride) override {}
+
+private:
+	void vFlush(bool useDstAlpha) override {}
+};
+
+struct RecordedDraw
+{
+	VertexLoaderUID uid;
+	TVtxDesc vtx_desc;
+	VAT vtx_attr;
+	u32 strides[16];
+	const u8 *data;
+	int count;
+};
+
+typedef std::map<VertexLoaderUID, std::unique_ptr<VertexLoader>> LoaderMap;
+
+// Indexed components read from here, whatever the recorded array bases were.
+std::vector<u8> s_array_data;
+std::vector<u8> s_output;
+
+// Converts count vertices from src with VAT 0, returns the number of bytes written.
+u32 Convert(VertexLoader *loader, const VAT &vtx_attr, const u8 *src, int count)
+{
+	g_VtxAttr[0] = vtx_attr;
+	g_nativeVertexFmt = nullptr;
+	loader->SetupRunVertices(0, 0, count);
+
+	g_pVideoData = const_cast<u8*>(src);
+	VertexManager::s_pCurBufferPointer = s_output.data();
+	loader->ConvertVertices(count);
+
+	EXPECT_TRUE(g_pVideoData == src + count * loader->GetVertexSize());
+	u32 written = (u32)(VertexManager::s_pCurBufferPointer - s_output.data());
+	EXPECT_EQ(written, (u32)(count * loader->GetNativeVertexSize()));
+	return written;
+}
+
+void RandomFormatTests()
+{
+	std::vector<u8> input;
+	std::vector<u8> expected;
+
+	for (int iteration = 0; iteration < 2000; ++iteration)
+	{
+		// Tex7Coord is split across the two halves of the descriptor, so it stays off.
+		TVtxDesc vtx_desc;
+		vtx_desc.Hex = rand() & 0x1FF;
+		vtx_desc.Position = 1 + rand() % 3;
+		vtx_desc.Normal = rand() % 4;
+		vtx_desc.Color0 = rand() % 4;
+		vtx_desc.Color1 = rand() % 4;
+		vtx_desc.Tex0Coord = rand() % 4;
+		vtx_desc.Tex1Coord = rand() % 4;
+		vtx_desc.Tex2Coord = rand() % 4;
+		vtx_desc.Tex3Coord = rand() % 4;
+		vtx_desc.Tex4Coord = rand() % 4;
+		vtx_desc.Tex5Coord = rand() % 4;
+		vtx_desc.Tex6Coord = rand() % 4;
+
+		VAT vtx_attr;
+		vtx_attr.g0.Hex = (rand() << 16) ^ rand();
+		vtx_attr.g1.Hex = (rand() << 16) ^ rand();
+		vtx_attr.g2.Hex = (rand() << 16) ^ rand();
+		vtx_attr.g0.PosFormat %= 5;
+		vtx_attr.g0.NormalFormat %= 5;
+		vtx_attr.g0.Color0Comp %= 6;
+		vtx_attr.g0.Color1Comp %= 6;
+		vtx_attr.g0.Tex0CoordFormat %= 5;
+		vtx_attr.g1.Tex1CoordFormat %= 5;
+		vtx_attr.g1.Tex2CoordFormat %= 5;
+		vtx_attr.g1.Tex3CoordFormat %= 5;
+		vtx_attr.g1.Tex4CoordFormat %= 5;
+		vtx_attr.g2.Tex5CoordFormat %= 5;
+		vtx_attr.g2.Tex6CoordFormat %= 5;
+		vtx_attr.g2.Tex7CoordFormat %= 5;
+
+		for (u32& stride : arraystrides)
+			stride = rand() % 256;
+
+		VertexLoader call_loader(vtx_desc, vtx_attr, false);
+		VertexLoader inline_loader(vtx_desc, vtx_attr, true);
+
+		int count = 1 + rand() % 64;
+		input.resize(count * call_loader.GetVertexSize() + 4);
+		for (u8& byte : input)
+			byte = rand();
+
+		u32 size = Convert(&call_loader, vtx_attr, input.data(), count);
+		expected.assign(s_output.begin(), s_output.begin() + size);
+		memset(s_output.data(), 0, size);
+		Convert(&inline_loader, vtx_attr, input.data(), count);
+
+		if (memcmp(expected.data(), s_output.data(), size))
+		{
+			std::string format;
+			inline_loader.AppendToString(&format);
+			printf("FAIL (VertexLoaderTests): inline conversion differs for %s", format.c_str());
+			fail_count++;
+		}
+	}
+}
+
+// Collects the primitives of a FifoPlayer recording, see FifoPlaybackAnalyzer.
+bool LoadDraws(FifoDataFile *file, std::vector<RecordedDraw> *draws)
+{
+	FifoAnalyzer::CPMemory cp_mem;
+	memset(&cp_mem, 0, sizeof(cp_mem));
+	u32 *regs = file->GetCPMem();
+	FifoAnalyzer::LoadCPReg(0x50, regs[0x50], cp_mem);
+	FifoAnalyzer::LoadCPReg(0x60, regs[0x60], cp_mem);
+	for (int i = 0; i < 8; ++i)
+	{
+		FifoAnalyzer::LoadCPReg(0x70 + i, regs[0x70 + i], cp_mem);
+		FifoAnalyzer::LoadCPReg(0x80 + i, regs[0x80 + i], cp_mem);
+		FifoAnalyzer::LoadCPReg(0x90 + i, regs[0x90 + i], cp_mem);
+	}
+	for (int i = 0; i < 16; ++i)
+		FifoAnalyzer::LoadCPReg(0xB0 + i, regs[0xB0 + i], cp_mem);
+
+	for (size_t frame_index = 0; frame_index < file->GetFrameCount(); ++frame_index)
+	{
+		const FifoFrameInfo &frame = file->GetFrame(frame_index);
+		const u8 *data = frame.fifoData;
+		const u8 *end = frame.fifoData + frame.fifoDataSize;
+		while (data < end)
+		{
+			u8 cmd = FifoAnalyzer::ReadFifo8(data);
+			switch (cmd)
+			{
+			case GX_NOP:
+			case GX_CMD_UNKNOWN_METRICS:
+			case GX_CMD_INVL_VC:
+				break;
+
+			case GX_LOAD_CP_REG:
+				{
+					u8 sub_cmd = FifoAnalyzer::ReadFifo8(data);
+					u32 value = FifoAnalyzer::ReadFifo32(data);
+					FifoAnalyzer::LoadCPReg(sub_cmd, value, cp_mem);
+				}
+				break;
+
+			case GX_LOAD_XF_REG:
+				{
+					u32 cmd2 = FifoAnalyzer::ReadFifo32(data);
+					data += (((cmd2 >> 16) & 15) + 1) * 4;
+				}
+				break;
+
+			case GX_LOAD_INDX_A:
+			case GX_LOAD_INDX_B:
+			case GX_LOAD_INDX_C:
+			case GX_LOAD_INDX_D:
+			case GX_LOAD_BP_REG:
+				data += 4;
+				break;
+
+			case GX_CMD_CALL_DL:
+				data += 8;
+				break;
+
+			default:
+				if (!(cmd & 0x80))
+					return false;
+
+				{
+					RecordedDraw draw;
+					int vtx_attr_group = cmd & GX_VAT_MASK;
+					draw.vtx_desc = cp_mem.vtxDesc;
+					draw.vtx_attr = cp_mem.vtxAttr[vtx_attr_group];
+					memcpy(draw.strides, cp_mem.arrayStrides, sizeof(draw.strides));
+					draw.count = FifoAnalyzer::ReadFifo16(data);
+					draw.data = data;
+
+					g_VtxDesc = draw.vtx_desc;
+					g_VtxAttr[0] = draw.vtx_attr;
+					draw.uid.InitFromCurrentState(0);
+
+					data += draw.count * FifoAnalyzer::CalculateVertexSize(vtx_attr_group, cp_mem);
+					if (draw.count && data <= end)
+						draws->push_back(draw);
+				}
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+// Returns vertices per second, and a checksum of the converted vertices.
+double RunDraws(const std::vector<RecordedDraw> &draws, bool inline_components, u64 *checksum)
+{
+	LoaderMap loaders;
+	for (const RecordedDraw &draw : draws)
+	{
+		std::unique_ptr<VertexLoader> &loader = loaders[draw.uid];
+		if (!loader)
+			loader.reset(new VertexLoader(draw.vtx_desc, draw.vtx_attr, inline_components));
+	}
+
+	enum { NUM_PASSES = 20 };
+	u64 num_vertices = 0;
+	*checksum = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int pass = 0; pass < NUM_PASSES; ++pass)
+	{
+		for (const RecordedDraw &draw : draws)
+		{
+			memcpy(arraystrides, draw.strides, sizeof(arraystrides));
+			u32 size = Convert(loaders[draw.uid].get(), draw.vtx_attr, draw.data, draw.count);
+			num_vertices += draw.count;
+
+			if (pass == 0)
+			{
+				for (u32 i = 0; i < size; ++i)
+					*checksum = *checksum * 31 + s_output[i];
+			}
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	return num_vertices / std::chrono::duration<double>(end - start).count();
+}
+
+void Benchmark(const std::string &filename)
+{
+	std::unique_ptr<FifoDataFile> file(FifoDataFile::Load(filename, false));
+	std::vector<RecordedDraw> draws;
+	if (!file || !LoadDraws(file.get(), &draws))
+	{
+		printf("VertexLoader: can't read the vertex streams of %s\n", filename.c_str());
+		fail_count++;
+		return;
+	}
+
+	u64 call_checksum, inline_checksum;
+	double call_speed = RunDraws(draws, false, &call_checksum);
+	double inline_speed = RunDraws(draws, true, &inline_checksum);
+	EXPECT_EQ(call_checksum, inline_checksum);
+
+	printf("VertexLoader: %s, %d draws: %.2f M vertices/s with calls, %.2f M vertices/s inline\n",
+		filename.c_str(), (int)draws.size(), call_speed / 1e6, inline_speed / 1e6);
+}
+
+}  // namespace
+
+void VertexLoaderTests(const std::vector<std::string> &dff_files)
+{
+	TestVertexManager vertex_manager;
+	g_vertex_manager = &vertex_manager;
+	FifoAnalyzer::Init();
+
+	s_array_data.resize(256 * 0x10000 + 64);
+	for (u8& byte : s_array_data)
+		byte = rand();
+	for (u8*& base : cached_arraybases)
+		base = s_array_data.data();
+	s_output.resize(VertexManager::MAXVBUFFERSIZE);
+
+	RandomFormatTests();
+	for (const std::string &filename : dff_files)
+		Benchmark(filename);
+
+	g_vertex_manager = nullptr;
+}